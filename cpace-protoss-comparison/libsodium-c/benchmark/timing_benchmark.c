@@ -3,29 +3,146 @@
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include <stdint.h>
 #include <time.h>
 #include <sodium.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 #include "protoss_protocol.h"
 #include "logger.h"
 #include "crypto_cpace.h"
 
-// Helper function to generate random password
-static void generate_random_password(char *out, size_t length)
+// Handshake inputs (password, P_i, P_j) in one contiguous buffer, generated
+// or memory-mapped before any timing. Same file format as the C++ benchmark's
+// input_corpus.hpp, all integers little-endian:
+//   0: magic "PAKECRP1", 8: uint32 password length (16), 12: uint32 identity
+//   length (32), 16: uint64 record count, 24: records of password, P_i, P_j
+#define CORPUS_HEADER_BYTES 24
+#define CORPUS_PASSWORD_LEN 16
+#define CORPUS_IDENTITY_LEN 32
+#define CORPUS_RECORD_BYTES (CORPUS_PASSWORD_LEN + 2 * CORPUS_IDENTITY_LEN)
+
+typedef struct
+{
+    const unsigned char *records;
+    size_t count;
+    unsigned char *owned; // generated corpus, or NULL when mapped
+    void *mapped;
+    size_t mapped_bytes;
+#ifdef _WIN32
+    HANDLE file, mapping;
+#endif
+} InputCorpus;
+
+static uint64_t load_le(const unsigned char *p, size_t bytes)
+{
+    uint64_t v = 0;
+    for (size_t i = 0; i < bytes; i++)
+        v |= (uint64_t)p[i] << (8 * i);
+    return v;
+}
+
+// Fills `count` records from randombytes: alphanumeric passwords, uniform identities
+static int corpus_generate(InputCorpus *corpus, size_t count)
 {
     static const char charset[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
-    unsigned char random_bytes[64];
-    randombytes_buf(random_bytes, length);
-    for (size_t i = 0; i < length; i++)
+    memset(corpus, 0, sizeof *corpus);
+    corpus->owned = (unsigned char *)malloc(count * CORPUS_RECORD_BYTES);
+    if (!corpus->owned)
+        return -1;
+    randombytes_buf(corpus->owned, count * CORPUS_RECORD_BYTES);
+    for (size_t i = 0; i < count; i++)
+    {
+        unsigned char *password = corpus->owned + i * CORPUS_RECORD_BYTES;
+        for (size_t c = 0; c < CORPUS_PASSWORD_LEN; c++)
+            password[c] = (unsigned char)charset[password[c] % (sizeof(charset) - 1)];
+    }
+    corpus->records = corpus->owned;
+    corpus->count = count;
+    return 0;
+}
+
+static void corpus_free(InputCorpus *corpus)
+{
+    free(corpus->owned);
+#ifdef _WIN32
+    if (corpus->mapped)
+        UnmapViewOfFile(corpus->mapped);
+    if (corpus->mapping)
+        CloseHandle(corpus->mapping);
+    if (corpus->file && corpus->file != INVALID_HANDLE_VALUE)
+        CloseHandle(corpus->file);
+#else
+    if (corpus->mapped)
+        munmap(corpus->mapped, corpus->mapped_bytes);
+#endif
+    memset(corpus, 0, sizeof *corpus);
+}
+
+// Maps a corpus file read-only; returns -1 with a message if it cannot
+static int corpus_map(InputCorpus *corpus, const char *path)
+{
+    memset(corpus, 0, sizeof *corpus);
+#ifdef _WIN32
+    LARGE_INTEGER size;
+    corpus->file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (corpus->file == INVALID_HANDLE_VALUE || !GetFileSizeEx(corpus->file, &size))
+    {
+        fprintf(stderr, "Cannot open corpus %s\n", path);
+        corpus_free(corpus);
+        return -1;
+    }
+    corpus->mapped_bytes = (size_t)size.QuadPart;
+    if (corpus->mapped_bytes >= CORPUS_HEADER_BYTES)
+    {
+        corpus->mapping = CreateFileMappingA(corpus->file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (corpus->mapping)
+            corpus->mapped = MapViewOfFile(corpus->mapping, FILE_MAP_READ, 0, 0, 0);
+    }
+#else
+    struct stat st;
+    int fd = open(path, O_RDONLY);
+    if (fd < 0 || fstat(fd, &st) != 0)
     {
-        out[i] = charset[random_bytes[i] % (sizeof(charset) - 1)];
+        fprintf(stderr, "Cannot open corpus %s\n", path);
+        if (fd >= 0)
+            close(fd);
+        return -1;
     }
-    out[length] = '\0';
+    corpus->mapped_bytes = (size_t)st.st_size;
+    if (corpus->mapped_bytes >= CORPUS_HEADER_BYTES)
+    {
+        void *p = mmap(NULL, corpus->mapped_bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        corpus->mapped = p == MAP_FAILED ? NULL : p;
+    }
+    close(fd);
+#endif
+
+    const unsigned char *header = (const unsigned char *)corpus->mapped;
+    uint64_t count = header ? load_le(header + 16, 8) : 0;
+    if (!header || memcmp(header, "PAKECRP1", 8) != 0 || load_le(header + 8, 4) != CORPUS_PASSWORD_LEN ||
+        load_le(header + 12, 4) != CORPUS_IDENTITY_LEN || count == 0 ||
+        count > (corpus->mapped_bytes - CORPUS_HEADER_BYTES) / CORPUS_RECORD_BYTES)
+    {
+        fprintf(stderr, "Corpus %s is truncated or has an unsupported header\n", path);
+        corpus_free(corpus);
+        return -1;
+    }
+    corpus->records = header + CORPUS_HEADER_BYTES;
+    corpus->count = (size_t)count;
+    return 0;
 }
 
-// Helper function to generate random bytes
-static void generate_random_bytes(unsigned char *out, size_t length)
+// Record i, wrapping around when a run needs more handshakes than the corpus holds
+static const unsigned char *corpus_record(const InputCorpus *corpus, size_t i)
 {
-    randombytes_buf(out, length);
+    return corpus->records + (i % corpus->count) * CORPUS_RECORD_BYTES;
 }
 
 static double timespec_diff_ns(struct timespec *start, struct timespec *end)
@@ -58,36 +175,34 @@ static double calc_stddev(double *values, int count)
     return sqrt(sum_sq / (count - 1));
 }
 
-void warmup_protoss(size_t warmup_iterations)
+void warmup_protoss(size_t warmup_iterations, const InputCorpus *corpus)
 {
     logger_log(LOG_BENCHMARK, "Warming up Protoss PAKE");
 
     for (size_t i = 0; i < warmup_iterations; i++)
     {
-        char password[17];
-        generate_random_password(password, 16);
-        unsigned char P_i[32], P_j[32];
-        generate_random_bytes(P_i, 32);
-        generate_random_bytes(P_j, 32);
+        const unsigned char *record = corpus_record(corpus, i);
+        const char *password = (const char *)record;
+        const unsigned char *P_i = record + CORPUS_PASSWORD_LEN;
+        const unsigned char *P_j = P_i + CORPUS_IDENTITY_LEN;
 
         ReturnTypeInit res_init;
         ReturnTypeRspDer res_rspder;
         unsigned char K_der[PROTOSS_SESSION_KEY_LEN];
 
-        Init(&res_init, password, strlen(password), P_i, 32, P_j, 32);
-        RspDer(&res_rspder, password, strlen(password), P_i, 32, P_j, 32, res_init.I);
+        Init(&res_init, password, CORPUS_PASSWORD_LEN, P_i, CORPUS_IDENTITY_LEN, P_j, CORPUS_IDENTITY_LEN);
+        RspDer(&res_rspder, password, CORPUS_PASSWORD_LEN, P_i, CORPUS_IDENTITY_LEN, P_j, CORPUS_IDENTITY_LEN, res_init.I);
         Der(K_der, &res_init.state, res_rspder.R);
     }
 }
 
-void warmup_cpace(size_t warmup_iterations)
+void warmup_cpace(size_t warmup_iterations, const InputCorpus *corpus)
 {
     logger_log(LOG_BENCHMARK, "Warming up CPACE");
 
     for (size_t i = 0; i < warmup_iterations; i++)
     {
-        char password[17];
-        generate_random_password(password, 16);
+        const char *password = (const char *)corpus_record(corpus, i);
         const char *id_a = "client";
         const char *id_b = "server";
 
@@ -96,18 +211,18 @@ void warmup_cpace(size_t warmup_iterations)
         unsigned char response[crypto_cpace_RESPONSEBYTES];
         crypto_cpace_shared_keys shared_keys;
 
-        crypto_cpace_step1(&ctx, public_data, password, strlen(password),
+        crypto_cpace_step1(&ctx, public_data, password, CORPUS_PASSWORD_LEN,
                            id_a, strlen(id_a), id_b, strlen(id_b),
                            NULL, 0);
         crypto_cpace_step2(response, public_data, &shared_keys, password,
-                           strlen(password), id_a, strlen(id_a),
+                           CORPUS_PASSWORD_LEN, id_a, strlen(id_a),
                            id_b, strlen(id_b), NULL, 0);
         crypto_cpace_step3(&ctx, &shared_keys, response);
     }
 }
 
 // Returns per-run averages in microseconds via out parameters
-void benchmark_protoss(size_t iterations, size_t run_id,
+void benchmark_protoss(size_t iterations, size_t run_id, const InputCorpus *corpus,
                        double *out_init, double *out_rspder, double *out_der)
 {
     char log_msg[256];
@@ -121,11 +236,10 @@ void benchmark_protoss(size_t iterations, size_t run_id,
 
     for (size_t i = 0; i < iterations; i++)
     {
-        char password[17];
-        generate_random_password(password, 16);
-        unsigned char P_i[32], P_j[32];
-        generate_random_bytes(P_i, 32);
-        generate_random_bytes(P_j, 32);
+        const unsigned char *record = corpus_record(corpus, i);
+        const char *password = (const char *)record;
+        const unsigned char *P_i = record + CORPUS_PASSWORD_LEN;
+        const unsigned char *P_j = P_i + CORPUS_IDENTITY_LEN;
 
         ReturnTypeInit res_init;
         ReturnTypeRspDer res_rspder;
@@ -134,13 +248,13 @@ void benchmark_protoss(size_t iterations, size_t run_id,
 
         // Measure Init
         clock_gettime(CLOCK_MONOTONIC, &start);
-        Init(&res_init, password, strlen(password), P_i, 32, P_j, 32);
+        Init(&res_init, password, CORPUS_PASSWORD_LEN, P_i, CORPUS_IDENTITY_LEN, P_j, CORPUS_IDENTITY_LEN);
         clock_gettime(CLOCK_MONOTONIC, &end);
         total_init_ns += timespec_diff_ns(&start, &end);
 
         // Measure RspDer
         clock_gettime(CLOCK_MONOTONIC, &start);
-        RspDer(&res_rspder, password, strlen(password), P_i, 32, P_j, 32, res_init.I);
+        RspDer(&res_rspder, password, CORPUS_PASSWORD_LEN, P_i, CORPUS_IDENTITY_LEN, P_j, CORPUS_IDENTITY_LEN, res_init.I);
         clock_gettime(CLOCK_MONOTONIC, &end);
         total_rspder_ns += timespec_diff_ns(&start, &end);
 
@@ -158,7 +272,7 @@ void benchmark_protoss(size_t iterations, size_t run_id,
 }
 
 // Returns per-run averages in microseconds via out parameters
-void benchmark_cpace(size_t iterations, size_t run_id,
+void benchmark_cpace(size_t iterations, size_t run_id, const InputCorpus *corpus,
                      double *out_step1, double *out_step2, double *out_step3)
 {
     char log_msg[256];
@@ -172,8 +286,7 @@ void benchmark_cpace(size_t iterations, size_t run_id,
 
     for (size_t i = 0; i < iterations; i++)
     {
-        char password[17];
-        generate_random_password(password, 16);
+        const char *password = (const char *)corpus_record(corpus, i);
         const char *id_a = "client";
         const char *id_b = "server";
 
@@ -185,7 +298,7 @@ void benchmark_cpace(size_t iterations, size_t run_id,
 
         // Measure Step 1
         clock_gettime(CLOCK_MONOTONIC, &start);
-        crypto_cpace_step1(&ctx, public_data, password, strlen(password),
+        crypto_cpace_step1(&ctx, public_data, password, CORPUS_PASSWORD_LEN,
                            id_a, strlen(id_a), id_b, strlen(id_b),
                            NULL, 0);
         clock_gettime(CLOCK_MONOTONIC, &end);
@@ -194,7 +307,7 @@ void benchmark_cpace(size_t iterations, size_t run_id,
         // Measure Step 2
         clock_gettime(CLOCK_MONOTONIC, &start);
         crypto_cpace_step2(response, public_data, &shared_keys, password,
-                           strlen(password), id_a, strlen(id_a),
+                           CORPUS_PASSWORD_LEN, id_a, strlen(id_a),
                            id_b, strlen(id_b), NULL, 0);
         clock_gettime(CLOCK_MONOTONIC, &end);
         total_step2_ns += timespec_diff_ns(&start, &end);
@@ -217,14 +330,25 @@ int main(int argc, char *argv[])
     size_t warmup_iterations = 5000;
     size_t benchmark_iterations = 50000;
     size_t num_runs = 10;
+    const char *corpus_path = NULL;
 
-    // Parse optional CLI arguments: [iterations] [num_runs] [warmup_iterations]
-    if (argc >= 2)
-        benchmark_iterations = atoi(argv[1]);
-    if (argc >= 3)
-        num_runs = atoi(argv[2]);
-    if (argc >= 4)
-        warmup_iterations = atoi(argv[3]);
+    // Parse optional CLI arguments: [iterations] [num_runs] [warmup_iterations] [--corpus FILE]
+    int positional = 0;
+    for (int a = 1; a < argc; a++)
+    {
+        if (strcmp(argv[a], "--corpus") == 0 && a + 1 < argc)
+            corpus_path = argv[++a];
+        else
+        {
+            if (positional == 0)
+                benchmark_iterations = atoi(argv[a]);
+            else if (positional == 1)
+                num_runs = atoi(argv[a]);
+            else if (positional == 2)
+                warmup_iterations = atoi(argv[a]);
+            positional++;
+        }
+    }
 
     logger_log(LOG_BENCHMARK, "Starting PAKE Protocol Comparison Benchmark");
     printf("Starting PAKE Protocol Benchmarking\n");
@@ -236,10 +360,30 @@ int main(int argc, char *argv[])
         return 1;
     }
 
+    // All inputs exist before the first timed handshake: every run, and both
+    // protocols, read the same records from one buffer
+    InputCorpus corpus;
+    if (corpus_path)
+    {
+        if (corpus_map(&corpus, corpus_path) != 0)
+            return 1;
+    }
+    else
+    {
+        size_t records = benchmark_iterations > warmup_iterations ? benchmark_iterations : warmup_iterations;
+        if (corpus_generate(&corpus, records ? records : 1) != 0)
+        {
+            fprintf(stderr, "Failed to allocate the input corpus\n");
+            return 1;
+        }
+    }
+    printf("Input corpus: %zu records, %s%s\n", corpus.count, corpus_path ? "mapped from " : "generated",
+           corpus_path ? corpus_path : "");
+
     // Warm-up runs
     printf("Performing warm-up runs (%zu iterations)...\n", warmup_iterations);
-    warmup_protoss(warmup_iterations);
-    warmup_cpace(warmup_iterations);
+    warmup_protoss(warmup_iterations, &corpus);
+    warmup_cpace(warmup_iterations, &corpus);
 
     // Run the benchmark multiple times to average out external variability
     printf("\nStarting main benchmark runs (%zu runs x %zu iterations)...\n", num_runs, benchmark_iterations);
@@ -264,13 +408,13 @@ int main(int argc, char *argv[])
         // Alternate order to avoid ordering bias
         if ((r + 1) % 2 == 1)
         {
-            benchmark_protoss(benchmark_iterations, r + 1, &avg_init, &avg_rspder, &avg_der);
-            benchmark_cpace(benchmark_iterations, r + 1, &avg_step1, &avg_step2, &avg_step3);
+            benchmark_protoss(benchmark_iterations, r + 1, &corpus, &avg_init, &avg_rspder, &avg_der);
+            benchmark_cpace(benchmark_iterations, r + 1, &corpus, &avg_step1, &avg_step2, &avg_step3);
         }
         else
         {
-            benchmark_cpace(benchmark_iterations, r + 1, &avg_step1, &avg_step2, &avg_step3);
-            benchmark_protoss(benchmark_iterations, r + 1, &avg_init, &avg_rspder, &avg_der);
+            benchmark_cpace(benchmark_iterations, r + 1, &corpus, &avg_step1, &avg_step2, &avg_step3);
+            benchmark_protoss(benchmark_iterations, r + 1, &corpus, &avg_init, &avg_rspder, &avg_der);
         }
 
         protoss_init_runs[r] = avg_init;
@@ -308,6 +452,8 @@ int main(int argc, char *argv[])
 
     free(protoss_init_runs); free(protoss_rspder_runs); free(protoss_der_runs); free(protoss_total_runs);
     free(cpace_step1_runs); free(cpace_step2_runs); free(cpace_step3_runs); free(cpace_total_runs);
+    size_t corpus_records = corpus.count;
+    corpus_free(&corpus);
 
     // Format and log Protoss results
     char protoss_results[1024];
@@ -356,10 +502,12 @@ int main(int argc, char *argv[])
              "=========================================\n"
              "Warm-up iterations: %zu\n"
              "Benchmark iterations: %zu\n"
-             "Number of runs: %zu\n\n"
+             "Number of runs: %zu\n"
+             "Input corpus: %zu records, %s%s\n\n"
              "%s\n\n"
              "%s\n",
              warmup_iterations, benchmark_iterations, num_runs,
+             corpus_records, corpus_path ? "mapped from " : "generated", corpus_path ? corpus_path : "",
              protoss_results, cpace_results);
 
     logger_log_to_file(filename, final_results);
@@ -367,6 +515,9 @@ int main(int argc, char *argv[])
 
     printf("\nBenchmark results saved to benchmark_results/sodium/%s\n", filename);
     logger_flush();
+#ifdef _WIN32
+    // Keep the console window open when started by double-clicking the executable
     system("pause");
+#endif
     return 0;
 }
@@ -0,0 +1,223 @@
+#ifndef INPUT_CORPUS_HPP
+#define INPUT_CORPUS_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Handshake inputs (password, P_i, P_j) for the comparison benchmarks, all
+// generated or loaded into one contiguous buffer before any timing, so the
+// timed loops only read fixed-size records.
+//
+// A corpus can be saved to and memory-mapped from a file, so that the C++,
+// C and Python benchmarks run on identical inputs. The file format, all
+// integers little-endian:
+//
+//   offset  size  field
+//        0     8  magic "PAKECRP1"
+//        8     4  password length in bytes (16)
+//       12     4  identity length in bytes (32)
+//       16     8  record count
+//       24        records: password (ASCII, not terminated), P_i, P_j
+class InputCorpus
+{
+public:
+    static constexpr char MAGIC[8] = {'P', 'A', 'K', 'E', 'C', 'R', 'P', '1'};
+    static constexpr size_t HEADER_BYTES = 24;
+    static constexpr size_t PASSWORD_LEN = 16;
+    static constexpr size_t IDENTITY_LEN = 32;
+    static constexpr size_t RECORD_BYTES = PASSWORD_LEN + 2 * IDENTITY_LEN;
+
+    // `count` records drawn from `gen`: passwords from the alphanumeric
+    // charset, identities uniform bytes
+    static InputCorpus generate(size_t count, std::mt19937 &gen)
+    {
+        static const char charset[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+        std::uniform_int_distribution<> char_dis(0, sizeof(charset) - 2);
+        std::uniform_int_distribution<> byte_dis(0, 255);
+
+        InputCorpus corpus;
+        corpus.owned_.resize(HEADER_BYTES + count * RECORD_BYTES);
+        write_header(corpus.owned_.data(), count);
+        unsigned char *record = corpus.owned_.data() + HEADER_BYTES;
+        for (size_t i = 0; i < count; i++, record += RECORD_BYTES)
+        {
+            for (size_t c = 0; c < PASSWORD_LEN; c++)
+                record[c] = (unsigned char)charset[char_dis(gen)];
+            for (size_t b = PASSWORD_LEN; b < RECORD_BYTES; b++)
+                record[b] = (unsigned char)byte_dis(gen);
+        }
+        corpus.records_ = corpus.owned_.data() + HEADER_BYTES;
+        corpus.count_ = count;
+        return corpus;
+    }
+
+    // Maps a corpus file read-only; throws std::runtime_error if it cannot be
+    // mapped or is not a corpus with the lengths above
+    static InputCorpus map_file(const std::string &path)
+    {
+        InputCorpus corpus;
+#ifdef _WIN32
+        corpus.file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                   FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (corpus.file_ == INVALID_HANDLE_VALUE)
+            throw std::runtime_error("cannot open corpus " + path);
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(corpus.file_, &size))
+            throw std::runtime_error("cannot stat corpus " + path);
+        corpus.mapped_bytes_ = (size_t)size.QuadPart;
+        if (corpus.mapped_bytes_ < HEADER_BYTES)
+            throw std::runtime_error("corpus " + path + " is truncated");
+        corpus.mapping_ = CreateFileMappingA(corpus.file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!corpus.mapping_)
+            throw std::runtime_error("cannot map corpus " + path);
+        corpus.mapped_ = static_cast<const unsigned char *>(MapViewOfFile(corpus.mapping_, FILE_MAP_READ, 0, 0, 0));
+        if (!corpus.mapped_)
+            throw std::runtime_error("cannot map corpus " + path);
+#else
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw std::runtime_error("cannot open corpus " + path);
+        struct stat st;
+        if (fstat(fd, &st) != 0 || (size_t)st.st_size < HEADER_BYTES)
+        {
+            close(fd);
+            throw std::runtime_error("corpus " + path + " is truncated");
+        }
+        corpus.mapped_bytes_ = (size_t)st.st_size;
+        void *p = mmap(nullptr, corpus.mapped_bytes_, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (p == MAP_FAILED)
+            throw std::runtime_error("cannot map corpus " + path);
+        corpus.mapped_ = static_cast<const unsigned char *>(p);
+        // The benchmark walks the records in order
+        madvise(p, corpus.mapped_bytes_, MADV_SEQUENTIAL);
+#endif
+
+        const unsigned char *header = corpus.mapped_;
+        uint64_t count = load_le(header + 16, 8);
+        if (std::memcmp(header, MAGIC, sizeof MAGIC) != 0 || load_le(header + 8, 4) != PASSWORD_LEN ||
+            load_le(header + 12, 4) != IDENTITY_LEN)
+            throw std::runtime_error("corpus " + path + " has an unsupported header");
+        if (count == 0 || count > (corpus.mapped_bytes_ - HEADER_BYTES) / RECORD_BYTES)
+            throw std::runtime_error("corpus " + path + " is truncated");
+        corpus.records_ = header + HEADER_BYTES;
+        corpus.count_ = (size_t)count;
+        return corpus;
+    }
+
+    // Saves the corpus in the file format above
+    void write_file(const std::string &path) const
+    {
+        unsigned char header[HEADER_BYTES];
+        write_header(header, count_);
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char *>(header), sizeof header);
+        file.write(reinterpret_cast<const char *>(records_), (std::streamsize)(count_ * RECORD_BYTES));
+        if (!file)
+            throw std::runtime_error("cannot write corpus " + path);
+    }
+
+    size_t size() const { return count_; }
+    bool is_mapped() const { return mapped_ != nullptr; }
+
+    // Record i, for any i: the corpus wraps around when a run needs more
+    // handshakes than it holds
+    std::string_view password(size_t i) const
+    {
+        return {reinterpret_cast<const char *>(record(i)), PASSWORD_LEN};
+    }
+    const unsigned char *P_i(size_t i) const { return record(i) + PASSWORD_LEN; }
+    const unsigned char *P_j(size_t i) const { return record(i) + PASSWORD_LEN + IDENTITY_LEN; }
+
+    InputCorpus(InputCorpus &&other) noexcept { *this = std::move(other); }
+    InputCorpus &operator=(InputCorpus &&other) noexcept
+    {
+        if (this != &other)
+        {
+            unmap();
+            owned_ = std::move(other.owned_);
+            records_ = std::exchange(other.records_, nullptr);
+            count_ = std::exchange(other.count_, 0);
+            mapped_ = std::exchange(other.mapped_, nullptr);
+            mapped_bytes_ = std::exchange(other.mapped_bytes_, 0);
+#ifdef _WIN32
+            file_ = std::exchange(other.file_, INVALID_HANDLE_VALUE);
+            mapping_ = std::exchange(other.mapping_, nullptr);
+#endif
+        }
+        return *this;
+    }
+    InputCorpus(const InputCorpus &) = delete;
+    InputCorpus &operator=(const InputCorpus &) = delete;
+    ~InputCorpus() { unmap(); }
+
+private:
+    InputCorpus() = default;
+
+    const unsigned char *record(size_t i) const { return records_ + (i % count_) * RECORD_BYTES; }
+
+    static uint64_t load_le(const unsigned char *p, size_t bytes)
+    {
+        uint64_t v = 0;
+        for (size_t i = 0; i < bytes; i++)
+            v |= (uint64_t)p[i] << (8 * i);
+        return v;
+    }
+
+    static void write_header(unsigned char *header, uint64_t count)
+    {
+        std::memcpy(header, MAGIC, sizeof MAGIC);
+        const uint64_t fields[3] = {PASSWORD_LEN, IDENTITY_LEN, count};
+        const size_t widths[3] = {4, 4, 8};
+        for (size_t f = 0, offset = 8; f < 3; offset += widths[f], f++)
+            for (size_t i = 0; i < widths[f]; i++)
+                header[offset + i] = (unsigned char)(fields[f] >> (8 * i));
+    }
+
+    void unmap() noexcept
+    {
+#ifdef _WIN32
+        if (mapped_)
+            UnmapViewOfFile(mapped_);
+        if (mapping_)
+            CloseHandle(mapping_);
+        if (file_ != INVALID_HANDLE_VALUE)
+            CloseHandle(file_);
+        mapping_ = nullptr;
+        file_ = INVALID_HANDLE_VALUE;
+#else
+        if (mapped_)
+            munmap(const_cast<unsigned char *>(mapped_), mapped_bytes_);
+#endif
+        mapped_ = nullptr;
+    }
+
+    std::vector<unsigned char> owned_; // Header and records of a generated corpus
+    const unsigned char *records_ = nullptr;
+    size_t count_ = 0;
+    const unsigned char *mapped_ = nullptr;
+    size_t mapped_bytes_ = 0;
+#ifdef _WIN32
+    HANDLE file_ = INVALID_HANDLE_VALUE;
+    HANDLE mapping_ = nullptr;
+#endif
+};
+
+#endif // INPUT_CORPUS_HPP
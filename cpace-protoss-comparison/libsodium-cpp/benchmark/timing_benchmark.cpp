@@ -1,18 +1,24 @@
+#include <sodium.h>
 #include <iostream>
 #include <chrono>
 #include <vector>
 #include <string>
 #include <cstring>
 #include <cmath>
+#include <cstdint>
 #include <cstdlib>
 #include <random>
 #include <iomanip>
+#include <optional>
 #include <sstream>
 #include "protoss_protocol.hpp"
+#include "latency_histogram.hpp"
+#include "benchmark_report.hpp"
+#include "input_corpus.hpp"
 #include "logger.hpp"
 extern "C"
 {
-#include "crypto_cpace.h "
+#include "crypto_cpace.h"
 }
 
 static double calc_mean(const std::vector<double> &values)
@@ -37,48 +43,114 @@ static double calc_stddev(const std::vector<double> &values)
     return std::sqrt(sum_sq / (values.size() - 1));
 }
 
-// Helper function to generate random password
-std::string generate_random_password(size_t length)
+// Per-handshake latency distribution of each step, accumulated over all runs
+struct StepHistograms
 {
-    static const char charset[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    static std::uniform_int_distribution<> dis(0, sizeof(charset) - 2);
+    LatencyHistogram step1, step2, step3, total;
+};
 
-    std::string password;
-    password.reserve(length);
-    for (size_t i = 0; i < length; ++i)
+// Appends one "p50 p90 p99 p99.9 max" row in microseconds
+static void write_percentile_row(std::stringstream &ss, const std::string &name, const LatencyHistogram &hist)
+{
+    ss << std::left << std::setw(8) << name << std::right;
+    for (double p : {50.0, 90.0, 99.0, 99.9})
+        ss << std::setw(11) << hist.value_at_percentile(p) / 1000.0;
+    ss << std::setw(11) << hist.max() / 1000.0 << "\n";
+}
+
+// Appends the percentile table for one protocol
+static void write_percentile_table(std::stringstream &ss, const std::string &protocol, const char *const names[3],
+                                   const StepHistograms &hist)
+{
+    ss << protocol << " latency percentiles over " << hist.total.count() << " runs (us):\n";
+    ss << "Step            p50        p90        p99      p99.9        max\n";
+    write_percentile_row(ss, names[0], hist.step1);
+    write_percentile_row(ss, names[1], hist.step2);
+    write_percentile_row(ss, names[2], hist.step3);
+    write_percentile_row(ss, "Total", hist.total);
+}
+
+// Source of the generated corpus; reseeded by --seed
+static std::mt19937 &input_generator()
+{
+    static std::mt19937 gen(std::random_device{}());
+    return gen;
+}
+
+// Deterministic randombytes for --seed runs, so the scalars of both protocols
+// are fixed by the seed as well: ChaCha20 under a key derived from the seed,
+// with a call counter as the nonce. Benchmark only and single-threaded; it is
+// never installed without --seed.
+namespace seeded_randombytes
+{
+    static unsigned char key[crypto_stream_chacha20_ietf_KEYBYTES];
+    static uint64_t calls = 0;
+
+    static const char *name() { return "pake_compare_seeded"; }
+    static void stir() {}
+    static int close() { return 0; }
+
+    static void buf(void *const out, const size_t size)
     {
-        password += charset[dis(gen)];
+        unsigned char nonce[crypto_stream_chacha20_ietf_NONCEBYTES] = {};
+        for (int i = 0; i < 8; i++)
+            nonce[i] = (unsigned char)(calls >> (8 * i));
+        calls++;
+        crypto_stream_chacha20_ietf(static_cast<unsigned char *>(out), size, nonce, key);
+    }
+
+    static uint32_t random()
+    {
+        uint32_t value;
+        buf(&value, sizeof value);
+        return value;
+    }
+
+    static randombytes_implementation implementation = {
+        .implementation_name = name,
+        .random = random,
+        .stir = stir,
+        .uniform = nullptr,
+        .buf = buf,
+        .close = close};
+
+    // Must run before sodium_init
+    static void install(uint64_t seed)
+    {
+        unsigned char seed_le[8];
+        for (int i = 0; i < 8; i++)
+            seed_le[i] = (unsigned char)(seed >> (8 * i));
+        crypto_generichash(key, sizeof key, seed_le, sizeof seed_le, nullptr, 0);
+        randombytes_set_implementation(&implementation);
     }
-    return password;
 }
 
-// Helper function to generate random bytes
-std::vector<unsigned char> generate_random_bytes(size_t length)
+// Reusable argument buffers for the vector-based Protoss API, refilled from
+// corpus records without allocating once they have their size
+struct ProtossInputs
 {
-    std::vector<unsigned char> bytes(length);
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(0, 255);
+    std::string password;
+    std::vector<unsigned char> P_i, P_j;
 
-    for (size_t i = 0; i < length; ++i)
+    void load(const InputCorpus &corpus, size_t i)
     {
-        bytes[i] = static_cast<unsigned char>(dis(gen));
+        std::string_view pw = corpus.password(i);
+        password.assign(pw.data(), pw.size());
+        P_i.assign(corpus.P_i(i), corpus.P_i(i) + InputCorpus::IDENTITY_LEN);
+        P_j.assign(corpus.P_j(i), corpus.P_j(i) + InputCorpus::IDENTITY_LEN);
     }
-    return bytes;
-}
+};
 
-void warmup_protoss(size_t warmup_iterations)
+void warmup_protoss(size_t warmup_iterations, const InputCorpus &corpus)
 {
     Logger &logger = Logger::get_instance();
     logger.log(LoggingKeyword::BENCHMARK, "Warming up Protoss PAKE with " + std::to_string(warmup_iterations) + " iterations");
 
+    ProtossInputs in;
     for (size_t i = 0; i < warmup_iterations; ++i)
     {
-        std::string password = generate_random_password(16);
-        auto P_i = generate_random_bytes(32);
-        auto P_j = generate_random_bytes(32);
+        in.load(corpus, i);
+        auto &[password, P_i, P_j] = in;
 
         auto [I, state] = Init(password, P_i, P_j);
         auto rspder_result = RspDer(password, P_i, P_j, I);
@@ -86,35 +158,35 @@ void warmup_protoss(size_t warmup_iterations)
     }
 }
 
-void warmup_cpace(size_t warmup_iterations)
+void warmup_cpace(size_t warmup_iterations, const InputCorpus &corpus)
 {
     Logger &logger = Logger::get_instance();
     logger.log(LoggingKeyword::BENCHMARK, "Warming up CPACE with " + std::to_string(warmup_iterations) + " iterations");
 
+    const std::string id_a = "client";
+    const std::string id_b = "server";
     for (size_t i = 0; i < warmup_iterations; ++i)
     {
-        std::string password = generate_random_password(16);
-        std::string id_a = "client";
-        std::string id_b = "server";
+        std::string_view password = corpus.password(i);
 
         crypto_cpace_state ctx;
         unsigned char public_data[crypto_cpace_PUBLICDATABYTES];
         unsigned char response[crypto_cpace_RESPONSEBYTES];
         crypto_cpace_shared_keys shared_keys;
 
-        crypto_cpace_step1(&ctx, public_data, password.c_str(), password.length(),
+        crypto_cpace_step1(&ctx, public_data, password.data(), password.size(),
                            id_a.c_str(), id_a.length(), id_b.c_str(), id_b.length(),
                            nullptr, 0);
-        crypto_cpace_step2(response, public_data, &shared_keys, password.c_str(),
+        crypto_cpace_step2(response, public_data, &shared_keys, password.data(),
                            password.length(), id_a.c_str(), id_a.length(),
                            id_b.c_str(), id_b.length(), nullptr, 0);
         crypto_cpace_step3(&ctx, &shared_keys, response);
     }
 }
 
-// Returns per-run averages in microseconds via out parameters
-void benchmark_protoss(size_t iterations, size_t run_id,
-                       double &out_init, double &out_rspder, double &out_der)
+// Returns per-run averages in microseconds via out parameters and records every protocol run into hist
+void benchmark_protoss(size_t iterations, size_t run_id, const InputCorpus &corpus,
+                       double &out_init, double &out_rspder, double &out_der, StepHistograms &hist)
 {
     Logger &logger = Logger::get_instance();
     logger.log(LoggingKeyword::BENCHMARK, "Run " + std::to_string(run_id) + ": Starting Protoss PAKE benchmark with " + std::to_string(iterations) + " iterations");
@@ -123,30 +195,38 @@ void benchmark_protoss(size_t iterations, size_t run_id,
     auto total_rspder_time = std::chrono::nanoseconds(0);
     auto total_der_time = std::chrono::nanoseconds(0);
 
+    ProtossInputs in;
     for (size_t i = 0; i < iterations; ++i)
     {
-        std::string password = generate_random_password(16);
-        auto P_i = generate_random_bytes(32);
-        auto P_j = generate_random_bytes(32);
+        in.load(corpus, i);
+        auto &[password, P_i, P_j] = in;
 
         // Measure Init
         auto start = std::chrono::high_resolution_clock::now();
         auto [I, state] = Init(password, P_i, P_j);
         auto end = std::chrono::high_resolution_clock::now();
-        total_init_time += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+        auto init_elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+        total_init_time += init_elapsed;
 
         // Measure RspDer
         start = std::chrono::high_resolution_clock::now();
         auto rspder_result = RspDer(password, P_i, P_j, I);
         auto K_rspder = rspder_result.getSessionKey();
         end = std::chrono::high_resolution_clock::now();
-        total_rspder_time += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+        auto rspder_elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+        total_rspder_time += rspder_elapsed;
 
         // Measure Der
         start = std::chrono::high_resolution_clock::now();
         auto K_der = Der(password, state, rspder_result.R);
         end = std::chrono::high_resolution_clock::now();
-        total_der_time += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+        auto der_elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+        total_der_time += der_elapsed;
+
+        hist.step1.record(init_elapsed);
+        hist.step2.record(rspder_elapsed);
+        hist.step3.record(der_elapsed);
+        hist.total.record(init_elapsed + rspder_elapsed + der_elapsed);
     }
 
     // Calculate averages in microseconds
@@ -155,9 +235,9 @@ void benchmark_protoss(size_t iterations, size_t run_id,
     out_der = (total_der_time.count() / iterations) / 1000.0;
 }
 
-// Returns per-run averages in microseconds via out parameters
-void benchmark_cpace(size_t iterations, size_t run_id,
-                     double &out_step1, double &out_step2, double &out_step3)
+// Returns per-run averages in microseconds via out parameters and records every protocol run into hist
+void benchmark_cpace(size_t iterations, size_t run_id, const InputCorpus &corpus,
+                     double &out_step1, double &out_step2, double &out_step3, StepHistograms &hist)
 {
     Logger &logger = Logger::get_instance();
     logger.log(LoggingKeyword::BENCHMARK, "Run " + std::to_string(run_id) + ": Starting CPACE benchmark with " + std::to_string(iterations) + " iterations");
@@ -166,11 +246,11 @@ void benchmark_cpace(size_t iterations, size_t run_id,
     auto total_step2_time = std::chrono::nanoseconds(0);
     auto total_step3_time = std::chrono::nanoseconds(0);
 
+    const std::string id_a = "client";
+    const std::string id_b = "server";
     for (size_t i = 0; i < iterations; ++i)
     {
-        std::string password = generate_random_password(16);
-        std::string id_a = "client";
-        std::string id_b = "server";
+        std::string_view password = corpus.password(i);
 
         crypto_cpace_state ctx;
         unsigned char public_data[crypto_cpace_PUBLICDATABYTES];
@@ -179,25 +259,33 @@ void benchmark_cpace(size_t iterations, size_t run_id,
 
         // Measure Step 1
         auto start = std::chrono::high_resolution_clock::now();
-        crypto_cpace_step1(&ctx, public_data, password.c_str(), password.length(),
+        crypto_cpace_step1(&ctx, public_data, password.data(), password.size(),
                            id_a.c_str(), id_a.length(), id_b.c_str(), id_b.length(),
                            nullptr, 0);
         auto end = std::chrono::high_resolution_clock::now();
-        total_step1_time += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+        auto step1_elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+        total_step1_time += step1_elapsed;
 
         // Measure Step 2
         start = std::chrono::high_resolution_clock::now();
-        crypto_cpace_step2(response, public_data, &shared_keys, password.c_str(),
+        crypto_cpace_step2(response, public_data, &shared_keys, password.data(),
                            password.length(), id_a.c_str(), id_a.length(),
                            id_b.c_str(), id_b.length(), nullptr, 0);
         end = std::chrono::high_resolution_clock::now();
-        total_step2_time += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+        auto step2_elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+        total_step2_time += step2_elapsed;
 
         // Measure Step 3
         start = std::chrono::high_resolution_clock::now();
         crypto_cpace_step3(&ctx, &shared_keys, response);
         end = std::chrono::high_resolution_clock::now();
-        total_step3_time += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+        auto step3_elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+        total_step3_time += step3_elapsed;
+
+        hist.step1.record(step1_elapsed);
+        hist.step2.record(step2_elapsed);
+        hist.step3.record(step3_elapsed);
+        hist.total.record(step1_elapsed + step2_elapsed + step3_elapsed);
     }
 
     // Calculate averages in microseconds
@@ -213,28 +301,102 @@ int main(int argc, char *argv[])
     size_t num_runs = 10;
     Logger &logger = Logger::get_instance();
 
-    // Parse optional CLI arguments: [iterations] [num_runs] [warmup_iterations]
-    if (argc >= 2)
-        benchmark_iterations = std::atoi(argv[1]);
-    if (argc >= 3)
-        num_runs = std::atoi(argv[2]);
-    if (argc >= 4)
-        warmup_iterations = std::atoi(argv[3]);
+    bool write_json = false;
+    bool write_csv = false;
+    bool seeded = false;
+    uint64_t seed = 0;
+    std::string corpus_path;
+    std::string write_corpus_path;
+
+    // Parse optional CLI arguments: [iterations] [num_runs] [warmup_iterations] [--json] [--csv] [--seed N]
+    // [--corpus FILE | --write-corpus FILE]
+    std::vector<std::string> positional;
+    for (int a = 1; a < argc; a++)
+    {
+        std::string arg = argv[a];
+        if (arg == "--json")
+            write_json = true;
+        else if (arg == "--csv")
+            write_csv = true;
+        else if (arg == "--seed" && a + 1 < argc)
+        {
+            seeded = true;
+            seed = std::strtoull(argv[++a], nullptr, 10);
+        }
+        else if (arg == "--corpus" && a + 1 < argc)
+            corpus_path = argv[++a];
+        else if (arg == "--write-corpus" && a + 1 < argc)
+            write_corpus_path = argv[++a];
+        else
+            positional.push_back(arg);
+    }
+    if (!corpus_path.empty() && !write_corpus_path.empty())
+    {
+        std::cerr << "--corpus and --write-corpus cannot be combined: only a generated corpus is saved" << std::endl;
+        return 1;
+    }
+    if (positional.size() >= 1)
+        benchmark_iterations = std::atoi(positional[0].c_str());
+    if (positional.size() >= 2)
+        num_runs = std::atoi(positional[1].c_str());
+    if (positional.size() >= 3)
+        warmup_iterations = std::atoi(positional[2].c_str());
+
+    // With --seed, every password, identity and scalar is a fixed function of
+    // the seed, so two builds run exactly the same handshakes
+    if (seeded)
+    {
+        input_generator().seed((std::mt19937::result_type)seed);
+        seeded_randombytes::install(seed);
+    }
+    if (sodium_init() < 0)
+    {
+        std::cerr << "Failed to initialize libsodium" << std::endl;
+        return 1;
+    }
 
     logger.log(LoggingKeyword::BENCHMARK, "Starting PAKE Protocol Comparison Benchmark");
     std::cout << "Starting PAKE Protocol Benchmarking\n";
     std::cout << "==================================\n";
 
+    // All inputs exist before the first timed handshake: every run, and both
+    // protocols, read the same records from one buffer
+    std::optional<InputCorpus> corpus;
+    try
+    {
+        if (!corpus_path.empty())
+            corpus = InputCorpus::map_file(corpus_path);
+        else
+        {
+            corpus = InputCorpus::generate(std::max<size_t>(1, std::max(benchmark_iterations, warmup_iterations)),
+                                           input_generator());
+            if (!write_corpus_path.empty())
+                corpus->write_file(write_corpus_path);
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Exception: " << e.what() << std::endl;
+        return 1;
+    }
+    std::string corpus_source = corpus_path.empty() ? "generated" : "mapped from " + corpus_path;
+    if (!write_corpus_path.empty())
+        corpus_source += ", saved to " + write_corpus_path;
+    std::cout << "Input corpus: " << corpus->size() << " records, " << corpus_source << "\n";
+    if (corpus->size() < benchmark_iterations)
+        std::cout << "Note: the corpus holds fewer records than iterations, so each run wraps around it\n";
+
     // Warm-up runs
     std::cout << "Performing warm-up runs (" << warmup_iterations << " iterations)...\n";
-    warmup_protoss(warmup_iterations);
-    warmup_cpace(warmup_iterations);
+    warmup_protoss(warmup_iterations, *corpus);
+    warmup_cpace(warmup_iterations, *corpus);
 
     // Run the benchmark multiple times to average out external variability
     std::cout << "\nStarting main benchmark runs (" << num_runs << " runs x " << benchmark_iterations << " iterations)...\n";
 
     std::vector<double> protoss_init_runs, protoss_rspder_runs, protoss_der_runs, protoss_total_runs;
     std::vector<double> cpace_step1_runs, cpace_step2_runs, cpace_step3_runs, cpace_total_runs;
+    StepHistograms protoss_hist, cpace_hist;
 
     for (size_t r = 1; r <= num_runs; ++r)
     {
@@ -246,13 +408,13 @@ int main(int argc, char *argv[])
         // Alternate order to avoid ordering bias
         if (r % 2 == 1)
         {
-            benchmark_protoss(benchmark_iterations, r, avg_init, avg_rspder, avg_der);
-            benchmark_cpace(benchmark_iterations, r, avg_step1, avg_step2, avg_step3);
+            benchmark_protoss(benchmark_iterations, r, *corpus, avg_init, avg_rspder, avg_der, protoss_hist);
+            benchmark_cpace(benchmark_iterations, r, *corpus, avg_step1, avg_step2, avg_step3, cpace_hist);
         }
         else
         {
-            benchmark_cpace(benchmark_iterations, r, avg_step1, avg_step2, avg_step3);
-            benchmark_protoss(benchmark_iterations, r, avg_init, avg_rspder, avg_der);
+            benchmark_cpace(benchmark_iterations, r, *corpus, avg_step1, avg_step2, avg_step3, cpace_hist);
+            benchmark_protoss(benchmark_iterations, r, *corpus, avg_init, avg_rspder, avg_der, protoss_hist);
         }
 
         protoss_init_runs.push_back(avg_init);
@@ -310,24 +472,99 @@ int main(int argc, char *argv[])
 
     logger.log(LoggingKeyword::BENCHMARK, cpace_ss.str());
 
+    // Tail latencies for both protocols
+    static const char *const protoss_steps[3] = {"Init", "RspDer", "Der"};
+    static const char *const cpace_steps[3] = {"Step 1", "Step 2", "Step 3"};
+    std::stringstream percentile_ss;
+    percentile_ss << std::fixed << std::setprecision(3);
+    write_percentile_table(percentile_ss, "Protoss PAKE", protoss_steps, protoss_hist);
+    percentile_ss << "\n";
+    write_percentile_table(percentile_ss, "CPACE", cpace_steps, cpace_hist);
+
+    logger.log(LoggingKeyword::BENCHMARK, percentile_ss.str());
+
     // Save final results to file
     auto now = std::time(nullptr);
+    std::stringstream timestamp;
+    timestamp << std::put_time(std::localtime(&now), "%Y-%m-%d_%H-%M-%S");
     std::stringstream filename;
-    filename << "benchmark_results_it" << benchmark_iterations << "_" << std::put_time(std::localtime(&now), "%Y-%m-%d_%H-%M-%S") << ".txt";
+    filename << "benchmark_results_it" << benchmark_iterations << "_" << timestamp.str() << ".txt";
 
     std::stringstream final_results;
     final_results << "PAKE Protocol Comparison Benchmark Results\n";
     final_results << "=========================================\n";
     final_results << "Warm-up iterations: " << warmup_iterations << "\n";
     final_results << "Benchmark iterations: " << benchmark_iterations << "\n";
-    final_results << "Number of runs: " << num_runs << "\n\n";
+    final_results << "Number of runs: " << num_runs << "\n";
+    final_results << "Input corpus: " << corpus->size() << " records, " << corpus_source << "\n";
+    if (seeded)
+        final_results << "Seed: " << seed << " (deterministic inputs and scalars)\n";
+    final_results << "\n";
     final_results << protoss_ss.str() << "\n\n";
-    final_results << cpace_ss.str() << "\n";
+    final_results << cpace_ss.str() << "\n\n";
+    final_results << percentile_ss.str();
 
     logger.log_to_file(filename.str(), final_results.str());
+
+    // Raw histograms, one row per non-empty bucket, for offline analysis
+    std::stringstream histogram_filename;
+    histogram_filename << "benchmark_histogram_it" << benchmark_iterations << "_" << timestamp.str() << ".csv";
+    std::stringstream csv;
+    csv << LatencyHistogram::csv_header() << "\n";
+    protoss_hist.step1.write_csv(csv, "Protoss Init");
+    protoss_hist.step2.write_csv(csv, "Protoss RspDer");
+    protoss_hist.step3.write_csv(csv, "Protoss Der");
+    protoss_hist.total.write_csv(csv, "Protoss Total");
+    cpace_hist.step1.write_csv(csv, "CPACE Step 1");
+    cpace_hist.step2.write_csv(csv, "CPACE Step 2");
+    cpace_hist.step3.write_csv(csv, "CPACE Step 3");
+    cpace_hist.total.write_csv(csv, "CPACE Total");
+    logger.log_to_file(histogram_filename.str(), csv.str());
     logger.log(LoggingKeyword::BENCHMARK, "PAKE Protocol Comparison Benchmark completed");
 
     std::cout << "\nBenchmark results saved to benchmark_results/sodium/" << filename.str() << std::endl;
+    std::cout << "Latency histograms saved to benchmark_results/sodium/" << histogram_filename.str() << std::endl;
+
+    // Structured reports for regression tracking, same stem as the text report
+    if (write_json || write_csv)
+    {
+        BenchmarkReport report;
+        report.benchmark = "pake_comparison";
+        report.config = {{"iterations", (long long)benchmark_iterations},
+                         {"num_runs", (long long)num_runs},
+                         {"warmup_iterations", (long long)warmup_iterations}};
+        report.config.push_back({"corpus_records", (long long)corpus->size()});
+        report.config.push_back({"corpus_mapped", corpus->is_mapped() ? 1LL : 0LL});
+        if (seeded)
+            report.config.push_back({"seed", (long long)seed});
+        report.series = {{"Protoss", "Init", protoss_init_runs, &protoss_hist.step1},
+                         {"Protoss", "RspDer", protoss_rspder_runs, &protoss_hist.step2},
+                         {"Protoss", "Der", protoss_der_runs, &protoss_hist.step3},
+                         {"Protoss", "Total", protoss_total_runs, &protoss_hist.total},
+                         {"CPACE", "Step 1", cpace_step1_runs, &cpace_hist.step1},
+                         {"CPACE", "Step 2", cpace_step2_runs, &cpace_hist.step2},
+                         {"CPACE", "Step 3", cpace_step3_runs, &cpace_hist.step3},
+                         {"CPACE", "Total", cpace_total_runs, &cpace_hist.total}};
+        BenchmarkEnvironment env = BenchmarkEnvironment::collect();
+        std::string stem = "benchmark_results_it" + std::to_string(benchmark_iterations) + "_" + timestamp.str();
+        if (write_json)
+        {
+            std::stringstream json;
+            report.write_json(json, env);
+            logger.log_to_file(stem + ".json", json.str());
+            std::cout << "JSON report saved to benchmark_results/sodium/" << stem << ".json" << std::endl;
+        }
+        if (write_csv)
+        {
+            std::stringstream csv_report;
+            report.write_csv(csv_report, env);
+            logger.log_to_file(stem + ".csv", csv_report.str());
+            std::cout << "CSV report saved to benchmark_results/sodium/" << stem << ".csv" << std::endl;
+        }
+    }
+#ifdef _WIN32
+    // Keep the console window open when started by double-clicking the executable
     system("pause");
+#endif
     return 0;
 }
@@ -214,6 +214,9 @@ int main(int argc, char *argv[])
     printf("\nBenchmark results saved to benchmark_results/sodium/%s\n", filename);
 
     logger_flush();
+#ifdef _WIN32
+    // Keep the console window open when started by double-clicking the executable
     system("pause");
+#endif
     return 0;
 }
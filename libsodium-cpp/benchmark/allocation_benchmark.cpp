@@ -0,0 +1,197 @@
+#include <sodium.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "benchmark_args.hpp"
+#include "logger.hpp"
+#include "protoss_protocol.hpp"
+
+// Counts every heap allocation made through the global operator new: the
+// plain, nothrow and std::align_val_t overloads are all replaced (the array
+// forms forward to them). Replacing the global operators is whole-program,
+// which is why this lives in its own executable instead of being a mode of
+// timing_benchmark.cpp.
+static std::atomic<size_t> g_alloc_count{0};
+static std::atomic<size_t> g_alloc_bytes{0};
+
+static void *counted_malloc(std::size_t size) noexcept
+{
+    g_alloc_count.fetch_add(1, std::memory_order_relaxed);
+    g_alloc_bytes.fetch_add(size, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+
+// Over-aligned blocks are carved out of malloc by hand, with the malloc
+// pointer stored just below the returned address, so this builds the same
+// with MinGW (which has no std::aligned_alloc)
+static void *counted_aligned_malloc(std::size_t size, std::align_val_t al) noexcept
+{
+    std::size_t align = std::max(static_cast<std::size_t>(al), alignof(void *));
+    if (size > SIZE_MAX - align - sizeof(void *))
+        return nullptr;
+    void *raw = counted_malloc(size + align + sizeof(void *));
+    if (!raw)
+        return nullptr;
+    uintptr_t aligned = (reinterpret_cast<uintptr_t>(raw) + sizeof(void *) + align - 1) & ~(uintptr_t)(align - 1);
+    reinterpret_cast<void **>(aligned)[-1] = raw;
+    return reinterpret_cast<void *>(aligned);
+}
+
+static void aligned_free(void *p) noexcept
+{
+    if (p)
+        std::free(static_cast<void **>(p)[-1]);
+}
+
+void *operator new(std::size_t size)
+{
+    if (void *p = counted_malloc(size))
+        return p;
+    throw std::bad_alloc();
+}
+
+void *operator new(std::size_t size, std::align_val_t al)
+{
+    if (void *p = counted_aligned_malloc(size, al))
+        return p;
+    throw std::bad_alloc();
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept { return counted_malloc(size); }
+void *operator new(std::size_t size, std::align_val_t al, const std::nothrow_t &) noexcept
+{
+    return counted_aligned_malloc(size, al);
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete(void *p, const std::nothrow_t &) noexcept { std::free(p); }
+void operator delete(void *p, std::align_val_t) noexcept { aligned_free(p); }
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept { aligned_free(p); }
+void operator delete(void *p, std::align_val_t, const std::nothrow_t &) noexcept { aligned_free(p); }
+
+struct AllocStats
+{
+    double allocs_per_handshake;
+    double bytes_per_handshake;
+    double us_per_handshake;
+};
+
+// Runs full Init/RspDer/Der handshakes through the vector API
+static AllocStats run_vector_api(int iterations)
+{
+    std::string password = "SharedPassword";
+    std::vector<unsigned char> P_i = {0x00};
+    std::vector<unsigned char> P_j = {0x01};
+
+    size_t count_before = g_alloc_count.load();
+    size_t bytes_before = g_alloc_bytes.load();
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; i++)
+    {
+        ReturnTypeInit res_init = Init(password, P_i, P_j);
+        ReturnTypeRspDer res_rspDer = RspDer(password, P_i, P_j, res_init.I);
+        std::vector<unsigned char> session_key_i = Der(password, res_init.protoss_state, res_rspDer.R);
+        if (session_key_i != res_rspDer.getSessionKey())
+            throw std::runtime_error("session keys don't match");
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+
+    return {double(g_alloc_count.load() - count_before) / iterations,
+            double(g_alloc_bytes.load() - bytes_before) / iterations,
+            std::chrono::duration<double, std::micro>(end - start).count() / iterations};
+}
+
+// Runs full Init/RspDer/Der handshakes through the fixed-size API
+static AllocStats run_fixed_api(int iterations)
+{
+    constexpr std::string_view password = "SharedPassword";
+    const unsigned char P_i[] = {0x00};
+    const unsigned char P_j[] = {0x01};
+
+    size_t count_before = g_alloc_count.load();
+    size_t bytes_before = g_alloc_bytes.load();
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; i++)
+    {
+        protoss::Point I, R;
+        protoss::State state;
+        protoss::SessionKey K_i, K_j;
+        protoss::Init(I, state, password, P_i, P_j);
+        protoss::RspDer(R, K_j, password, P_i, P_j, I);
+        protoss::Der(K_i, state, R);
+        if (K_i != K_j)
+            throw std::runtime_error("session keys don't match");
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+
+    return {double(g_alloc_count.load() - count_before) / iterations,
+            double(g_alloc_bytes.load() - bytes_before) / iterations,
+            std::chrono::duration<double, std::micro>(end - start).count() / iterations};
+}
+
+int main(int argc, char *argv[])
+{
+    if (sodium_init() < 0)
+    {
+        std::cerr << "Failed to initialize libsodium" << std::endl;
+        return 1;
+    }
+
+    // Parse optional CLI argument: [iterations]
+    int iterations = 10000;
+    bool valid = argc <= 2;
+    if (argc >= 2)
+        valid = valid && parse_count(argv[1], iterations);
+    if (!valid)
+        return usage_error(argv[0], "[iterations]");
+
+    std::cout << "Protoss Allocation Benchmark" << std::endl;
+    std::cout << "============================" << std::endl;
+
+    AllocStats vector_stats, fixed_stats;
+    try
+    {
+        // Warmup both paths before counting
+        run_vector_api(100);
+        run_fixed_api(100);
+
+        vector_stats = run_vector_api(iterations);
+        fixed_stats = run_fixed_api(iterations);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(3);
+    ss << "Allocation Results with " << iterations << " handshakes (Init + RspDer + Der)\n";
+    ss << "-------------------------\n";
+    ss << "Vector API:     " << vector_stats.allocs_per_handshake << " allocs, "
+       << vector_stats.bytes_per_handshake << " bytes, "
+       << vector_stats.us_per_handshake << " us per handshake\n";
+    ss << "Fixed-size API: " << fixed_stats.allocs_per_handshake << " allocs, "
+       << fixed_stats.bytes_per_handshake << " bytes, "
+       << fixed_stats.us_per_handshake << " us per handshake\n";
+    std::cout << "\n"
+              << ss.str();
+
+    auto now = std::time(nullptr);
+    std::stringstream filename;
+    filename << "allocation_results_it" << iterations << "_" << std::put_time(std::localtime(&now), "%Y-%m-%d_%H-%M-%S") << ".txt";
+    Logger::get_instance().log_to_file(filename.str(), ss.str());
+    std::cout << "\nAllocation results saved to benchmark_results/sodium/" << filename.str() << std::endl;
+
+    return 0;
+}
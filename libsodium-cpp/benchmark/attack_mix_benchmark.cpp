@@ -0,0 +1,344 @@
+#include <sodium.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "benchmark_args.hpp"
+#include "benchmark_stats.hpp"
+#include "logger.hpp"
+#include "protoss_batch.hpp"
+#include "protoss_protocol.hpp"
+#include "transcript_hasher.hpp"
+
+// The responder as it was before peer points were checked up front: one
+// libsodium call per operation, a malformed I first noticed by
+// crypto_core_ristretto255_sub after y, Y and R are already computed
+static void late_rspder(protoss::Point &R, protoss::SessionKey &K, const protoss::Point &V, protoss::Bytes P_i,
+                        protoss::Bytes P_j, const protoss::Point &I)
+{
+    protoss::Scalar y;
+    protoss::Point Y, X_prime, Z;
+    crypto_core_ristretto255_scalar_random(y.data());
+    if (crypto_scalarmult_ristretto255_base(Y.data(), y.data()) != 0)
+        throw std::runtime_error("crypto_scalarmult_ristretto255_base failed");
+    if (crypto_core_ristretto255_add(R.data(), Y.data(), V.data()) != 0)
+        throw std::runtime_error("crypto_core_ristretto255_add failed");
+    if (crypto_core_ristretto255_sub(X_prime.data(), I.data(), V.data()) != 0)
+        throw std::runtime_error("crypto_core_ristretto255_sub failed");
+    if (crypto_scalarmult_ristretto255(Z.data(), y.data(), X_prime.data()) != 0)
+        throw std::runtime_error("crypto_scalarmult_ristretto255 failed");
+    protoss::derive_session_key(K, Z, I, R, P_i, P_j, V);
+    sodium_memzero(y.data(), y.size());
+    sodium_memzero(Z.data(), Z.size());
+}
+
+// Kinds of garbage an attacker sends as I
+enum class Garbage
+{
+    RandomBytes,  // 32 random bytes that do not decode
+    NonCanonical, // a valid encoding with its low bit set, a negative field element
+    EqualsV,      // I = V, so that I - V and Z would be the identity
+    Count
+};
+
+static const char *garbage_name(Garbage kind)
+{
+    switch (kind)
+    {
+    case Garbage::RandomBytes:
+        return "random bytes";
+    case Garbage::NonCanonical:
+        return "non-canonical";
+    default:
+        return "I equal to V";
+    }
+}
+
+static protoss::Point make_garbage(Garbage kind, const protoss::Point &valid_I, const protoss::Point &V)
+{
+    protoss::Point I;
+    switch (kind)
+    {
+    case Garbage::RandomBytes:
+        do
+            randombytes_buf(I.data(), I.size());
+        while (crypto_core_ristretto255_is_valid_point(I.data()));
+        return I;
+    case Garbage::NonCanonical:
+        I = valid_I;
+        I[0] |= 1;
+        return I;
+    default:
+        return V;
+    }
+}
+
+// A pool of incoming handshakes: honest ones from Init, and a `garbage_percent`
+// share of attack traffic cycling through the garbage kinds
+struct Traffic
+{
+    std::vector<protoss::RspDerRequest> requests;
+    std::vector<bool> honest;
+};
+
+static Traffic make_traffic(size_t count, int garbage_percent, const protoss::Point &V, protoss::Bytes P_i, protoss::Bytes P_j)
+{
+    Traffic traffic;
+    size_t garbage = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        protoss::Point I;
+        protoss::State state;
+        protoss::Init(I, state, V, P_i, P_j);
+        const bool honest = randombytes_uniform(100) >= (uint32_t)garbage_percent;
+        if (!honest)
+            I = make_garbage(Garbage(garbage++ % size_t(Garbage::Count)), I, V);
+        traffic.requests.push_back({I, V, P_i, P_j});
+        traffic.honest.push_back(honest);
+    }
+    return traffic;
+}
+
+// Requests per second through one responder path over `iterations` requests;
+// `accepted` counts the requests it completed
+template <typename Step>
+static std::vector<double> measure(const Traffic &traffic, int iterations, int num_runs, size_t &accepted, Step step)
+{
+    std::vector<double> runs;
+    for (int run = 0; run < num_runs; run++)
+    {
+        accepted = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; i++)
+            accepted += step(traffic.requests[i % traffic.requests.size()]);
+        auto end = std::chrono::steady_clock::now();
+        runs.push_back(iterations / std::chrono::duration<double>(end - start).count());
+    }
+    return runs;
+}
+
+int main(int argc, char *argv[])
+{
+    if (sodium_init() < 0)
+    {
+        std::cerr << "Failed to initialize libsodium" << std::endl;
+        return 1;
+    }
+
+    // Parse optional CLI arguments: [iterations] [num_runs] [garbage_percent...]
+    int iterations = 5000;
+    int num_runs = 3;
+    std::vector<int> garbage_percents = {0, 10, 50, 90, 100};
+    bool valid = true;
+    if (argc >= 2)
+        valid = valid && parse_count(argv[1], iterations);
+    if (argc >= 3)
+        valid = valid && parse_count(argv[2], num_runs);
+    if (argc >= 4)
+    {
+        garbage_percents.assign(argc - 3, 0);
+        for (int i = 3; i < argc; i++)
+            valid = valid && parse_count(argv[i], garbage_percents[i - 3], 0, 100);
+    }
+    if (!valid)
+        return usage_error(argv[0], "[iterations] [num_runs] [garbage_percent (0 to 100)...]");
+
+    std::cout << "Protoss Attack Mix Benchmark" << std::endl;
+    std::cout << "============================" << std::endl;
+
+    const std::vector<unsigned char> P_i = {'A', 'l', 'i', 'c', 'e'};
+    const std::vector<unsigned char> P_j = {'B', 'o', 'b'};
+    protoss::Point V;
+    protoss::hash_to_point(V, "SharedPassword");
+
+    const size_t pool_size = 1024;
+    const size_t batch_size = 64;
+
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(1);
+
+    try
+    {
+        // Every path must accept exactly the honest requests
+        std::cout << "Checking that every path rejects exactly the garbage..." << std::endl;
+        Traffic mixed = make_traffic(pool_size, 50, V, P_i, P_j);
+        int disagreements = 0;
+        for (size_t i = 0; i < pool_size; i++)
+        {
+            const protoss::RspDerRequest &req = mixed.requests[i];
+            protoss::Point R;
+            protoss::SessionKey K;
+            bool late_ok = true, throwing_ok = true;
+            try
+            {
+                late_rspder(R, K, req.V, req.P_i, req.P_j, req.I);
+            }
+            catch (const std::exception &)
+            {
+                late_ok = false;
+            }
+            try
+            {
+                protoss::RspDer(R, K, req.V, req.P_i, req.P_j, req.I);
+            }
+            catch (const std::exception &)
+            {
+                throwing_ok = false;
+            }
+            const bool try_ok = protoss::TryRspDer(R, K, req.V, req.P_i, req.P_j, req.I) == protoss::Status::Ok;
+            disagreements += late_ok != mixed.honest[i] || throwing_ok != mixed.honest[i] || try_ok != mixed.honest[i];
+        }
+        std::vector<protoss::RspDerResponse> responses(pool_size);
+        protoss::RspDerBatch(mixed.requests, responses);
+        for (size_t i = 0; i < pool_size; i++)
+            disagreements += (responses[i].status == protoss::Status::Ok) != mixed.honest[i];
+        if (disagreements != 0)
+        {
+            std::cerr << "ERROR: " << disagreements << " requests accepted or rejected wrongly" << std::endl;
+            return 1;
+        }
+
+        std::cout << "Measuring requests/sec (" << num_runs << " runs x " << iterations << " requests per mix)..." << std::endl;
+
+        ss << "Attack Mix Results with " << iterations << " requests x " << num_runs << " runs per mix\n";
+        ss << "Garbage cycles through: random bytes, non-canonical encodings, I equal to V\n";
+        ss << "late = libsodium call per operation, I first checked by crypto_core_ristretto255_sub, throws\n";
+        ss << "-------------------------\n";
+        ss << "Requests/s by garbage share:\n";
+        ss << std::setw(9) << "garbage" << std::setw(22) << "late + throw" << std::setw(22) << "RspDer (throws)"
+           << std::setw(22) << "TryRspDer" << std::setw(22) << "RspDerBatch (" << batch_size << ")\n";
+
+        for (int percent : garbage_percents)
+        {
+            Traffic traffic = make_traffic(pool_size, percent, V, P_i, P_j);
+            size_t accepted = 0;
+
+            std::vector<double> late = measure(traffic, iterations, num_runs, accepted, [](const protoss::RspDerRequest &req)
+                                               {
+                protoss::Point R;
+                protoss::SessionKey K;
+                try
+                {
+                    late_rspder(R, K, req.V, req.P_i, req.P_j, req.I);
+                    return true;
+                }
+                catch (const std::exception &)
+                {
+                    return false;
+                } });
+            std::vector<double> throwing = measure(traffic, iterations, num_runs, accepted, [](const protoss::RspDerRequest &req)
+                                                   {
+                protoss::Point R;
+                protoss::SessionKey K;
+                try
+                {
+                    protoss::RspDer(R, K, req.V, req.P_i, req.P_j, req.I);
+                    return true;
+                }
+                catch (const std::exception &)
+                {
+                    return false;
+                } });
+            std::vector<double> non_throwing = measure(traffic, iterations, num_runs, accepted, [](const protoss::RspDerRequest &req)
+                                                       {
+                protoss::Point R;
+                protoss::SessionKey K;
+                return protoss::TryRspDer(R, K, req.V, req.P_i, req.P_j, req.I) == protoss::Status::Ok; });
+
+            std::vector<double> batched;
+            std::vector<protoss::RspDerResponse> batch_responses(batch_size);
+            const size_t batches = std::max<size_t>(1, iterations / batch_size);
+            for (int run = 0; run < num_runs; run++)
+            {
+                auto start = std::chrono::steady_clock::now();
+                for (size_t b = 0; b < batches; b++)
+                {
+                    size_t offset = (b * batch_size) % (pool_size - batch_size + 1);
+                    protoss::RspDerBatch(std::span(traffic.requests.data() + offset, batch_size), batch_responses);
+                }
+                auto end = std::chrono::steady_clock::now();
+                batched.push_back(batches * batch_size / std::chrono::duration<double>(end - start).count());
+            }
+
+            auto cell = [](const std::vector<double> &runs)
+            {
+                std::stringstream c;
+                c << std::fixed << std::setprecision(0) << calc_mean(runs) << " +/- " << calc_stddev(runs);
+                return c.str();
+            };
+            ss << std::setw(8) << percent << "%" << std::setw(22) << cell(late) << std::setw(22) << cell(throwing)
+               << std::setw(22) << cell(non_throwing) << std::setw(22) << cell(batched) << "\n";
+        }
+
+        // Cost of turning one request of each kind away
+        ss << "-------------------------\n";
+        ss << "Rejection cost per garbage kind, us: late + throw / RspDer (throws) / TryRspDer\n";
+        for (size_t k = 0; k < size_t(Garbage::Count); k++)
+        {
+            const Garbage kind = Garbage(k);
+            Traffic traffic = make_traffic(pool_size, 0, V, P_i, P_j);
+            for (size_t i = 0; i < pool_size; i++)
+                traffic.requests[i].I = make_garbage(kind, traffic.requests[i].I, V);
+            size_t accepted = 0;
+            auto us = [&](auto step)
+            { return 1e6 / calc_mean(measure(traffic, iterations, num_runs, accepted, step)); };
+
+            const double late = us([](const protoss::RspDerRequest &req)
+                                   {
+                protoss::Point R;
+                protoss::SessionKey K;
+                try
+                {
+                    late_rspder(R, K, req.V, req.P_i, req.P_j, req.I);
+                    return true;
+                }
+                catch (const std::exception &)
+                {
+                    return false;
+                } });
+            const double throwing = us([](const protoss::RspDerRequest &req)
+                                       {
+                protoss::Point R;
+                protoss::SessionKey K;
+                try
+                {
+                    protoss::RspDer(R, K, req.V, req.P_i, req.P_j, req.I);
+                    return true;
+                }
+                catch (const std::exception &)
+                {
+                    return false;
+                } });
+            const double non_throwing = us([](const protoss::RspDerRequest &req)
+                                           {
+                protoss::Point R;
+                protoss::SessionKey K;
+                return protoss::TryRspDer(R, K, req.V, req.P_i, req.P_j, req.I) == protoss::Status::Ok; });
+            ss << std::left << std::setw(15) << garbage_name(kind) << std::right << std::setprecision(2)
+               << std::setw(8) << late << " / " << std::setw(6) << throwing << " / " << std::setw(6) << non_throwing << "\n"
+               << std::setprecision(1);
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n"
+              << ss.str();
+
+    auto now = std::time(nullptr);
+    std::stringstream filename;
+    filename << "attack_mix_results_it" << iterations << "_" << std::put_time(std::localtime(&now), "%Y-%m-%d_%H-%M-%S") << ".txt";
+    Logger::get_instance().log_to_file(filename.str(), ss.str());
+    std::cout << "\nAttack mix results saved to benchmark_results/sodium/" << filename.str() << std::endl;
+
+    return 0;
+}
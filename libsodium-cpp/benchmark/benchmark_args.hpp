@@ -0,0 +1,34 @@
+#ifndef BENCHMARK_ARGS_HPP
+#define BENCHMARK_ARGS_HPP
+
+#include <cerrno>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+
+// Parses a count argument: a whole decimal integer in [min, max] that fits T.
+// Anything else, a flag such as --help included, is rejected rather than read
+// as 0 the way atoi would.
+template <typename T>
+bool parse_count(const char *arg, T &out, long long min = 1, long long max = std::numeric_limits<long long>::max())
+{
+    char *end = nullptr;
+    errno = 0;
+    long long value = std::strtoll(arg, &end, 10);
+    if (end == arg || *end != '\0' || errno == ERANGE || value < min || value > max)
+        return false;
+    if (value < 0 ? value < (long long)std::numeric_limits<T>::min()
+                  : (unsigned long long)value > (unsigned long long)std::numeric_limits<T>::max())
+        return false;
+    out = (T)value;
+    return true;
+}
+
+// Prints the usage line of a benchmark; returns the exit status for main()
+inline int usage_error(const char *program, const char *arguments)
+{
+    std::cerr << "Usage: " << program << " " << arguments << std::endl;
+    return 1;
+}
+
+#endif // BENCHMARK_ARGS_HPP
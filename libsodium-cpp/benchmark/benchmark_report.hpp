@@ -0,0 +1,257 @@
+#ifndef BENCHMARK_REPORT_HPP
+#define BENCHMARK_REPORT_HPP
+
+#include <sodium.h>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "benchmark_stats.hpp"
+#include "latency_histogram.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+#if !defined(_WIN32)
+#include <sys/utsname.h>
+#endif
+
+// Stamped into the build by the build system; "unknown" when built by hand
+#ifndef PROTOSS_BUILD_FLAGS
+#define PROTOSS_BUILD_FLAGS "unknown"
+#endif
+#ifndef PROTOSS_GIT_SHA
+#define PROTOSS_GIT_SHA "unknown"
+#endif
+
+// Structured benchmark output. The JSON and CSV layouts below are a stable
+// schema for regression tracking: fields are only ever added, and
+// BENCHMARK_SCHEMA_VERSION is bumped if one changes meaning. All latencies are
+// in microseconds.
+constexpr int BENCHMARK_SCHEMA_VERSION = 1;
+
+// Where and with what a benchmark ran
+struct BenchmarkEnvironment
+{
+    std::string timestamp_utc;
+    std::string os;
+    std::string cpu_model;
+    unsigned hardware_threads = 0;
+    std::string compiler;
+    std::string build_flags;
+    std::string git_sha;
+    std::string libsodium_version;
+
+    static BenchmarkEnvironment collect()
+    {
+        BenchmarkEnvironment env;
+
+        std::time_t now = std::time(nullptr);
+        std::tm tm{};
+#ifdef _WIN32
+        gmtime_s(&tm, &now);
+#else
+        gmtime_r(&now, &tm);
+#endif
+        char buf[32];
+        std::strftime(buf, sizeof buf, "%Y-%m-%dT%H:%M:%SZ", &tm);
+        env.timestamp_utc = buf;
+
+#ifdef _WIN32
+        env.os = "Windows";
+#else
+        utsname name;
+        if (uname(&name) == 0)
+            env.os = std::string(name.sysname) + " " + name.release + " " + name.machine;
+#endif
+
+        env.cpu_model = read_cpu_model();
+        env.hardware_threads = std::thread::hardware_concurrency();
+
+#if defined(__clang__)
+        env.compiler = "Clang " __clang_version__;
+#elif defined(__GNUC__)
+        env.compiler = "GCC " __VERSION__;
+#elif defined(_MSC_VER)
+        env.compiler = "MSVC " + std::to_string(_MSC_VER);
+#else
+        env.compiler = "unknown";
+#endif
+        env.build_flags = PROTOSS_BUILD_FLAGS;
+        env.git_sha = PROTOSS_GIT_SHA;
+        env.libsodium_version = sodium_version_string();
+        return env;
+    }
+
+private:
+    // CPUID brand string on x86, /proc/cpuinfo elsewhere on Linux
+    static std::string read_cpu_model()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        unsigned regs[12];
+        if (__get_cpuid(0x80000000, &regs[0], &regs[1], &regs[2], &regs[3]) && regs[0] >= 0x80000004)
+        {
+            for (unsigned leaf = 0; leaf < 3; leaf++)
+                __get_cpuid(0x80000002 + leaf, &regs[4 * leaf], &regs[4 * leaf + 1], &regs[4 * leaf + 2], &regs[4 * leaf + 3]);
+            char brand[sizeof regs + 1] = {};
+            std::memcpy(brand, regs, sizeof regs);
+            std::string model(brand);
+            size_t first = model.find_first_not_of(' ');
+            return first == std::string::npos ? "unknown" : model.substr(first);
+        }
+#endif
+        std::ifstream cpuinfo("/proc/cpuinfo");
+        std::string line;
+        while (std::getline(cpuinfo, line))
+        {
+            if (line.rfind("model name", 0) == 0 || line.rfind("Model", 0) == 0)
+            {
+                size_t colon = line.find(':');
+                if (colon != std::string::npos && colon + 2 <= line.size())
+                    return line.substr(colon + 2);
+            }
+        }
+        return "unknown";
+    }
+};
+
+// One measured phase: the mean of each run, and optionally the per-handshake distribution
+struct PhaseSeries
+{
+    std::string protocol;
+    std::string phase;
+    std::vector<double> run_means_us;
+    const LatencyHistogram *histogram = nullptr;
+};
+
+struct BenchmarkReport
+{
+    std::string benchmark;
+    std::vector<std::pair<std::string, long long>> config; // e.g. iterations, num_runs
+    std::vector<PhaseSeries> series;
+
+    void write_json(std::ostream &out, const BenchmarkEnvironment &env) const
+    {
+        out << std::fixed << std::setprecision(3);
+        out << "{\n";
+        out << "  \"schema_version\": " << BENCHMARK_SCHEMA_VERSION << ",\n";
+        out << "  \"benchmark\": " << json_string(benchmark) << ",\n";
+        out << "  \"environment\": {\n";
+        out << "    \"timestamp_utc\": " << json_string(env.timestamp_utc) << ",\n";
+        out << "    \"os\": " << json_string(env.os) << ",\n";
+        out << "    \"cpu_model\": " << json_string(env.cpu_model) << ",\n";
+        out << "    \"hardware_threads\": " << env.hardware_threads << ",\n";
+        out << "    \"compiler\": " << json_string(env.compiler) << ",\n";
+        out << "    \"build_flags\": " << json_string(env.build_flags) << ",\n";
+        out << "    \"git_sha\": " << json_string(env.git_sha) << ",\n";
+        out << "    \"libsodium_version\": " << json_string(env.libsodium_version) << "\n";
+        out << "  },\n";
+        out << "  \"config\": {";
+        for (size_t i = 0; i < config.size(); i++)
+            out << (i ? ", " : "") << json_string(config[i].first) << ": " << config[i].second;
+        out << "},\n";
+        out << "  \"results\": [";
+        for (size_t s = 0; s < series.size(); s++)
+        {
+            const PhaseSeries &p = series[s];
+            out << (s ? ",\n" : "\n") << "    {\"protocol\": " << json_string(p.protocol) << ", \"phase\": " << json_string(p.phase)
+                << ", \"unit\": \"us\",\n";
+            out << "     \"runs\": [";
+            for (size_t r = 0; r < p.run_means_us.size(); r++)
+                out << (r ? ", " : "") << p.run_means_us[r];
+            out << "],\n";
+            out << "     \"mean\": " << calc_mean(p.run_means_us) << ", \"stddev\": " << calc_stddev(p.run_means_us);
+            if (p.histogram)
+            {
+                const LatencyHistogram &h = *p.histogram;
+                out << ",\n     \"count\": " << h.count() << ", \"min\": " << h.min() / 1000.0;
+                for (const auto &[name, percentile] : PERCENTILES)
+                    out << ", \"" << name << "\": " << h.value_at_percentile(percentile) / 1000.0;
+                out << ", \"max\": " << h.max() / 1000.0;
+            }
+            out << "}";
+        }
+        out << "\n  ]\n";
+        out << "}\n";
+    }
+
+    // Long format, one value per row: section,protocol,phase,metric,value
+    void write_csv(std::ostream &out, const BenchmarkEnvironment &env) const
+    {
+        out << std::fixed << std::setprecision(3);
+        out << "section,protocol,phase,metric,value\n";
+        auto env_row = [&](const char *key, const std::string &value)
+        { out << "environment,,," << key << "," << csv_field(value) << "\n"; };
+        env_row("schema_version", std::to_string(BENCHMARK_SCHEMA_VERSION));
+        env_row("benchmark", benchmark);
+        env_row("timestamp_utc", env.timestamp_utc);
+        env_row("os", env.os);
+        env_row("cpu_model", env.cpu_model);
+        env_row("hardware_threads", std::to_string(env.hardware_threads));
+        env_row("compiler", env.compiler);
+        env_row("build_flags", env.build_flags);
+        env_row("git_sha", env.git_sha);
+        env_row("libsodium_version", env.libsodium_version);
+        for (const auto &[key, value] : config)
+            out << "config,,," << csv_field(key) << "," << value << "\n";
+
+        for (const PhaseSeries &p : series)
+        {
+            std::string prefix = "result," + csv_field(p.protocol) + "," + csv_field(p.phase) + ",";
+            for (size_t r = 0; r < p.run_means_us.size(); r++)
+                out << prefix << "run_" << (r + 1) << "," << p.run_means_us[r] << "\n";
+            out << prefix << "mean," << calc_mean(p.run_means_us) << "\n";
+            out << prefix << "stddev," << calc_stddev(p.run_means_us) << "\n";
+            if (p.histogram)
+            {
+                const LatencyHistogram &h = *p.histogram;
+                out << prefix << "count," << h.count() << "\n";
+                out << prefix << "min," << h.min() / 1000.0 << "\n";
+                for (const auto &[name, percentile] : PERCENTILES)
+                    out << prefix << name << "," << h.value_at_percentile(percentile) / 1000.0 << "\n";
+                out << prefix << "max," << h.max() / 1000.0 << "\n";
+            }
+        }
+    }
+
+private:
+    static constexpr std::pair<const char *, double> PERCENTILES[] = {{"p50", 50.0}, {"p90", 90.0}, {"p99", 99.0}, {"p99_9", 99.9}};
+
+    static std::string json_string(const std::string &s)
+    {
+        std::string out = "\"";
+        for (unsigned char c : s)
+        {
+            if (c == '"' || c == '\\')
+                out += '\\', out += char(c);
+            else if (c < 0x20)
+            {
+                char esc[8];
+                std::snprintf(esc, sizeof esc, "\\u%04x", c);
+                out += esc;
+            }
+            else
+                out += char(c);
+        }
+        return out + "\"";
+    }
+
+    static std::string csv_field(const std::string &s)
+    {
+        if (s.find_first_of(",\"\n") == std::string::npos)
+            return s;
+        std::string out = "\"";
+        for (char c : s)
+            out += (c == '"') ? std::string("\"\"") : std::string(1, c);
+        return out + "\"";
+    }
+};
+
+#endif // BENCHMARK_REPORT_HPP
@@ -0,0 +1,32 @@
+#ifndef BENCHMARK_STATS_HPP
+#define BENCHMARK_STATS_HPP
+
+#include <cmath>
+#include <vector>
+
+// Mean and sample standard deviation of per-run results, shared by the
+// benchmarks and BenchmarkReport so every report computes them the same way
+
+inline double calc_mean(const std::vector<double> &values)
+{
+    double sum = 0.0;
+    for (double v : values)
+        sum += v;
+    return values.empty() ? 0.0 : sum / values.size();
+}
+
+inline double calc_stddev(const std::vector<double> &values)
+{
+    if (values.size() < 2)
+        return 0.0;
+    double m = calc_mean(values);
+    double sum_sq = 0.0;
+    for (double v : values)
+    {
+        double diff = v - m;
+        sum_sq += diff * diff;
+    }
+    return std::sqrt(sum_sq / (values.size() - 1));
+}
+
+#endif // BENCHMARK_STATS_HPP
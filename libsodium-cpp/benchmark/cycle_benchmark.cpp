@@ -0,0 +1,233 @@
+#include <sodium.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "benchmark_args.hpp"
+#include "latency_histogram.hpp"
+#include "logger.hpp"
+#include "perf_counters.hpp"
+#include "protoss_probes.hpp"
+#include "protoss_protocol.hpp"
+
+// Cycle-level view of one handshake phase
+struct PhaseCycles
+{
+    const char *name;
+    LatencyHistogram cycles; // TSC cycles per call, fence overhead removed
+    PerfCounters::Values counters{};
+};
+
+// Time-stamp counter ticks per nanosecond, measured against steady_clock
+static double calibrate_tsc_ghz()
+{
+    auto wall_start = std::chrono::steady_clock::now();
+    uint64_t tsc_start = protoss::read_cycles_begin();
+    while (std::chrono::steady_clock::now() - wall_start < std::chrono::milliseconds(200))
+        ;
+    uint64_t tsc_end = protoss::read_cycles_end();
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - wall_start).count();
+    return (tsc_end - tsc_start) / ns;
+}
+
+// Smallest back-to-back begin/end reading, subtracted from every sample
+static uint64_t measure_fence_overhead()
+{
+    uint64_t best = ~uint64_t(0);
+    for (int i = 0; i < 10000; i++)
+    {
+        uint64_t start = protoss::read_cycles_begin();
+        best = std::min(best, protoss::read_cycles_end() - start);
+    }
+    return best;
+}
+
+int main(int argc, char *argv[])
+{
+    if (sodium_init() < 0)
+    {
+        std::cerr << "Failed to initialize libsodium" << std::endl;
+        return 1;
+    }
+
+    // Parse optional CLI arguments: [iterations] [num_runs]
+    int iterations = 20000;
+    int num_runs = 5;
+    bool valid = argc <= 3;
+    if (argc >= 2)
+        valid = valid && parse_count(argv[1], iterations);
+    if (argc >= 3)
+        valid = valid && parse_count(argv[2], num_runs);
+    if (!valid)
+        return usage_error(argv[0], "[iterations] [num_runs]");
+
+    std::cout << "Protoss Cycle Counter Benchmark" << std::endl;
+    std::cout << "===============================" << std::endl;
+
+    const std::string password = "SharedPassword";
+    const unsigned char P_i[] = {0x00};
+    const unsigned char P_j[] = {0x01};
+    protoss::Point I, R;
+    protoss::State state;
+    protoss::SessionKey K_i, K_j;
+
+    std::cout << "Calibrating time-stamp counter..." << std::endl;
+    double tsc_ghz = calibrate_tsc_ghz();
+    uint64_t overhead = measure_fence_overhead();
+
+    for (int i = 0; i < 200; i++)
+    {
+        protoss::Init(I, state, password, P_i, P_j);
+        protoss::RspDer(R, K_j, password, P_i, P_j, I);
+        protoss::Der(K_i, state, R);
+    }
+
+    PhaseCycles phases[3] = {{"Init", {}, {}}, {"RspDer", {}, {}}, {"Der", {}, {}}};
+    auto sample = [&](PhaseCycles &phase, uint64_t start, uint64_t end)
+    {
+        uint64_t cycles = end - start;
+        phase.cycles.record(cycles > overhead ? cycles - overhead : 0);
+    };
+
+    // Pass 1: TSC cycles per phase, plus the sub-phase probes when compiled in
+    std::cout << "Running " << num_runs << " runs x " << iterations << " handshakes (TSC)..." << std::endl;
+    protoss::reset_probes();
+    try
+    {
+        for (int r = 0; r < num_runs; r++)
+        {
+            for (int i = 0; i < iterations; i++)
+            {
+                uint64_t t0 = protoss::read_cycles_begin();
+                protoss::Init(I, state, password, P_i, P_j);
+                uint64_t t1 = protoss::read_cycles_end();
+                sample(phases[0], t0, t1);
+
+                t0 = protoss::read_cycles_begin();
+                protoss::RspDer(R, K_j, password, P_i, P_j, I);
+                t1 = protoss::read_cycles_end();
+                sample(phases[1], t0, t1);
+
+                t0 = protoss::read_cycles_begin();
+                protoss::Der(K_i, state, R);
+                t1 = protoss::read_cycles_end();
+                sample(phases[2], t0, t1);
+
+                if (K_i != K_j)
+                {
+                    std::cerr << "ERROR: Session keys don't match!" << std::endl;
+                    return 1;
+                }
+            }
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Exception: " << e.what() << std::endl;
+        return 1;
+    }
+    protoss::ProbeTotals probes = protoss::probe_totals();
+
+    // Pass 2: hardware counters per phase, kept apart so the syscalls don't blur pass 1
+    PerfCounters perf;
+    if (perf.available())
+    {
+        std::cout << "Running " << iterations << " handshakes (perf_event_open)..." << std::endl;
+        auto count = [&](PhaseCycles &phase, auto &&step)
+        {
+            perf.start();
+            step();
+            PerfCounters::Values values = perf.stop();
+            for (int e = 0; e < PerfCounters::EventCount; e++)
+                phase.counters[e] += values[e];
+        };
+        for (int i = 0; i < iterations; i++)
+        {
+            count(phases[0], [&]
+                  { protoss::Init(I, state, password, P_i, P_j); });
+            count(phases[1], [&]
+                  { protoss::RspDer(R, K_j, password, P_i, P_j, I); });
+            count(phases[2], [&]
+                  { protoss::Der(K_i, state, R); });
+        }
+    }
+
+    const uint64_t handshakes = uint64_t(iterations) * num_runs;
+    double handshake_cycles = 0.0;
+    for (const PhaseCycles &phase : phases)
+        handshake_cycles += phase.cycles.mean();
+
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(1);
+    ss << "Cycle Counter Results with " << iterations << " iterations x " << num_runs << " runs\n";
+    ss << "TSC: " << std::setprecision(3) << tsc_ghz << " GHz (calibrated), read overhead " << overhead
+       << " cycles (subtracted)\n"
+       << std::setprecision(1);
+    ss << "-------------------------\n";
+    ss << "Phase     TSC cycles p50     p99        mean       mean (us)\n";
+    for (const PhaseCycles &phase : phases)
+    {
+        ss << std::left << std::setw(10) << phase.name << std::right << std::setw(14) << double(phase.cycles.value_at_percentile(50))
+           << std::setw(11) << double(phase.cycles.value_at_percentile(99)) << std::setw(11) << phase.cycles.mean()
+           << std::setw(16) << std::setprecision(3) << phase.cycles.mean() / tsc_ghz / 1000.0 << std::setprecision(1) << "\n";
+    }
+
+    ss << "-------------------------\n";
+    if (perf.available())
+    {
+        ss << "Hardware counters per call (perf_event_open, user space, " << iterations << " handshakes):\n";
+        ss << "Phase         cycles   instructions    IPC   cache-misses   branch-misses\n";
+        for (const PhaseCycles &phase : phases)
+        {
+            const PerfCounters::Values &c = phase.counters;
+            ss << std::left << std::setw(10) << phase.name << std::right
+               << std::setw(10) << double(c[PerfCounters::Cycles]) / iterations
+               << std::setw(15) << double(c[PerfCounters::Instructions]) / iterations
+               << std::setw(7) << std::setprecision(2)
+               << (c[PerfCounters::Cycles] ? double(c[PerfCounters::Instructions]) / c[PerfCounters::Cycles] : 0.0)
+               << std::setprecision(1)
+               << std::setw(15) << double(c[PerfCounters::CacheMisses]) / iterations
+               << std::setw(16) << double(c[PerfCounters::BranchMisses]) / iterations << "\n";
+        }
+    }
+    else
+    {
+        ss << "Hardware counters unavailable: " << perf.error() << "\n";
+    }
+
+    ss << "-------------------------\n";
+    if (protoss::probes_enabled)
+    {
+        ss << "Sub-phase probes (TSC cycles, probe overhead included):\n";
+        ss << "Probe             calls/handshake   cycles/call   share of handshake\n";
+        for (size_t p = 0; p < protoss::PROBE_COUNT; p++)
+        {
+            double calls = double(probes.calls[p]);
+            double cycles = double(probes.cycles[p]);
+            ss << std::left << std::setw(18) << protoss::probe_name(protoss::Probe(p)) << std::right
+               << std::setw(15) << std::setprecision(2) << calls / handshakes
+               << std::setw(14) << std::setprecision(1) << (calls ? cycles / calls : 0.0)
+               << std::setw(20) << (cycles / handshakes / handshake_cycles * 100) << "%\n";
+        }
+    }
+    else
+    {
+        ss << "Sub-phase probes disabled; rebuild with -DPROTOSS_PROBES (CMake: -DPROTOSS_PROBES=ON)\n";
+    }
+
+    std::cout << "\n"
+              << ss.str();
+
+    auto now = std::time(nullptr);
+    std::stringstream filename;
+    filename << "cycle_results_it" << iterations << "_" << std::put_time(std::localtime(&now), "%Y-%m-%d_%H-%M-%S") << ".txt";
+    Logger::get_instance().log_to_file(filename.str(), ss.str());
+    std::cout << "\nCycle results saved to benchmark_results/sodium/" << filename.str() << std::endl;
+
+    return 0;
+}
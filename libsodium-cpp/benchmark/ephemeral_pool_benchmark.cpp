@@ -0,0 +1,204 @@
+#include <sodium.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "benchmark_args.hpp"
+#include "ephemeral_pool.hpp"
+#include "latency_histogram.hpp"
+#include "logger.hpp"
+#include "protoss_protocol.hpp"
+
+// Per-call latency of the two phases that need an ephemeral pair
+struct PhaseLatency
+{
+    LatencyHistogram init, rspder;
+};
+
+static void write_row(std::stringstream &ss, const char *name, const LatencyHistogram &inline_hist, const LatencyHistogram &pooled_hist)
+{
+    double saved = inline_hist.mean() - pooled_hist.mean();
+    ss << std::left << std::setw(8) << name << std::right
+       << std::setw(10) << inline_hist.mean() / 1000.0 << std::setw(10) << inline_hist.value_at_percentile(99) / 1000.0
+       << std::setw(10) << pooled_hist.mean() / 1000.0 << std::setw(10) << pooled_hist.value_at_percentile(99) / 1000.0
+       << std::setw(10) << saved / 1000.0 << " (" << (saved / inline_hist.mean() * 100) << "%)\n";
+}
+
+// Runs `handshakes` Init + RspDer pairs, drawing ephemerals from the pool when one is given
+static void run_handshakes(int handshakes, const protoss::Point &V, protoss::EphemeralPool *pool, PhaseLatency &latency)
+{
+    const unsigned char P_i[] = {0x00};
+    const unsigned char P_j[] = {0x01};
+    protoss::Point I, R;
+    protoss::State state;
+    protoss::SessionKey K_i, K_j;
+    protoss::Ephemeral e;
+
+    for (int i = 0; i < handshakes; i++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        if (pool)
+        {
+            pool->take(e);
+            protoss::Init(I, state, V, P_i, P_j, e);
+        }
+        else
+            protoss::Init(I, state, V, P_i, P_j);
+        auto end = std::chrono::steady_clock::now();
+        latency.init.record(end - start);
+
+        start = std::chrono::steady_clock::now();
+        if (pool)
+        {
+            pool->take(e);
+            protoss::RspDer(R, K_j, V, P_i, P_j, I, e);
+        }
+        else
+            protoss::RspDer(R, K_j, V, P_i, P_j, I);
+        end = std::chrono::steady_clock::now();
+        latency.rspder.record(end - start);
+
+        protoss::Der(K_i, state, R);
+        if (K_i != K_j)
+            throw std::runtime_error("session keys don't match");
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    if (sodium_init() < 0)
+    {
+        std::cerr << "Failed to initialize libsodium" << std::endl;
+        return 1;
+    }
+
+    // Parse optional CLI arguments: [iterations] [capacity] [refill_threads] [num_runs]
+    int iterations = 20000;
+    size_t capacity = 4096;
+    unsigned refill_threads = 1;
+    int num_runs = 4;
+    bool valid = argc <= 5;
+    if (argc >= 2)
+        valid = valid && parse_count(argv[1], iterations);
+    if (argc >= 3)
+        valid = valid && parse_count(argv[2], capacity);
+    if (argc >= 4)
+        valid = valid && parse_count(argv[3], refill_threads);
+    if (argc >= 5)
+        valid = valid && parse_count(argv[4], num_runs);
+    if (!valid)
+        return usage_error(argv[0], "[iterations] [capacity] [refill_threads] [num_runs]");
+
+    std::cout << "Protoss Ephemeral Pool Benchmark" << std::endl;
+    std::cout << "================================" << std::endl;
+
+    protoss::Point V;
+    protoss::hash_to_point(V, "SharedPassword");
+
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(3);
+
+    try
+    {
+        // Critical path: inline generation against a pre-filled pool. The pool is
+        // refilled between bursts outside the timed region, as idle responders would.
+        std::cout << "Measuring critical-path latency (" << num_runs << " runs x " << iterations << " handshakes)..." << std::endl;
+        protoss::EphemeralPool burst_pool(capacity, 0);
+        const int burst = int(burst_pool.capacity() / 2);
+        PhaseLatency inline_latency, pooled_latency;
+        run_handshakes(200, V, nullptr, inline_latency);
+        inline_latency = PhaseLatency{};
+        for (int r = 0; r < num_runs; r++)
+        {
+            auto run_inline = [&]
+            { run_handshakes(iterations, V, nullptr, inline_latency); };
+            auto run_pooled = [&]
+            {
+                for (int done = 0; done < iterations; done += burst)
+                {
+                    burst_pool.fill();
+                    run_handshakes(std::min(burst, iterations - done), V, &burst_pool, pooled_latency);
+                }
+            };
+            // Alternate the order between runs to avoid ordering bias
+            if (r % 2 == 0)
+                run_inline(), run_pooled();
+            else
+                run_pooled(), run_inline();
+        }
+        if (burst_pool.stats().fallbacks != 0)
+            throw std::runtime_error("pre-filled pool ran dry");
+
+        // Refill rate: background threads filling an empty pool
+        std::cout << "Measuring refill rate with " << refill_threads << " thread(s)..." << std::endl;
+        double refill_per_s;
+        {
+            auto start = std::chrono::steady_clock::now();
+            protoss::EphemeralPool pool(capacity, refill_threads);
+            while (pool.size() < pool.capacity())
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            refill_per_s = pool.capacity() / seconds;
+        }
+
+        // Drain rate: a responder running pooled handshakes back to back takes two pairs per handshake
+        double handshake_us = (pooled_latency.init.mean() + pooled_latency.rspder.mean()) / 1000.0;
+        double drain_per_s = 2.0 / handshake_us * 1e6;
+
+        // Sustained load: handshakes at full speed while the refill threads run
+        std::cout << "Running " << iterations << " handshakes against a live pool..." << std::endl;
+        PhaseLatency live_latency;
+        protoss::EphemeralPool::Stats live_stats;
+        {
+            protoss::EphemeralPool pool(capacity, refill_threads);
+            pool.fill();
+            run_handshakes(iterations, V, &pool, live_latency);
+            live_stats = pool.stats();
+        }
+        double taken = double(live_stats.consumed + live_stats.fallbacks);
+
+        ss << "Ephemeral Pool Results with " << iterations << " handshakes x " << num_runs << " runs, capacity "
+           << burst_pool.capacity() << ", " << refill_threads << " refill thread(s), "
+           << std::thread::hardware_concurrency() << " hardware threads\n";
+        ss << "-------------------------\n";
+        ss << "Critical path per call, pool pre-filled between bursts of " << burst << " handshakes (us):\n";
+        ss << "Phase   inline mean       p99  pool mean       p99     saved\n";
+        write_row(ss, "Init", inline_latency.init, pooled_latency.init);
+        write_row(ss, "RspDer", inline_latency.rspder, pooled_latency.rspder);
+        ss << "-------------------------\n";
+        ss << std::setprecision(0);
+        ss << "Refill rate:     " << refill_per_s << " pairs/s (" << refill_threads << " thread(s))\n";
+        ss << "Drain rate:      " << drain_per_s << " pairs/s (one responder, back-to-back pooled handshakes)\n";
+        ss << std::setprecision(3);
+        ss << "Refill / drain:  " << (refill_per_s / drain_per_s) << "\n";
+        ss << "-------------------------\n";
+        ss << "Sustained load, refill threads running:\n";
+        ss << "Pool hits:       " << live_stats.consumed << " (" << (live_stats.consumed / taken * 100) << "%)\n";
+        ss << "Inline fallback: " << live_stats.fallbacks << " (" << (live_stats.fallbacks / taken * 100) << "%)\n";
+        ss << "Init mean:       " << live_latency.init.mean() / 1000.0 << " us, RspDer mean: " << live_latency.rspder.mean() / 1000.0 << " us\n";
+        ss << "A refill/drain ratio below 1 means sustained full-speed load empties the pool; it then absorbs\n";
+        ss << "bursts of up to capacity/2 pairs and the refill threads catch up between them.\n";
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n"
+              << ss.str();
+
+    auto now = std::time(nullptr);
+    std::stringstream filename;
+    filename << "ephemeral_pool_results_it" << iterations << "_" << std::put_time(std::localtime(&now), "%Y-%m-%d_%H-%M-%S") << ".txt";
+    Logger::get_instance().log_to_file(filename.str(), ss.str());
+    std::cout << "\nEphemeral pool results saved to benchmark_results/sodium/" << filename.str() << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,174 @@
+#include <sodium.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "benchmark_args.hpp"
+#include "benchmark_stats.hpp"
+#include "logger.hpp"
+#include "protoss_protocol.hpp"
+#include "ristretto255_lanes.hpp"
+
+using protoss::ristretto255::Backend;
+
+// Compares hash_to_point_batch with hash_to_point on every supported backend
+// for batch sizes around the chunk and register widths; returns the number
+// of mismatching points
+static int cross_check(const std::vector<std::string_view> &passwords, const std::vector<Backend> &backends)
+{
+    std::vector<protoss::Point> expected(passwords.size()), actual(passwords.size());
+    for (size_t i = 0; i < passwords.size(); i++)
+        protoss::hash_to_point(expected[i], passwords[i]);
+
+    int mismatches = 0;
+    for (Backend backend : backends)
+    {
+        protoss::ristretto255::set_active_backend(backend);
+        for (size_t n : {size_t(1), size_t(3), size_t(9), size_t(65), passwords.size()})
+        {
+            n = std::min(n, passwords.size());
+            protoss::hash_to_point_batch(std::span(actual.data(), n), std::span(passwords.data(), n));
+            for (size_t i = 0; i < n; i++)
+                mismatches += actual[i] != expected[i];
+        }
+    }
+    return mismatches;
+}
+
+// Points per second of hash_to_point_batch at one batch size, over `iterations` passwords
+static std::vector<double> measure_batch(const std::vector<std::string_view> &passwords, size_t batch_size, int iterations, int num_runs)
+{
+    std::vector<protoss::Point> out(batch_size);
+    size_t batches = std::max<size_t>(1, iterations / batch_size);
+    std::vector<double> runs;
+    for (int run = 0; run < num_runs; run++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t b = 0; b < batches; b++)
+        {
+            size_t offset = (b * batch_size) % (passwords.size() - batch_size + 1);
+            protoss::hash_to_point_batch(out, std::span(passwords.data() + offset, batch_size));
+        }
+        auto end = std::chrono::steady_clock::now();
+        runs.push_back(batches * batch_size / std::chrono::duration<double>(end - start).count());
+    }
+    return runs;
+}
+
+int main(int argc, char *argv[])
+{
+    if (sodium_init() < 0)
+    {
+        std::cerr << "Failed to initialize libsodium" << std::endl;
+        return 1;
+    }
+
+    // Parse optional CLI arguments: [iterations] [num_runs]
+    int iterations = 20000;
+    int num_runs = 5;
+    bool valid = argc <= 3;
+    if (argc >= 2)
+        valid = valid && parse_count(argv[1], iterations);
+    if (argc >= 3)
+        valid = valid && parse_count(argv[2], num_runs);
+    if (!valid)
+        return usage_error(argv[0], "[iterations] [num_runs]");
+
+    std::cout << "Protoss Batched Hash-to-Point Benchmark" << std::endl;
+    std::cout << "=======================================" << std::endl;
+
+    // Distinct passwords of realistic length, generated outside the timed region
+    const size_t max_batch = 1024;
+    std::vector<std::string> storage(max_batch * 4);
+    std::vector<std::string_view> passwords(storage.size());
+    for (size_t i = 0; i < storage.size(); i++)
+    {
+        storage[i] = "password-" + std::to_string(i) + "-" + std::to_string(randombytes_uniform(1000000));
+        passwords[i] = storage[i];
+    }
+
+    const Backend automatic = protoss::ristretto255::active_backend();
+    std::vector<Backend> backends;
+    for (Backend backend : {Backend::Scalar, Backend::Avx2, Backend::Avx512Ifma})
+        if (protoss::ristretto255::backend_supported(backend))
+            backends.push_back(backend);
+
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(1);
+
+    try
+    {
+        std::cout << "Cross-checking hash_to_point_batch against hash_to_point..." << std::endl;
+        int mismatches = cross_check(passwords, backends);
+        protoss::ristretto255::set_active_backend(automatic);
+        if (mismatches != 0)
+        {
+            std::cerr << "ERROR: " << mismatches << " points differ from hash_to_point" << std::endl;
+            return 1;
+        }
+
+        std::cout << "Measuring points/sec (" << num_runs << " runs x " << iterations << " passwords per batch size)..." << std::endl;
+
+        // Baseline: one hash_to_point call per password
+        std::vector<double> single_runs;
+        for (int run = 0; run < num_runs; run++)
+        {
+            protoss::Point point;
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < iterations; i++)
+                protoss::hash_to_point(point, passwords[i % passwords.size()]);
+            auto end = std::chrono::steady_clock::now();
+            single_runs.push_back(iterations / std::chrono::duration<double>(end - start).count());
+        }
+        double mean_single = calc_mean(single_runs);
+
+        ss << "Batched Hash-to-Point Results with " << iterations << " passwords x " << num_runs << " runs\n";
+        ss << "Cross-check: " << backends.size() << " backends, 0 mismatches against hash_to_point\n";
+        ss << "-------------------------\n";
+        ss << "Single hash_to_point: " << mean_single << " +/- " << calc_stddev(single_runs) << " points/s\n";
+        ss << "hash_to_point_batch on " << protoss::ristretto255::backend_name(automatic) << ":\n";
+        for (size_t batch_size : {size_t(1), size_t(8), size_t(64), size_t(256), max_batch})
+        {
+            std::vector<double> runs = measure_batch(passwords, batch_size, iterations, num_runs);
+            ss << "Batch size " << std::setw(4) << batch_size << ": " << std::setw(9) << calc_mean(runs) << " +/- "
+               << calc_stddev(runs) << " points/s (" << std::setprecision(2) << calc_mean(runs) / mean_single
+               << "x single)\n"
+               << std::setprecision(1);
+        }
+
+        ss << "-------------------------\n";
+        ss << "Batch size " << max_batch << " per backend:\n";
+        for (Backend backend : backends)
+        {
+            protoss::ristretto255::set_active_backend(backend);
+            std::vector<double> runs = measure_batch(passwords, max_batch, iterations, num_runs);
+            ss << std::left << std::setw(12) << protoss::ristretto255::backend_name(backend) << std::right
+               << std::setw(9) << calc_mean(runs) << " +/- " << calc_stddev(runs) << " points/s ("
+               << std::setprecision(2) << calc_mean(runs) / mean_single << "x single)\n"
+               << std::setprecision(1);
+        }
+        protoss::ristretto255::set_active_backend(automatic);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n"
+              << ss.str();
+
+    auto now = std::time(nullptr);
+    std::stringstream filename;
+    filename << "hash_to_point_results_it" << iterations << "_" << std::put_time(std::localtime(&now), "%Y-%m-%d_%H-%M-%S") << ".txt";
+    Logger::get_instance().log_to_file(filename.str(), ss.str());
+    std::cout << "\nHash-to-point results saved to benchmark_results/sodium/" << filename.str() << std::endl;
+
+    return 0;
+}
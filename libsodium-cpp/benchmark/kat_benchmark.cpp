@@ -0,0 +1,330 @@
+#include <sodium.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "benchmark_args.hpp"
+#include "benchmark_stats.hpp"
+#include "logger.hpp"
+#include "protoss_batch.hpp"
+#include "protoss_protocol.hpp"
+#include "scalar_drbg.hpp"
+
+#ifndef PROTOSS_DETERMINISTIC
+#error "kat_benchmark needs a PROTOSS_DETERMINISTIC build (cmake -DPROTOSS_DETERMINISTIC=ON)"
+#endif
+
+constexpr size_t PASSWORD_LEN = 16;
+constexpr size_t IDENTITY_LEN = 32;
+constexpr size_t BATCH_SIZE = 256;
+
+// Passwords and identities of every handshake, a fixed function of the seed
+struct KatInputs
+{
+    std::vector<std::string> passwords;
+    std::vector<std::array<unsigned char, IDENTITY_LEN>> P_i, P_j;
+};
+
+// Everything a handshake produces that depends on its random scalars
+struct KatOutputs
+{
+    std::vector<protoss::Point> V, I, R;
+    std::vector<protoss::State> states;
+    std::vector<protoss::SessionKey> K_j, K_i;
+};
+
+static KatInputs make_inputs(uint64_t seed, size_t n)
+{
+    static const char domain[] = "protoss kat inputs";
+    static const char charset[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+    unsigned char key[randombytes_SEEDBYTES];
+    unsigned char seed_le[8];
+    for (int i = 0; i < 8; i++)
+        seed_le[i] = (unsigned char)(seed >> (8 * i));
+    crypto_generichash_state hash;
+    crypto_generichash_init(&hash, nullptr, 0, sizeof key);
+    crypto_generichash_update(&hash, reinterpret_cast<const unsigned char *>(domain), sizeof domain - 1);
+    crypto_generichash_update(&hash, seed_le, sizeof seed_le);
+    crypto_generichash_final(&hash, key, sizeof key);
+
+    const size_t per_item = PASSWORD_LEN + 2 * IDENTITY_LEN;
+    std::vector<unsigned char> bytes(n * per_item);
+    randombytes_buf_deterministic(bytes.data(), bytes.size(), key);
+
+    KatInputs inputs;
+    inputs.passwords.resize(n);
+    inputs.P_i.resize(n);
+    inputs.P_j.resize(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        const unsigned char *item = &bytes[i * per_item];
+        // The modulo bias of the charset does not matter for known answers
+        for (size_t c = 0; c < PASSWORD_LEN; c++)
+            inputs.passwords[i] += charset[item[c] % (sizeof charset - 1)];
+        std::copy(item + PASSWORD_LEN, item + PASSWORD_LEN + IDENTITY_LEN, inputs.P_i[i].begin());
+        std::copy(item + PASSWORD_LEN + IDENTITY_LEN, item + per_item, inputs.P_j[i].begin());
+    }
+    return inputs;
+}
+
+// Per-handshake microseconds of each phase of one run
+struct PhaseTimes
+{
+    double init = 0.0, rspder = 0.0, der = 0.0;
+};
+
+// Runs every handshake through Init, then every response, then every Der.
+// The initiator scalars come from stream 0 and the responder scalars from
+// stream 1 of the seed, each drawn in handshake order, so the sequential and
+// the batched responder see the same y for the same handshake.
+static PhaseTimes run_handshakes(const KatInputs &inputs, KatOutputs &out, uint64_t seed, bool batched)
+{
+    using clock = std::chrono::steady_clock;
+    const size_t n = inputs.passwords.size();
+    out.V.assign(n, {});
+    out.I.assign(n, {});
+    out.R.assign(n, {});
+    out.K_j.assign(n, {});
+    out.K_i.assign(n, {});
+    out.states = std::vector<protoss::State>(n);
+    PhaseTimes times;
+
+    protoss::drbg::seed_thread(seed, 0);
+    auto start = clock::now();
+    for (size_t i = 0; i < n; i++)
+    {
+        protoss::hash_to_point(out.V[i], inputs.passwords[i]);
+        if (protoss::TryInit(out.I[i], out.states[i], out.V[i], inputs.P_i[i], inputs.P_j[i]) != protoss::Status::Ok)
+            throw std::runtime_error("Init failed");
+    }
+    times.init = std::chrono::duration<double, std::micro>(clock::now() - start).count() / n;
+
+    protoss::drbg::seed_thread(seed, 1);
+    start = clock::now();
+    if (batched)
+    {
+        std::vector<protoss::RspDerRequest> requests(std::min(n, BATCH_SIZE));
+        std::vector<protoss::RspDerResponse> responses(requests.size());
+        for (size_t first = 0; first < n; first += BATCH_SIZE)
+        {
+            const size_t count = std::min(BATCH_SIZE, n - first);
+            for (size_t k = 0; k < count; k++)
+                requests[k] = {out.I[first + k], out.V[first + k], inputs.P_i[first + k], inputs.P_j[first + k]};
+            protoss::RspDerBatch(std::span(requests.data(), count), std::span(responses.data(), count));
+            for (size_t k = 0; k < count; k++)
+            {
+                if (responses[k].status != protoss::Status::Ok)
+                    throw std::runtime_error("RspDerBatch failed");
+                out.R[first + k] = responses[k].R;
+                out.K_j[first + k] = responses[k].K;
+            }
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < n; i++)
+            if (protoss::TryRspDer(out.R[i], out.K_j[i], out.V[i], inputs.P_i[i], inputs.P_j[i], out.I[i]) != protoss::Status::Ok)
+                throw std::runtime_error("RspDer failed");
+    }
+    times.rspder = std::chrono::duration<double, std::micro>(clock::now() - start).count() / n;
+
+    start = clock::now();
+    for (size_t i = 0; i < n; i++)
+        if (protoss::TryDer(out.K_i[i], out.states[i], out.R[i]) != protoss::Status::Ok)
+            throw std::runtime_error("Der failed");
+    times.der = std::chrono::duration<double, std::micro>(clock::now() - start).count() / n;
+
+    for (size_t i = 0; i < n; i++)
+        if (out.K_i[i] != out.K_j[i])
+            throw std::runtime_error("session keys don't match at handshake " + std::to_string(i));
+    return times;
+}
+
+static std::string to_hex(const unsigned char *data, size_t len)
+{
+    std::string hex(2 * len + 1, '\0');
+    sodium_bin2hex(hex.data(), hex.size(), data, len);
+    hex.pop_back();
+    return hex;
+}
+
+// One line per handshake: index, password, P_i, P_j, I, R and the session key
+static std::string transcript(const KatInputs &inputs, const KatOutputs &out, uint64_t seed)
+{
+    std::stringstream ss;
+    ss << "# Protoss known-answer transcript, seed " << seed << ", " << inputs.passwords.size() << " handshakes\n";
+    ss << "# index password P_i P_j I R K\n";
+    for (size_t i = 0; i < inputs.passwords.size(); i++)
+    {
+        ss << i << " " << inputs.passwords[i] << " " << to_hex(inputs.P_i[i].data(), IDENTITY_LEN) << " "
+           << to_hex(inputs.P_j[i].data(), IDENTITY_LEN) << " " << to_hex(out.I[i].data(), POINT_LEN) << " "
+           << to_hex(out.R[i].data(), POINT_LEN) << " " << to_hex(out.K_i[i].data(), SESSION_KEY_LEN) << "\n";
+    }
+    return ss.str();
+}
+
+static std::string digest(const std::string &text)
+{
+    unsigned char hash[crypto_generichash_BYTES];
+    crypto_generichash(hash, sizeof hash, reinterpret_cast<const unsigned char *>(text.data()), text.size(), nullptr, 0);
+    return to_hex(hash, sizeof hash);
+}
+
+// Returns the first line where the transcripts differ, or an empty string
+static std::string first_difference(const std::string &expected, const std::string &actual)
+{
+    std::istringstream a(expected), b(actual);
+    std::string line_a, line_b;
+    for (size_t line = 1;; line++)
+    {
+        bool more_a = (bool)std::getline(a, line_a), more_b = (bool)std::getline(b, line_b);
+        if (!more_a && !more_b)
+            return "";
+        if (more_a != more_b || line_a != line_b)
+            return "line " + std::to_string(line) + "\n  expected: " + (more_a ? line_a : "<end>") +
+                   "\n  actual:   " + (more_b ? line_b : "<end>");
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    if (sodium_init() < 0)
+    {
+        std::cerr << "Failed to initialize libsodium" << std::endl;
+        return 1;
+    }
+
+    // Parse optional CLI arguments: [handshakes] [num_runs] [seed] [--check FILE]
+    size_t handshakes = 10000;
+    int num_runs = 5;
+    uint64_t seed = 1;
+    std::string check_path;
+    std::vector<std::string> positional;
+    for (int a = 1; a < argc; a++)
+    {
+        std::string arg = argv[a];
+        if (arg == "--check" && a + 1 < argc)
+            check_path = argv[++a];
+        else
+            positional.push_back(arg);
+    }
+    bool valid = positional.size() <= 3;
+    if (positional.size() >= 1)
+        valid = valid && parse_count(positional[0].c_str(), handshakes);
+    if (positional.size() >= 2)
+        valid = valid && parse_count(positional[1].c_str(), num_runs);
+    if (positional.size() >= 3)
+        valid = valid && parse_count(positional[2].c_str(), seed, 0);
+    if (!valid)
+        return usage_error(argv[0], "[handshakes] [num_runs] [seed] [--check FILE]");
+
+    std::cout << "Protoss Known-Answer Benchmark" << std::endl;
+    std::cout << "==============================" << std::endl;
+
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(3);
+    std::string kat;
+
+    try
+    {
+        std::cout << "Generating " << handshakes << " handshake inputs from seed " << seed << "..." << std::endl;
+        const KatInputs inputs = make_inputs(seed, handshakes);
+
+        // The sequential engine defines the known answers; the batched engine
+        // and every later run must reproduce them byte for byte
+        std::cout << "Running the sequential and batched engines on identical work..." << std::endl;
+        KatOutputs out;
+        std::vector<double> times[2][3];
+        for (int run = 0; run < num_runs; run++)
+        {
+            for (int batched = 0; batched < 2; batched++)
+            {
+                PhaseTimes t = run_handshakes(inputs, out, seed, batched);
+                times[batched][0].push_back(t.init);
+                times[batched][1].push_back(t.rspder);
+                times[batched][2].push_back(t.der);
+
+                std::string text = transcript(inputs, out, seed);
+                if (kat.empty())
+                    kat = std::move(text);
+                else if (text != kat)
+                {
+                    std::cerr << "ERROR: " << (batched ? "batched" : "sequential") << " run " << run + 1
+                              << " diverges from the known answers at " << first_difference(kat, text) << std::endl;
+                    return 1;
+                }
+            }
+        }
+
+        ss << "Known-Answer Results with " << handshakes << " handshakes x " << num_runs << " runs, seed " << seed << "\n";
+        ss << "Transcript digest (BLAKE2b-256): " << digest(kat) << "\n";
+        ss << "Sequential and batched engines: identical transcripts in every run\n";
+        if (!check_path.empty())
+        {
+            std::ifstream file(check_path, std::ios::binary);
+            if (!file)
+            {
+                std::cerr << "ERROR: cannot read " << check_path << std::endl;
+                return 1;
+            }
+            std::stringstream contents;
+            contents << file.rdbuf();
+            // log_to_file ends the saved transcript with one more newline
+            std::string expected = contents.str();
+            while (!expected.empty() && (expected.back() == '\n' || expected.back() == '\r'))
+                expected.pop_back();
+            expected += '\n';
+            std::string difference = first_difference(expected, kat);
+            if (!difference.empty())
+            {
+                std::cerr << "ERROR: transcript differs from " << check_path << " at " << difference << std::endl;
+                return 1;
+            }
+            ss << "Matches reference transcript " << check_path << "\n";
+        }
+        ss << "-------------------------\n";
+        ss << "us per handshake:      Init                RspDer              Der\n";
+        const char *const engines[2] = {"sequential", "batched"};
+        for (int batched = 0; batched < 2; batched++)
+        {
+            ss << std::left << std::setw(12) << engines[batched] << std::right;
+            for (int phase = 0; phase < 3; phase++)
+            {
+                std::stringstream cell;
+                cell << std::fixed << std::setprecision(3) << calc_mean(times[batched][phase]) << " +/- "
+                     << calc_stddev(times[batched][phase]);
+                ss << std::setw(20) << cell.str();
+            }
+            ss << "\n";
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n"
+              << ss.str();
+
+    auto now = std::time(nullptr);
+    std::stringstream stamp;
+    stamp << std::put_time(std::localtime(&now), "%Y-%m-%d_%H-%M-%S");
+    std::string results_name = "kat_results_n" + std::to_string(handshakes) + "_" + stamp.str() + ".txt";
+    std::string transcript_name = "kat_transcript_seed" + std::to_string(seed) + "_n" + std::to_string(handshakes) + "_" + stamp.str() + ".txt";
+    Logger::get_instance().log_to_file(results_name, ss.str());
+    Logger::get_instance().log_to_file(transcript_name, kat);
+    std::cout << "\nKnown-answer results saved to benchmark_results/sodium/" << results_name << std::endl;
+    std::cout << "Transcript saved to benchmark_results/sodium/" << transcript_name << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,123 @@
+#ifndef LATENCY_HISTOGRAM_HPP
+#define LATENCY_HISTOGRAM_HPP
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Log-linear latency histogram in the style of HdrHistogram. Values (in
+// nanoseconds) below 2^SUB_BUCKET_BITS are counted exactly; larger values keep
+// their top SUB_BUCKET_BITS bits, so every bucket is narrower than 1/128 of
+// the values it holds. Recording is a bit scan and an increment, cheap enough
+// to do for every handshake phase inside the timed loops.
+class LatencyHistogram
+{
+public:
+    static constexpr unsigned SUB_BUCKET_BITS = 8;
+    static constexpr uint64_t SUB_BUCKET_COUNT = uint64_t(1) << SUB_BUCKET_BITS;
+    static constexpr uint64_t HALF_SUB_BUCKET_COUNT = SUB_BUCKET_COUNT / 2;
+
+    LatencyHistogram() : counts_(bucket_index(std::numeric_limits<uint64_t>::max()) + 1, 0) {}
+
+    void record(uint64_t value_ns)
+    {
+        counts_[bucket_index(value_ns)]++;
+        total_count_++;
+        total_ns_ += value_ns;
+        min_ns_ = std::min(min_ns_, value_ns);
+        max_ns_ = std::max(max_ns_, value_ns);
+    }
+
+    template <typename Rep, typename Period>
+    void record(std::chrono::duration<Rep, Period> elapsed)
+    {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+        record(ns > 0 ? uint64_t(ns) : 0);
+    }
+
+    void merge(const LatencyHistogram &other)
+    {
+        for (size_t i = 0; i < counts_.size(); i++)
+            counts_[i] += other.counts_[i];
+        total_count_ += other.total_count_;
+        total_ns_ += other.total_ns_;
+        min_ns_ = std::min(min_ns_, other.min_ns_);
+        max_ns_ = std::max(max_ns_, other.max_ns_);
+    }
+
+    uint64_t count() const { return total_count_; }
+    uint64_t min() const { return total_count_ ? min_ns_ : 0; }
+    uint64_t max() const { return max_ns_; }
+    double mean() const { return total_count_ ? double(total_ns_) / total_count_ : 0.0; }
+
+    // Smallest recorded value (to bucket precision) that `percentile`% of samples do not exceed
+    uint64_t value_at_percentile(double percentile) const
+    {
+        if (total_count_ == 0)
+            return 0;
+        double fraction = std::clamp(percentile, 0.0, 100.0) / 100.0;
+        uint64_t target = std::max<uint64_t>(1, uint64_t(fraction * total_count_ + 0.5));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < counts_.size(); i++)
+        {
+            seen += counts_[i];
+            if (seen >= target)
+                return std::min(bucket_highest(i), max_ns_);
+        }
+        return max_ns_;
+    }
+
+    // Writes one CSV row per non-empty bucket: label,from_ns,to_ns,count,cumulative_percentile
+    void write_csv(std::ostream &out, const std::string &label) const
+    {
+        uint64_t seen = 0;
+        for (size_t i = 0; i < counts_.size(); i++)
+        {
+            if (counts_[i] == 0)
+                continue;
+            seen += counts_[i];
+            out << label << ',' << bucket_lowest(i) << ',' << bucket_highest(i) << ',' << counts_[i] << ','
+                << (100.0 * seen / total_count_) << '\n';
+        }
+    }
+
+    static const char *csv_header() { return "phase,from_ns,to_ns,count,cumulative_percentile"; }
+
+private:
+    // Values below SUB_BUCKET_COUNT map to themselves; above, the top bits select
+    // one of HALF_SUB_BUCKET_COUNT buckets in each power-of-two range
+    static size_t bucket_index(uint64_t value)
+    {
+        unsigned shift = std::bit_width(value) > SUB_BUCKET_BITS ? std::bit_width(value) - SUB_BUCKET_BITS : 0;
+        return size_t(shift) * HALF_SUB_BUCKET_COUNT + size_t(value >> shift);
+    }
+
+    static unsigned bucket_shift(size_t index)
+    {
+        return index < SUB_BUCKET_COUNT ? 0 : unsigned(index / HALF_SUB_BUCKET_COUNT - 1);
+    }
+
+    static uint64_t bucket_lowest(size_t index)
+    {
+        unsigned shift = bucket_shift(index);
+        return uint64_t(index - size_t(shift) * HALF_SUB_BUCKET_COUNT) << shift;
+    }
+
+    static uint64_t bucket_highest(size_t index)
+    {
+        return bucket_lowest(index) + ((uint64_t(1) << bucket_shift(index)) - 1);
+    }
+
+    std::vector<uint64_t> counts_;
+    uint64_t total_count_ = 0;
+    uint64_t total_ns_ = 0;
+    uint64_t min_ns_ = std::numeric_limits<uint64_t>::max();
+    uint64_t max_ns_ = 0;
+};
+
+#endif // LATENCY_HISTOGRAM_HPP
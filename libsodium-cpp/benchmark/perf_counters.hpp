@@ -0,0 +1,125 @@
+#ifndef PERF_COUNTERS_HPP
+#define PERF_COUNTERS_HPP
+
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Hardware counters of the calling thread through Linux perf_event_open,
+// opened as one group so all events cover exactly the same instructions.
+// Only user-space events are counted, which works with the default
+// perf_event_paranoid setting of 2. When the kernel refuses (containers,
+// paranoid 3, no PMU) or on other platforms, available() is false and error()
+// says why.
+class PerfCounters
+{
+public:
+    enum Event
+    {
+        Cycles,
+        Instructions,
+        CacheMisses,
+        BranchMisses,
+        EventCount
+    };
+    using Values = std::array<uint64_t, EventCount>;
+
+    PerfCounters()
+    {
+#if defined(__linux__)
+        const uint64_t configs[EventCount] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                              PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+        for (int e = 0; e < EventCount; e++)
+        {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof attr);
+            attr.size = sizeof attr;
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = configs[e];
+            attr.disabled = (e == 0);
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP;
+            int fd = int(syscall(SYS_perf_event_open, &attr, 0, -1, e == 0 ? -1 : fds_[0], 0));
+            if (fd < 0)
+            {
+                error_ = std::string("perf_event_open failed: ") + std::strerror(errno) +
+                         " (see /proc/sys/kernel/perf_event_paranoid)";
+                close_all();
+                return;
+            }
+            fds_[e] = fd;
+        }
+#else
+        error_ = "hardware counters need Linux perf_event_open";
+#endif
+    }
+
+    ~PerfCounters() { close_all(); }
+
+    PerfCounters(const PerfCounters &) = delete;
+    PerfCounters &operator=(const PerfCounters &) = delete;
+
+    bool available() const { return fds_[0] >= 0; }
+    const std::string &error() const { return error_; }
+
+    static const char *event_name(Event e)
+    {
+        static const char *const names[EventCount] = {"cycles", "instructions", "cache-misses", "branch-misses"};
+        return names[e];
+    }
+
+    // Zeroes and starts the group
+    void start()
+    {
+#if defined(__linux__)
+        if (!available())
+            return;
+        ioctl(fds_[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(fds_[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+    }
+
+    // Stops the group and returns the counts since start()
+    Values stop()
+    {
+        Values values{};
+#if defined(__linux__)
+        if (!available())
+            return values;
+        ioctl(fds_[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        uint64_t buf[1 + EventCount] = {};
+        if (read(fds_[0], buf, sizeof buf) == ssize_t(sizeof buf) && buf[0] == EventCount)
+            for (int e = 0; e < EventCount; e++)
+                values[e] = buf[1 + e];
+#endif
+        return values;
+    }
+
+private:
+    void close_all()
+    {
+#if defined(__linux__)
+        for (int &fd : fds_)
+        {
+            if (fd >= 0)
+                close(fd);
+            fd = -1;
+        }
+#endif
+    }
+
+    int fds_[EventCount] = {-1, -1, -1, -1};
+    std::string error_;
+};
+
+#endif // PERF_COUNTERS_HPP
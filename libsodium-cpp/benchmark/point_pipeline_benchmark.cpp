@@ -0,0 +1,347 @@
+#include <sodium.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "benchmark_args.hpp"
+#include "latency_histogram.hpp"
+#include "logger.hpp"
+#include "protoss_protocol.hpp"
+#include "ristretto255.hpp"
+#include "transcript_hasher.hpp"
+
+// The protocol steps as they were before the fused pipeline: one libsodium
+// call per group operation, each decoding its inputs and encoding its result.
+namespace per_op
+{
+    void Init(protoss::Point &I, protoss::State &state, const protoss::Point &V, protoss::Bytes P_i, protoss::Bytes P_j,
+              const protoss::Scalar &x)
+    {
+        protoss::Point X;
+        state.x = x;
+        state.V = V;
+        if (crypto_scalarmult_ristretto255_base(X.data(), x.data()) != 0)
+            throw std::runtime_error("crypto_scalarmult_ristretto255_base failed");
+        if (crypto_core_ristretto255_add(I.data(), X.data(), V.data()) != 0)
+            throw std::runtime_error("crypto_core_ristretto255_add failed");
+        state.I = I;
+        state.P_i = P_i;
+        state.P_j = P_j;
+    }
+
+    void RspDer(protoss::Point &R, protoss::SessionKey &K, const protoss::Point &V, protoss::Bytes P_i, protoss::Bytes P_j,
+                const protoss::Point &I, const protoss::Scalar &y)
+    {
+        protoss::Point Y, X_prime, Z;
+        if (crypto_scalarmult_ristretto255_base(Y.data(), y.data()) != 0)
+            throw std::runtime_error("crypto_scalarmult_ristretto255_base failed");
+        if (crypto_core_ristretto255_add(R.data(), Y.data(), V.data()) != 0)
+            throw std::runtime_error("crypto_core_ristretto255_add failed");
+        if (crypto_core_ristretto255_sub(X_prime.data(), I.data(), V.data()) != 0)
+            throw std::runtime_error("crypto_core_ristretto255_sub failed");
+        if (crypto_scalarmult_ristretto255(Z.data(), y.data(), X_prime.data()) != 0)
+            throw std::runtime_error("crypto_scalarmult_ristretto255 failed");
+        protoss::derive_session_key(K, Z, I, R, P_i, P_j, V);
+        sodium_memzero(Z.data(), Z.size());
+    }
+
+    void Der(protoss::SessionKey &K, const protoss::State &state, const protoss::Point &R)
+    {
+        protoss::Point Y_prime, Z;
+        if (crypto_core_ristretto255_sub(Y_prime.data(), R.data(), state.V.data()) != 0)
+            throw std::runtime_error("crypto_core_ristretto255_sub failed");
+        if (crypto_scalarmult_ristretto255(Z.data(), state.x.data(), Y_prime.data()) != 0)
+            throw std::runtime_error("crypto_scalarmult_ristretto255 failed");
+        protoss::derive_session_key(K, Z, state.I, R, state.P_i, state.P_j, state.V);
+        sodium_memzero(Z.data(), Z.size());
+    }
+}
+
+// Per-call latency of the three protocol steps
+struct PhaseLatency
+{
+    LatencyHistogram init, rspder, der;
+};
+
+// Checks the vendored group against libsodium and the fused steps against the
+// per-op steps on the same inputs; returns the number of mismatches
+static int cross_check(int trials, const protoss::Point &V)
+{
+    const unsigned char P_i[] = {0x00};
+    const unsigned char P_j[] = {0x01};
+    int mismatches = 0;
+
+    for (int t = 0; t < trials; t++)
+    {
+        // Primitives: base and variable-base multiplication, add, sub, encode/decode
+        protoss::Scalar k;
+        protoss::Point P, Q, expected, actual;
+        crypto_core_ristretto255_scalar_random(k.data());
+        crypto_core_ristretto255_random(P.data());
+        crypto_core_ristretto255_random(Q.data());
+        protoss::ristretto255::GroupElement p, q, r;
+        if (!protoss::ristretto255::decode(p, P) || !protoss::ristretto255::decode(q, Q))
+        {
+            mismatches++;
+            continue;
+        }
+
+        crypto_scalarmult_ristretto255_base(expected.data(), k.data());
+        protoss::ristretto255::scalarmult_base(r, k);
+        protoss::ristretto255::encode(actual, r);
+        mismatches += expected != actual;
+
+        mismatches += crypto_scalarmult_ristretto255(expected.data(), k.data(), P.data()) != 0;
+        protoss::ristretto255::scalarmult(r, k, p);
+        protoss::ristretto255::encode(actual, r);
+        mismatches += expected != actual;
+
+        crypto_core_ristretto255_add(expected.data(), P.data(), Q.data());
+        protoss::ristretto255::add(r, p, q);
+        protoss::ristretto255::encode(actual, r);
+        mismatches += expected != actual;
+
+        crypto_core_ristretto255_sub(expected.data(), P.data(), Q.data());
+        protoss::ristretto255::sub(r, p, q);
+        protoss::ristretto255::encode(actual, r);
+        mismatches += expected != actual;
+
+        // Validity of arbitrary bytes (bit 255 cleared, which libsodium 1.0.18 ignores)
+        protoss::Point random_bytes;
+        randombytes_buf(random_bytes.data(), random_bytes.size());
+        random_bytes[31] &= 0x7f;
+        mismatches += (crypto_core_ristretto255_is_valid_point(random_bytes.data()) == 1) !=
+                      protoss::ristretto255::decode(r, random_bytes);
+
+        // Protocol steps on identical ephemerals
+        protoss::Ephemeral x, y;
+        protoss::generate_ephemeral(x);
+        protoss::generate_ephemeral(y);
+        protoss::Scalar x_s = x.s, y_s = y.s;
+        protoss::Point I_fused, I_ref, R_fused, R_ref;
+        protoss::State state_fused, state_ref;
+        protoss::SessionKey K_fused, K_ref, K_i_fused, K_i_ref;
+
+        protoss::Init(I_fused, state_fused, V, P_i, P_j, x);
+        per_op::Init(I_ref, state_ref, V, P_i, P_j, x_s);
+        protoss::RspDer(R_fused, K_fused, V, P_i, P_j, I_fused, y);
+        per_op::RspDer(R_ref, K_ref, V, P_i, P_j, I_ref, y_s);
+        protoss::Der(K_i_fused, state_fused, R_fused);
+        per_op::Der(K_i_ref, state_ref, R_ref);
+        mismatches += (I_fused != I_ref) + (R_fused != R_ref) + (K_fused != K_ref) + (K_i_fused != K_i_ref) + (K_i_fused != K_fused);
+        sodium_memzero(x_s.data(), x_s.size());
+        sodium_memzero(y_s.data(), y_s.size());
+    }
+    return mismatches;
+}
+
+static void run_per_op(int handshakes, const protoss::Point &V, PhaseLatency &latency)
+{
+    const unsigned char P_i[] = {0x00};
+    const unsigned char P_j[] = {0x01};
+    protoss::Point I, R;
+    protoss::State state;
+    protoss::SessionKey K_i, K_j;
+    protoss::Scalar x, y;
+
+    for (int i = 0; i < handshakes; i++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        crypto_core_ristretto255_scalar_random(x.data());
+        per_op::Init(I, state, V, P_i, P_j, x);
+        auto end = std::chrono::steady_clock::now();
+        latency.init.record(end - start);
+
+        start = std::chrono::steady_clock::now();
+        crypto_core_ristretto255_scalar_random(y.data());
+        per_op::RspDer(R, K_j, V, P_i, P_j, I, y);
+        end = std::chrono::steady_clock::now();
+        latency.rspder.record(end - start);
+
+        start = std::chrono::steady_clock::now();
+        per_op::Der(K_i, state, R);
+        end = std::chrono::steady_clock::now();
+        latency.der.record(end - start);
+
+        if (K_i != K_j)
+            throw std::runtime_error("session keys don't match");
+    }
+    sodium_memzero(x.data(), x.size());
+    sodium_memzero(y.data(), y.size());
+}
+
+static void run_fused(int handshakes, const protoss::Point &V, PhaseLatency &latency)
+{
+    const unsigned char P_i[] = {0x00};
+    const unsigned char P_j[] = {0x01};
+    protoss::Point I, R;
+    protoss::State state;
+    protoss::SessionKey K_i, K_j;
+
+    for (int i = 0; i < handshakes; i++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        protoss::Init(I, state, V, P_i, P_j);
+        auto end = std::chrono::steady_clock::now();
+        latency.init.record(end - start);
+
+        start = std::chrono::steady_clock::now();
+        protoss::RspDer(R, K_j, V, P_i, P_j, I);
+        end = std::chrono::steady_clock::now();
+        latency.rspder.record(end - start);
+
+        start = std::chrono::steady_clock::now();
+        protoss::Der(K_i, state, R);
+        end = std::chrono::steady_clock::now();
+        latency.der.record(end - start);
+
+        if (K_i != K_j)
+            throw std::runtime_error("session keys don't match");
+    }
+}
+
+// Mean time per call in microseconds
+template <typename Fn>
+static double time_call(int calls, Fn &&fn)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < calls; i++)
+        fn();
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / calls;
+}
+
+static void write_row(std::stringstream &ss, const char *name, int per_op_codecs, int fused_codecs,
+                      const LatencyHistogram &per_op_hist, const LatencyHistogram &fused_hist)
+{
+    double saved = per_op_hist.mean() - fused_hist.mean();
+    ss << std::left << std::setw(8) << name << std::right << std::setw(5) << per_op_codecs << " -> " << fused_codecs
+       << std::setw(12) << per_op_hist.mean() / 1000.0 << std::setw(10) << per_op_hist.value_at_percentile(99) / 1000.0
+       << std::setw(12) << fused_hist.mean() / 1000.0 << std::setw(10) << fused_hist.value_at_percentile(99) / 1000.0
+       << std::setw(10) << saved / 1000.0 << " (" << (saved / per_op_hist.mean() * 100) << "%)\n";
+}
+
+int main(int argc, char *argv[])
+{
+    if (sodium_init() < 0)
+    {
+        std::cerr << "Failed to initialize libsodium" << std::endl;
+        return 1;
+    }
+
+    // Parse optional CLI arguments: [iterations] [num_runs]
+    int iterations = 5000;
+    int num_runs = 4;
+    bool valid = argc <= 3;
+    if (argc >= 2)
+        valid = valid && parse_count(argv[1], iterations);
+    if (argc >= 3)
+        valid = valid && parse_count(argv[2], num_runs);
+    if (!valid)
+        return usage_error(argv[0], "[iterations] [num_runs]");
+
+    std::cout << "Protoss Point Pipeline Benchmark" << std::endl;
+    std::cout << "================================" << std::endl;
+
+    protoss::Point V;
+    protoss::hash_to_point(V, "SharedPassword");
+
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(3);
+
+    try
+    {
+        const int trials = 1000;
+        std::cout << "Cross-checking the fused pipeline against libsodium (" << trials << " trials)..." << std::endl;
+        int mismatches = cross_check(trials, V);
+        if (mismatches != 0)
+        {
+            std::cerr << "ERROR: " << mismatches << " mismatches between the fused pipeline and libsodium" << std::endl;
+            return 1;
+        }
+
+        std::cout << "Timing primitives..." << std::endl;
+        const int calls = std::max(1, iterations / 2);
+        protoss::Scalar k;
+        protoss::Point P, Q, out;
+        crypto_core_ristretto255_scalar_random(k.data());
+        crypto_core_ristretto255_random(P.data());
+        crypto_core_ristretto255_random(Q.data());
+        protoss::ristretto255::GroupElement p, q, r;
+        protoss::ristretto255::decode(p, P);
+        protoss::ristretto255::decode(q, Q);
+
+        double sodium_base = time_call(calls, [&]
+                                       { crypto_scalarmult_ristretto255_base(out.data(), k.data()); });
+        double sodium_mult = time_call(calls, [&]
+                                       { return crypto_scalarmult_ristretto255(out.data(), k.data(), P.data()); });
+        double sodium_add = time_call(calls, [&]
+                                      { crypto_core_ristretto255_add(out.data(), P.data(), Q.data()); });
+        double fused_base = time_call(calls, [&]
+                                      { protoss::ristretto255::scalarmult_base(r, k); });
+        double fused_mult = time_call(calls, [&]
+                                      { protoss::ristretto255::scalarmult(r, k, p); });
+        double fused_add = time_call(calls, [&]
+                                     { protoss::ristretto255::add(r, p, q); });
+        double decode = time_call(calls, [&]
+                                  { protoss::ristretto255::decode(r, P); });
+        double encode = time_call(calls, [&]
+                                  { protoss::ristretto255::encode(out, p); });
+        sodium_memzero(k.data(), k.size());
+
+        std::cout << "Measuring protocol steps (" << num_runs << " runs x " << iterations << " handshakes)..." << std::endl;
+        PhaseLatency per_op_latency, fused_latency;
+        run_per_op(200, V, per_op_latency);
+        run_fused(200, V, fused_latency);
+        per_op_latency = PhaseLatency{};
+        fused_latency = PhaseLatency{};
+        for (int run = 0; run < num_runs; run++)
+        {
+            // Alternate the order between runs to avoid ordering bias
+            if (run % 2 == 0)
+                run_per_op(iterations, V, per_op_latency), run_fused(iterations, V, fused_latency);
+            else
+                run_fused(iterations, V, fused_latency), run_per_op(iterations, V, per_op_latency);
+        }
+
+        ss << "Point Pipeline Results with " << iterations << " handshakes x " << num_runs << " runs\n";
+        ss << "Cross-check: " << trials << " trials, 0 mismatches against libsodium\n";
+        ss << "-------------------------\n";
+        ss << "Primitives (us per call)          libsodium   vendored\n";
+        ss << "scalarmult_base (+ encode)      " << std::setw(11) << sodium_base << std::setw(11) << fused_base + encode << "\n";
+        ss << "scalarmult (+ decode, encode)   " << std::setw(11) << sodium_mult << std::setw(11) << fused_mult + decode + encode << "\n";
+        ss << "add (+ 2 decodes, encode)       " << std::setw(11) << sodium_add << std::setw(11) << fused_add + 2 * decode + encode << "\n";
+        ss << "decode / encode alone           " << std::setw(11) << "-" << std::setw(6) << decode << " / " << encode << "\n";
+        ss << "add alone, extended coordinates " << std::setw(11) << "-" << std::setw(11) << fused_add << "\n";
+        ss << "-------------------------\n";
+        ss << "Per call (us); codecs = encodings + decodings, each an inverse square root\n";
+        ss << "Phase   codecs     per-op mean       p99  fused mean       p99     saved\n";
+        write_row(ss, "Init", 4, 2, per_op_latency.init, fused_latency.init);
+        write_row(ss, "RspDer", 9, 4, per_op_latency.rspder, fused_latency.rspder);
+        write_row(ss, "Der", 5, 3, per_op_latency.der, fused_latency.der);
+        double per_op_total = per_op_latency.init.mean() + per_op_latency.rspder.mean() + per_op_latency.der.mean();
+        double fused_total = fused_latency.init.mean() + fused_latency.rspder.mean() + fused_latency.der.mean();
+        ss << "Handshake: " << per_op_total / 1000.0 << " -> " << fused_total / 1000.0 << " us ("
+           << (per_op_total / fused_total) << "x)\n";
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n"
+              << ss.str();
+
+    auto now = std::time(nullptr);
+    std::stringstream filename;
+    filename << "point_pipeline_results_it" << iterations << "_" << std::put_time(std::localtime(&now), "%Y-%m-%d_%H-%M-%S") << ".txt";
+    Logger::get_instance().log_to_file(filename.str(), ss.str());
+    std::cout << "\nPoint pipeline results saved to benchmark_results/sodium/" << filename.str() << std::endl;
+
+    return 0;
+}
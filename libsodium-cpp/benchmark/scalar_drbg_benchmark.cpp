@@ -0,0 +1,255 @@
+#include <sodium.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "benchmark_args.hpp"
+#include "benchmark_stats.hpp"
+#include "logger.hpp"
+#include "protoss_protocol.hpp"
+#include "scalar_drbg.hpp"
+
+#ifndef _WIN32
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+// Keeps the scalars observable, so the compiler cannot elide them
+static volatile unsigned char g_sink;
+
+// Runs `work(per_thread)` on `threads` threads at once and returns the total
+// rate in operations per second
+template <typename Work>
+static double run_threads(unsigned threads, size_t per_thread, Work work)
+{
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned t = 0; t < threads; t++)
+        workers.emplace_back([&work, per_thread] { work(per_thread); });
+    for (auto &worker : workers)
+        worker.join();
+    return threads * per_thread / std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void draw_scalars(size_t count)
+{
+    protoss::Scalar s;
+    unsigned char sink = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        protoss::drbg::random_scalar(s);
+        sink ^= s[0];
+    }
+    g_sink = sink;
+}
+
+static void run_handshakes(size_t count)
+{
+    const std::string password = "SharedPassword";
+    const std::vector<unsigned char> P_i = {0x00}, P_j = {0x01};
+    protoss::Point V;
+    protoss::hash_to_point(V, password);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        protoss::Point I, R;
+        protoss::State state;
+        protoss::SessionKey K_i, K_j;
+        if (protoss::TryInit(I, state, V, P_i, P_j) != protoss::Status::Ok ||
+            protoss::TryRspDer(R, K_j, V, P_i, P_j, I) != protoss::Status::Ok ||
+            protoss::TryDer(K_i, state, R) != protoss::Status::Ok || K_i != K_j)
+            throw std::runtime_error("session keys don't match");
+    }
+}
+
+#ifndef _WIN32
+// Forks with output still buffered, and checks that parent and child then
+// draw different scalars. Returns the number of failures.
+static int fork_check()
+{
+    protoss::Scalar s;
+    protoss::drbg::random_scalar(s); // Leaves the rest of a buffer behind
+
+    int fds[2];
+    if (pipe(fds) != 0)
+        return 1;
+    pid_t pid = fork();
+    if (pid < 0)
+        return 1;
+    if (pid == 0)
+    {
+        protoss::drbg::random_scalar(s);
+        bool written = write(fds[1], s.data(), s.size()) == (ssize_t)s.size();
+        _exit(written ? 0 : 1);
+    }
+    close(fds[1]);
+    protoss::Scalar parent, child;
+    protoss::drbg::random_scalar(parent);
+    bool received = read(fds[0], child.data(), child.size()) == (ssize_t)child.size();
+    close(fds[0]);
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return !received || !WIFEXITED(status) || WEXITSTATUS(status) != 0 || parent == child;
+}
+#endif
+
+// Checks that the DRBG hands out non-zero scalars without repeats, that
+// threads, reseeds and forks do not replay output, and that handshakes agree
+// on keys under both sources. Returns the number of failures.
+static int functional_check()
+{
+    using protoss::drbg::Source;
+    int failures = 0;
+
+    protoss::drbg::set_active_source(Source::Drbg);
+    std::vector<protoss::Scalar> scalars(20000);
+    protoss::drbg::random_scalars(scalars.data(), scalars.size() / 2);
+    protoss::drbg::reseed();
+    std::thread other([&] { protoss::drbg::random_scalars(scalars.data() + scalars.size() / 2, scalars.size() / 2); });
+    other.join();
+    for (const auto &s : scalars)
+        failures += sodium_is_zero(s.data(), s.size());
+    std::sort(scalars.begin(), scalars.end());
+    failures += std::adjacent_find(scalars.begin(), scalars.end()) != scalars.end();
+#ifndef _WIN32
+    failures += fork_check();
+#endif
+
+    for (Source source : {Source::Drbg, Source::System})
+    {
+        protoss::drbg::set_active_source(source);
+        try
+        {
+            run_handshakes(100);
+        }
+        catch (const std::exception &)
+        {
+            failures++;
+        }
+    }
+    protoss::drbg::set_active_source(Source::Drbg);
+    return failures;
+}
+
+int main(int argc, char *argv[])
+{
+    if (sodium_init() < 0)
+    {
+        std::cerr << "Failed to initialize libsodium" << std::endl;
+        return 1;
+    }
+
+    // Parse optional CLI arguments: [iterations] [num_runs] [threads]
+    int iterations = 1000000;
+    int num_runs = 5;
+    unsigned threads = 32;
+    bool valid = argc <= 4;
+    if (argc >= 2)
+        valid = valid && parse_count(argv[1], iterations);
+    if (argc >= 3)
+        valid = valid && parse_count(argv[2], num_runs);
+    if (argc >= 4)
+        valid = valid && parse_count(argv[3], threads);
+    if (!valid)
+        return usage_error(argv[0], "[iterations] [num_runs] [threads]");
+
+    using protoss::drbg::Source;
+    const Source sources[] = {Source::System, Source::Drbg};
+
+    std::cout << "Protoss Scalar DRBG Benchmark" << std::endl;
+    std::cout << "=============================" << std::endl;
+
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(2);
+
+    try
+    {
+        std::cout << "Checking scalar uniqueness and handshake keys under both sources..." << std::endl;
+        int failures = functional_check();
+        if (failures != 0)
+        {
+            std::cerr << "ERROR: " << failures << " scalar DRBG checks failed" << std::endl;
+            return 1;
+        }
+
+        ss << "Scalar DRBG Results with " << iterations << " scalars per thread x " << num_runs << " runs\n";
+        ss << "Hardware threads: " << std::thread::hardware_concurrency() << "\n";
+        ss << "DRBG: ChaCha20, " << protoss::drbg::BUFFER_BYTES << "-byte buffer, reseed every "
+           << protoss::drbg::RESEED_BYTES / 1024 << " KiB\n";
+        ss << "Functional check: non-zero unique scalars across threads, reseeds and forks, keys match under both sources\n";
+        ss << "-------------------------\n";
+
+        std::cout << "Measuring scalar generation on up to " << threads << " thread(s)..." << std::endl;
+        ss << "Random scalars, millions per second in total:\n";
+        ss << std::setw(12) << "threads";
+        for (Source source : sources)
+            ss << std::setw(20) << protoss::drbg::source_name(source);
+        ss << std::setw(12) << "speedup" << "\n";
+        for (unsigned t = 1; t <= threads; t *= 2)
+        {
+            ss << std::setw(12) << t;
+            double means[2];
+            for (size_t k = 0; k < 2; k++)
+            {
+                protoss::drbg::set_active_source(sources[k]);
+                std::vector<double> runs;
+                for (int run = 0; run < num_runs; run++)
+                    runs.push_back(run_threads(t, iterations / t, draw_scalars) / 1e6);
+                means[k] = calc_mean(runs);
+                std::stringstream cell;
+                cell << std::fixed << std::setprecision(2) << means[k] << " +/- " << calc_stddev(runs);
+                ss << std::setw(20) << cell.str();
+            }
+            ss << std::setw(11) << means[1] / means[0] << "x\n";
+        }
+        ss << "-------------------------\n";
+
+        // Full handshakes show what share of the protocol the scalar source is
+        std::cout << "Measuring handshakes at 1 and " << threads << " thread(s)..." << std::endl;
+        ss << "Init + RspDer + Der handshakes per second in total:\n";
+        const size_t handshakes = std::max(1, iterations / 100);
+        for (unsigned t : {1u, threads})
+        {
+            ss << std::setw(12) << t;
+            double means[2];
+            for (size_t k = 0; k < 2; k++)
+            {
+                protoss::drbg::set_active_source(sources[k]);
+                std::vector<double> runs;
+                for (int run = 0; run < num_runs; run++)
+                    runs.push_back(run_threads(t, std::max<size_t>(1, handshakes / t), run_handshakes));
+                means[k] = calc_mean(runs);
+                std::stringstream cell;
+                cell << std::fixed << std::setprecision(0) << means[k] << " +/- " << calc_stddev(runs);
+                ss << std::setw(20) << cell.str();
+            }
+            ss << std::setw(11) << means[1] / means[0] << "x\n";
+            if (threads == 1)
+                break;
+        }
+        protoss::drbg::set_active_source(Source::Drbg);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n"
+              << ss.str();
+
+    auto now = std::time(nullptr);
+    std::stringstream filename;
+    filename << "scalar_drbg_results_it" << iterations << "_" << std::put_time(std::localtime(&now), "%Y-%m-%d_%H-%M-%S") << ".txt";
+    Logger::get_instance().log_to_file(filename.str(), ss.str());
+    std::cout << "\nScalar DRBG results saved to benchmark_results/sodium/" << filename.str() << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,289 @@
+#include <sodium.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "benchmark_args.hpp"
+#include "benchmark_stats.hpp"
+#include "logger.hpp"
+#include "protoss_protocol.hpp"
+#include "secure_arena.hpp"
+
+// Keeps the allocations observable, so the compiler cannot elide them
+static volatile uintptr_t g_sink;
+
+// The ways of holding a 32-byte secret that are compared
+enum class Holder
+{
+    Heap,         // new/delete, never wiped, as the vector API did
+    HeapWiped,    // new, sodium_memzero, delete
+    SodiumMalloc, // sodium_malloc/sodium_free per secret
+    Arena         // protoss::Secure<Scalar>
+};
+
+static const char *holder_name(Holder holder)
+{
+    switch (holder)
+    {
+    case Holder::Heap:
+        return "heap";
+    case Holder::HeapWiped:
+        return "heap + wipe";
+    case Holder::SodiumMalloc:
+        return "sodium_malloc";
+    case Holder::Arena:
+        return "secure arena";
+    }
+    return "?";
+}
+
+// Allocates `live` secrets, writes each, then frees them all, `rounds` times;
+// live = 1 is the allocate-use-free pattern of a single handshake step, larger
+// values a burst of handshakes in flight. Returns ns per secret.
+static double run_holder(Holder holder, size_t live, size_t rounds)
+{
+    uintptr_t sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    switch (holder)
+    {
+    case Holder::Heap:
+    case Holder::HeapWiped:
+    {
+        std::vector<protoss::Scalar *> secrets(live);
+        for (size_t r = 0; r < rounds; r++)
+        {
+            for (size_t i = 0; i < live; i++)
+            {
+                secrets[i] = new protoss::Scalar();
+                (*secrets[i])[0] = (unsigned char)i;
+                sink ^= (uintptr_t)secrets[i];
+            }
+            for (size_t i = 0; i < live; i++)
+            {
+                if (holder == Holder::HeapWiped)
+                    sodium_memzero(secrets[i]->data(), secrets[i]->size());
+                delete secrets[i];
+            }
+        }
+        break;
+    }
+    case Holder::SodiumMalloc:
+    {
+        std::vector<unsigned char *> secrets(live);
+        for (size_t r = 0; r < rounds; r++)
+        {
+            for (size_t i = 0; i < live; i++)
+            {
+                secrets[i] = (unsigned char *)sodium_malloc(SCALAR_LEN);
+                if (!secrets[i])
+                    throw std::bad_alloc();
+                secrets[i][0] = (unsigned char)i;
+                sink ^= (uintptr_t)secrets[i];
+            }
+            for (size_t i = 0; i < live; i++)
+                sodium_free(secrets[i]);
+        }
+        break;
+    }
+    case Holder::Arena:
+    {
+        std::vector<protoss::Secure<protoss::Scalar>> secrets;
+        secrets.reserve(live);
+        for (size_t r = 0; r < rounds; r++)
+        {
+            for (size_t i = 0; i < live; i++)
+            {
+                secrets.emplace_back();
+                (*secrets.back())[0] = (unsigned char)i;
+                sink ^= (uintptr_t)secrets.back().get();
+            }
+            secrets.clear();
+        }
+        break;
+    }
+    }
+    auto end = std::chrono::steady_clock::now();
+    g_sink = sink;
+    return std::chrono::duration<double, std::nano>(end - start).count() / (live * rounds);
+}
+
+// Secure<Scalar> pairs on `threads` threads at once; returns millions of
+// secrets per second in total
+static double run_arena_threads(unsigned threads, size_t per_thread)
+{
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned t = 0; t < threads; t++)
+        workers.emplace_back([per_thread] {
+            uintptr_t sink = 0;
+            for (size_t i = 0; i < per_thread; i++)
+            {
+                protoss::Secure<protoss::Scalar> secret;
+                (*secret)[0] = (unsigned char)i;
+                sink ^= (uintptr_t)secret.get();
+            }
+            g_sink = sink;
+        });
+    for (auto &worker : workers)
+        worker.join();
+    return threads * per_thread / std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Checks that slots come out zeroed, are not handed out twice while alive,
+// and are wiped on release. Returns the number of failures.
+static int functional_check()
+{
+    int failures = 0;
+    std::vector<protoss::Secure<protoss::Scalar>> scalars;
+    std::vector<protoss::Secure<std::array<unsigned char, 64>>> digests;
+    std::vector<unsigned char *> seen;
+    for (int i = 0; i < 5000; i++)
+    {
+        scalars.emplace_back();
+        digests.emplace_back();
+        failures += !sodium_is_zero(scalars.back()->data(), SCALAR_LEN) || !sodium_is_zero(digests.back()->data(), 64);
+        scalars.back()->fill(0xff);
+        digests.back()->fill(0xff);
+        seen.push_back(scalars.back()->data());
+        seen.push_back(digests.back()->data());
+    }
+    std::sort(seen.begin(), seen.end());
+    failures += std::adjacent_find(seen.begin(), seen.end()) != seen.end();
+
+    // A released slot must read as zero, through the arena's own pointer
+    unsigned char *slot = scalars.back()->data();
+    scalars.pop_back();
+    failures += !sodium_is_zero(slot, SCALAR_LEN);
+    scalars.clear();
+    digests.clear();
+
+    protoss::SecureBytes bytes(SCALAR_LEN, 0xaa), large(4096, 0xbb);
+    failures += bytes.size() != SCALAR_LEN || large[4095] != 0xbb;
+    return failures;
+}
+
+int main(int argc, char *argv[])
+{
+    if (sodium_init() < 0)
+    {
+        std::cerr << "Failed to initialize libsodium" << std::endl;
+        return 1;
+    }
+
+    // Parse optional CLI arguments: [iterations] [num_runs] [threads]
+    int iterations = 1000000;
+    int num_runs = 5;
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    bool valid = argc <= 4;
+    if (argc >= 2)
+        valid = valid && parse_count(argv[1], iterations);
+    if (argc >= 3)
+        valid = valid && parse_count(argv[2], num_runs);
+    if (argc >= 4)
+        valid = valid && parse_count(argv[3], threads);
+    if (!valid)
+        return usage_error(argv[0], "[iterations] [num_runs] [threads]");
+
+    std::cout << "Protoss Secure Arena Benchmark" << std::endl;
+    std::cout << "==============================" << std::endl;
+
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(1);
+
+    try
+    {
+        std::cout << "Checking slot zeroing, uniqueness and wiping..." << std::endl;
+        int failures = functional_check();
+        if (failures != 0)
+        {
+            std::cerr << "ERROR: " << failures << " secure arena checks failed" << std::endl;
+            return 1;
+        }
+
+        ss << "Secure Arena Results with " << iterations << " secrets x " << num_runs << " runs\n";
+        ss << "Functional check: slots zeroed on acquire, unique while alive, wiped on release\n";
+        ss << "-------------------------\n";
+        ss << "ns per 32-byte secret (allocate, write, free) by secrets alive at once:\n";
+        ss << std::setw(16) << "live";
+        const Holder holders[] = {Holder::Heap, Holder::HeapWiped, Holder::SodiumMalloc, Holder::Arena};
+        for (Holder holder : holders)
+            ss << std::setw(20) << holder_name(holder);
+        ss << "\n";
+
+        std::cout << "Measuring allocate/free cost per holder..." << std::endl;
+        for (size_t live : {size_t(1), size_t(64), size_t(1024)})
+        {
+            ss << std::setw(16) << live;
+            for (Holder holder : holders)
+            {
+                // sodium_malloc maps pages per call; give it a tenth of the work
+                size_t secrets = holder == Holder::SodiumMalloc ? iterations / 10 : iterations;
+                size_t rounds = std::max<size_t>(1, secrets / live);
+                std::vector<double> runs;
+                for (int run = 0; run < num_runs; run++)
+                    runs.push_back(run_holder(holder, live, rounds));
+                std::stringstream cell;
+                cell << std::fixed << std::setprecision(1) << calc_mean(runs) << " +/- " << calc_stddev(runs);
+                ss << std::setw(20) << cell.str();
+            }
+            ss << "\n";
+        }
+        ss << "-------------------------\n";
+
+        std::cout << "Measuring arena throughput on up to " << threads << " thread(s)..." << std::endl;
+        ss << "Secure<Scalar> allocate/free pairs, millions per second:\n";
+        for (unsigned t = 1; t <= threads; t *= 2)
+        {
+            std::vector<double> runs;
+            for (int run = 0; run < num_runs; run++)
+                runs.push_back(run_arena_threads(t, iterations));
+            ss << "Threads " << std::setw(3) << t << ": " << std::setw(8) << calc_mean(runs) << " +/- " << calc_stddev(runs) << "\n";
+        }
+        ss << "-------------------------\n";
+
+        // The vector API and the batched paths now draw their secrets from the arena
+        std::cout << "Measuring handshakes through the arena-backed paths..." << std::endl;
+        std::string password = "SharedPassword";
+        std::vector<unsigned char> P_i = {0x00}, P_j = {0x01};
+        const int handshakes = std::max(1, iterations / 1000);
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < handshakes; i++)
+        {
+            ReturnTypeInit res_init = Init(password, P_i, P_j);
+            ReturnTypeRspDer res_rspDer = RspDer(password, P_i, P_j, res_init.I);
+            if (Der(password, res_init.protoss_state, res_rspDer.R) != res_rspDer.getSessionKey())
+                throw std::runtime_error("session keys don't match");
+        }
+        const double handshake_us =
+            std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / handshakes;
+
+        protoss::SecureArena::Stats stats = protoss::SecureArena::instance().stats();
+        ss << "Vector API handshake with x and K in the arena: " << handshake_us << " us\n";
+        ss << "Arena: " << stats.slabs << " slabs, " << stats.locked_bytes / 1024 << " KiB locked\n";
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n"
+              << ss.str();
+
+    auto now = std::time(nullptr);
+    std::stringstream filename;
+    filename << "secure_arena_results_it" << iterations << "_" << std::put_time(std::localtime(&now), "%Y-%m-%d_%H-%M-%S") << ".txt";
+    Logger::get_instance().log_to_file(filename.str(), ss.str());
+    std::cout << "\nSecure arena results saved to benchmark_results/sodium/" << filename.str() << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,336 @@
+#include <sodium.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "benchmark_args.hpp"
+#include "benchmark_stats.hpp"
+#include "logger.hpp"
+#include "protoss_protocol.hpp"
+#include "session_table.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <unistd.h>
+#endif
+
+using protoss::SessionTable;
+using Clock = SessionTable::Clock;
+
+// Returns the resident set size of this process in KiB, or 0 if unavailable
+static size_t current_rss_kib()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return 0;
+    return counters.WorkingSetSize / 1024;
+#else
+    std::ifstream statm("/proc/self/statm");
+    size_t total_pages = 0, resident_pages = 0;
+    if (!(statm >> total_pages >> resident_pages))
+        return 0;
+    return resident_pages * (size_t)sysconf(_SC_PAGESIZE) / 1024;
+#endif
+}
+
+// Session IDs as a server would hand them out: random and nonzero
+static std::vector<protoss::SessionId> make_ids(size_t n)
+{
+    std::vector<protoss::SessionId> ids(n);
+    randombytes_buf(ids.data(), n * sizeof(protoss::SessionId));
+    for (auto &id : ids)
+        id |= 1;
+    return ids;
+}
+
+// Runs real handshakes with the initiator state parked in the table between
+// Init and Der, checks the keys agree, then checks expiry on both paths: a
+// lookup past the deadline and the timing wheel. Returns the number of
+// failures.
+static int functional_check(size_t handshakes)
+{
+    int failures = 0;
+    std::vector<protoss::Point> identities(16);
+    for (auto &identity : identities)
+        randombytes_buf(identity.data(), identity.size());
+    protoss::Point V;
+    protoss::hash_to_point(V, "SharedPassword");
+
+    SessionTable table(handshakes, std::chrono::seconds(30), std::chrono::milliseconds(10), 4);
+    std::vector<protoss::SessionId> ids = make_ids(handshakes);
+    std::vector<protoss::Point> I(handshakes);
+    for (size_t k = 0; k < handshakes; k++)
+    {
+        const uint32_t i = k % identities.size(), j = (k + 1) % identities.size();
+        protoss::State state;
+        protoss::Init(I[k], state, V, identities[i], identities[j]);
+        SessionTable::Record record{state.x, state.I, state.V, i, j};
+        failures += !table.insert(ids[k], record);
+        sodium_memzero(record.x.data(), record.x.size());
+    }
+    failures += table.insert(ids[0], SessionTable::Record{}); // Duplicate
+    failures += table.size() != handshakes;
+
+    for (size_t k = 0; k < handshakes; k++)
+    {
+        protoss::Point R;
+        protoss::SessionKey K_j, K_i;
+        SessionTable::Record record;
+        protoss::RspDer(R, K_j, V, identities[k % identities.size()], identities[(k + 1) % identities.size()], I[k]);
+        if (!table.take(record, ids[k]))
+        {
+            failures++;
+            continue;
+        }
+        protoss::State state{record.x, record.I, record.V, identities[record.P_i], identities[record.P_j]};
+        sodium_memzero(record.x.data(), record.x.size());
+        protoss::Der(K_i, state, R);
+        failures += sodium_memcmp(K_i.data(), K_j.data(), K_i.size()) != 0;
+        failures += table.take(record, ids[k]); // Taken once only
+    }
+    failures += table.size() != 0;
+
+    // Expiry, on injected time points. A 20-minute timeout with 10 ms ticks
+    // puts entries on the third wheel level, so they cascade down twice before
+    // firing; one insert per millisecond, so about half are due 20 minutes
+    // and handshakes / 2 milliseconds in, give or take a tick.
+    const Clock::time_point t0 = Clock::now();
+    SessionTable::Record record{};
+    failures += !table.insert(ids[0], record, t0);
+    failures += !table.lookup(record, ids[0], t0 + std::chrono::seconds(29));
+    failures += table.lookup(record, ids[0], t0 + std::chrono::seconds(31));
+
+    SessionTable slow(handshakes, std::chrono::minutes(20), std::chrono::milliseconds(10), 4);
+    for (size_t k = 0; k < handshakes; k++)
+        failures += !slow.insert(ids[k], record, t0 + std::chrono::milliseconds(k));
+    failures += slow.expire(t0 + std::chrono::minutes(19)) != 0;
+    failures += slow.size() != handshakes;
+    const size_t expired = slow.expire(t0 + std::chrono::minutes(20) + std::chrono::milliseconds(handshakes / 2));
+    failures += expired + 20 < handshakes / 2 || expired > handshakes / 2 + 20;
+    failures += slow.expire(t0 + std::chrono::minutes(21)) + expired != handshakes;
+    failures += slow.size() != 0;
+
+    // Every table, small ones with fewer shards included, takes capacity()
+    // records however the IDs spread over its shards
+    for (size_t capacity : {size_t(1), size_t(10), size_t(100), size_t(1000), size_t(2000), size_t(10000)})
+    {
+        for (int trial = 0; trial < 20; trial++)
+        {
+            SessionTable full(capacity, std::chrono::seconds(30));
+            failures += full.capacity() != capacity;
+            for (protoss::SessionId id : make_ids(capacity))
+                failures += !full.insert(id, record, t0);
+            failures += full.size() != capacity;
+        }
+    }
+    return failures;
+}
+
+struct SingleThreadRates
+{
+    std::vector<double> insert, lookup_hit, lookup_miss, take, expire;
+};
+
+// Ops/s of each operation on a table holding `sessions` pending handshakes
+static SingleThreadRates measure_single_thread(size_t sessions, int num_runs, const SessionTable::Record &record)
+{
+    SingleThreadRates rates;
+    const std::vector<protoss::SessionId> ids = make_ids(sessions), absent = make_ids(sessions);
+    auto rate = [](size_t ops, Clock::time_point start) {
+        return ops / std::chrono::duration<double>(Clock::now() - start).count();
+    };
+
+    for (int run = 0; run < num_runs; run++)
+    {
+        SessionTable table(sessions, std::chrono::seconds(30));
+        const Clock::time_point t0 = Clock::now();
+
+        auto start = Clock::now();
+        for (size_t k = 0; k < sessions; k++)
+            table.insert(ids[k], record, t0);
+        rates.insert.push_back(rate(sessions, start));
+
+        SessionTable::Record out;
+        size_t found = 0;
+        start = Clock::now();
+        for (size_t k = 0; k < sessions; k++)
+            found += table.lookup(out, ids[k], t0);
+        rates.lookup_hit.push_back(rate(sessions, start));
+
+        start = Clock::now();
+        for (size_t k = 0; k < sessions; k++)
+            found += table.lookup(out, absent[k], t0);
+        rates.lookup_miss.push_back(rate(sessions, start));
+
+        // Take half, then put them back so the expiry pass runs on a full table
+        start = Clock::now();
+        for (size_t k = 0; k < sessions; k += 2)
+            found += table.take(out, ids[k], t0);
+        rates.take.push_back(rate((sessions + 1) / 2, start));
+        for (size_t k = 0; k < sessions; k += 2)
+            table.insert(ids[k], record, t0);
+
+        start = Clock::now();
+        const size_t expired = table.expire(t0 + std::chrono::seconds(31));
+        rates.expire.push_back(rate(expired, start));
+        sodium_memzero(out.x.data(), out.x.size());
+        if (found != sessions + (sessions + 1) / 2 || expired != sessions)
+            throw std::runtime_error("session table lost or invented records");
+    }
+    return rates;
+}
+
+// Handshakes/s of `threads` threads each cycling insert, lookup and take on
+// its own IDs, on a table kept at half of `sessions` pending handshakes
+static std::vector<double> measure_threads(size_t sessions, unsigned threads, int num_runs,
+                                           const SessionTable::Record &record)
+{
+    std::vector<double> runs;
+    const size_t per_thread = sessions / threads;
+    const std::vector<protoss::SessionId> ids = make_ids(per_thread * threads);
+
+    for (int run = 0; run < num_runs; run++)
+    {
+        SessionTable table(sessions, std::chrono::seconds(30));
+        std::vector<std::thread> workers;
+        auto start = Clock::now();
+        for (unsigned t = 0; t < threads; t++)
+        {
+            workers.emplace_back([&, t] {
+                const protoss::SessionId *mine = ids.data() + t * per_thread;
+                const size_t half = per_thread / 2;
+                SessionTable::Record out;
+                for (size_t k = 0; k < half; k++)
+                    table.insert(mine[k], record);
+                // Sliding window: session k + half starts as session k completes
+                for (size_t k = 0; k + half < per_thread; k++)
+                {
+                    table.insert(mine[k + half], record);
+                    table.lookup(out, mine[k]);
+                    table.take(out, mine[k]);
+                }
+                sodium_memzero(out.x.data(), out.x.size());
+            });
+        }
+        for (auto &worker : workers)
+            worker.join();
+        runs.push_back((per_thread - per_thread / 2) * threads / std::chrono::duration<double>(Clock::now() - start).count());
+    }
+    return runs;
+}
+
+int main(int argc, char *argv[])
+{
+    if (sodium_init() < 0)
+    {
+        std::cerr << "Failed to initialize libsodium" << std::endl;
+        return 1;
+    }
+
+    // Parse optional CLI arguments: [sessions] [num_runs] [threads]
+    size_t sessions = 1000000;
+    int num_runs = 3;
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    bool valid = argc <= 4;
+    if (argc >= 2)
+        valid = valid && parse_count(argv[1], sessions, 1000);
+    if (argc >= 3)
+        valid = valid && parse_count(argv[2], num_runs);
+    if (argc >= 4)
+        valid = valid && parse_count(argv[3], threads);
+    if (!valid)
+        return usage_error(argv[0], "[sessions (at least 1000)] [num_runs] [threads]");
+
+    std::cout << "Protoss Session Table Benchmark" << std::endl;
+    std::cout << "===============================" << std::endl;
+
+    SessionTable::Record record;
+    randombytes_buf(record.x.data(), record.x.size());
+    randombytes_buf(record.I.data(), record.I.size());
+    randombytes_buf(record.V.data(), record.V.size());
+    record.P_i = 0;
+    record.P_j = 1;
+
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(0);
+
+    try
+    {
+        std::cout << "Checking handshakes through the table and expiry..." << std::endl;
+        int failures = functional_check(1000);
+        if (failures != 0)
+        {
+            std::cerr << "ERROR: " << failures << " session table checks failed" << std::endl;
+            return 1;
+        }
+
+        std::cout << "Measuring memory with " << sessions << " pending sessions..." << std::endl;
+        const std::vector<protoss::SessionId> ids = make_ids(sessions);
+        size_t rss_before = current_rss_kib();
+        size_t table_bytes, rss_full;
+        {
+            SessionTable table(sessions, std::chrono::seconds(30));
+            for (auto id : ids)
+                table.insert(id, record);
+            rss_full = current_rss_kib();
+            table_bytes = table.table_bytes();
+        }
+
+        ss << "Session Table Results with " << sessions << " sessions x " << num_runs << " runs\n";
+        ss << "Functional check: 1000 handshakes through the table, keys match; expiry on lookup and on the wheel;\n";
+        ss << "tables of 1 to 10000 sessions filled to capacity\n";
+        ss << "-------------------------\n";
+        ss << "Slot size: " << SessionTable::slot_bytes() << " bytes\n";
+        ss << "Slot arrays: " << table_bytes / double(sessions) << " bytes/session at " << sessions << " sessions\n";
+        ss << "RSS growth: " << (rss_full - rss_before) * 1024.0 / sessions
+           << " bytes/session (slots, wheel entries and vector slack)\n";
+        ss << "-------------------------\n";
+
+        std::cout << "Measuring single-thread ops/s..." << std::endl;
+        SingleThreadRates rates = measure_single_thread(sessions, num_runs, record);
+        ss << "Single thread, ops/s on a table of " << sessions << " sessions:\n";
+        ss << "Insert:      " << std::setw(11) << calc_mean(rates.insert) << " +/- " << calc_stddev(rates.insert) << "\n";
+        ss << "Lookup hit:  " << std::setw(11) << calc_mean(rates.lookup_hit) << " +/- " << calc_stddev(rates.lookup_hit) << "\n";
+        ss << "Lookup miss: " << std::setw(11) << calc_mean(rates.lookup_miss) << " +/- " << calc_stddev(rates.lookup_miss) << "\n";
+        ss << "Take:        " << std::setw(11) << calc_mean(rates.take) << " +/- " << calc_stddev(rates.take) << "\n";
+        ss << "Expire:      " << std::setw(11) << calc_mean(rates.expire) << " +/- " << calc_stddev(rates.expire) << "\n";
+        ss << "-------------------------\n";
+
+        std::cout << "Measuring insert + lookup + take cycles on up to " << threads << " thread(s)..." << std::endl;
+        ss << "Handshakes/s (insert + lookup + take) by thread count:\n";
+        for (unsigned t = 1; t <= threads; t *= 2)
+        {
+            std::vector<double> runs = measure_threads(sessions, t, num_runs, record);
+            ss << "Threads " << std::setw(3) << t << ": " << std::setw(11) << calc_mean(runs) << " +/- " << calc_stddev(runs) << "\n";
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    sodium_memzero(record.x.data(), record.x.size());
+    std::cout << "\n"
+              << ss.str();
+
+    auto now = std::time(nullptr);
+    std::stringstream filename;
+    filename << "session_table_results_s" << sessions << "_" << std::put_time(std::localtime(&now), "%Y-%m-%d_%H-%M-%S") << ".txt";
+    Logger::get_instance().log_to_file(filename.str(), ss.str());
+    std::cout << "\nSession table results saved to benchmark_results/sodium/" << filename.str() << std::endl;
+
+    return 0;
+}
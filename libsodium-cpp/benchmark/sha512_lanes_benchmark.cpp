@@ -0,0 +1,197 @@
+#include <sodium.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "benchmark_args.hpp"
+#include "benchmark_stats.hpp"
+#include "logger.hpp"
+#include "sha512_lanes.hpp"
+
+using protoss::sha512::Backend;
+using Field = std::span<const unsigned char>;
+
+// Compares hash_lanes with crypto_hash_sha512 on every supported backend: every
+// length up to three blocks in registers of equal lengths, then registers of
+// mixed lengths split into up to three fields, with partial registers;
+// returns the number of mismatching digests
+static int cross_check(const std::vector<unsigned char> &data, const std::vector<Backend> &backends)
+{
+    int mismatches = 0;
+    for (Backend backend : backends)
+    {
+        for (size_t len = 0; len <= 3 * 128; len++)
+        {
+            const size_t n = 9;
+            std::vector<Field> fields(n, Field(data.data() + len, len));
+            std::vector<protoss::sha512::Fields> messages(n);
+            for (size_t i = 0; i < n; i++)
+                messages[i] = protoss::sha512::Fields(&fields[i], 1);
+            unsigned char expected[protoss::sha512::BYTES];
+            crypto_hash_sha512(expected, data.data() + len, len);
+            std::vector<unsigned char> actual(n * protoss::sha512::BYTES);
+            protoss::sha512::hash_lanes(backend, actual.data(), messages.data(), n);
+            for (size_t i = 0; i < n; i++)
+                mismatches += sodium_memcmp(&actual[i * protoss::sha512::BYTES], expected, sizeof expected) != 0;
+        }
+
+        for (size_t n : {size_t(1), size_t(2), size_t(3), size_t(7), size_t(8), size_t(9), size_t(17), size_t(100)})
+        {
+            std::vector<std::array<Field, 3>> fields(n);
+            std::vector<protoss::sha512::Fields> messages(n);
+            std::vector<unsigned char> expected(n * protoss::sha512::BYTES), actual(n * protoss::sha512::BYTES);
+            for (size_t i = 0; i < n; i++)
+            {
+                const size_t a = randombytes_uniform(200), b = randombytes_uniform(200), c = randombytes_uniform(600);
+                fields[i] = {Field(data.data(), a), Field(data.data() + 1000, b), Field(data.data() + 2000, c)};
+                messages[i] = fields[i];
+                std::vector<unsigned char> concatenated;
+                for (Field field : fields[i])
+                    concatenated.insert(concatenated.end(), field.begin(), field.end());
+                crypto_hash_sha512(&expected[i * protoss::sha512::BYTES], concatenated.data(), concatenated.size());
+            }
+            protoss::sha512::hash_lanes(backend, actual.data(), messages.data(), n);
+            for (size_t i = 0; i < n; i++)
+                mismatches += sodium_memcmp(&actual[i * protoss::sha512::BYTES], &expected[i * protoss::sha512::BYTES],
+                                            protoss::sha512::BYTES) != 0;
+        }
+    }
+    return mismatches;
+}
+
+// Hashes per second of hash_lanes on one backend for `batch` messages of
+// `len` bytes, over `iterations` messages
+static std::vector<double> measure(const std::vector<unsigned char> &data, Backend backend, size_t len, size_t batch,
+                                   int iterations, int num_runs)
+{
+    std::vector<Field> fields(batch);
+    std::vector<protoss::sha512::Fields> messages(batch);
+    for (size_t i = 0; i < batch; i++)
+    {
+        fields[i] = Field(data.data() + i % 64, len);
+        messages[i] = protoss::sha512::Fields(&fields[i], 1);
+    }
+    std::vector<unsigned char> out(batch * protoss::sha512::BYTES);
+    size_t rounds = std::max<size_t>(1, iterations / batch);
+
+    std::vector<double> runs;
+    for (int run = 0; run < num_runs; run++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t r = 0; r < rounds; r++)
+            protoss::sha512::hash_lanes(backend, out.data(), messages.data(), batch);
+        auto end = std::chrono::steady_clock::now();
+        runs.push_back(rounds * batch / std::chrono::duration<double>(end - start).count());
+    }
+    return runs;
+}
+
+int main(int argc, char *argv[])
+{
+    if (sodium_init() < 0)
+    {
+        std::cerr << "Failed to initialize libsodium" << std::endl;
+        return 1;
+    }
+
+    // Parse optional CLI arguments: [iterations] [num_runs]
+    int iterations = 200000;
+    int num_runs = 5;
+    bool valid = argc <= 3;
+    if (argc >= 2)
+        valid = valid && parse_count(argv[1], iterations);
+    if (argc >= 3)
+        valid = valid && parse_count(argv[2], num_runs);
+    if (!valid)
+        return usage_error(argv[0], "[iterations] [num_runs]");
+
+    std::cout << "Protoss Multi-Buffer SHA-512 Benchmark" << std::endl;
+    std::cout << "======================================" << std::endl;
+
+    std::vector<unsigned char> data(4096);
+    randombytes_buf(data.data(), data.size());
+
+    std::vector<Backend> backends;
+    for (Backend backend : {Backend::Scalar, Backend::Avx2, Backend::Avx512Ifma})
+        if (protoss::ristretto255::backend_supported(backend))
+            backends.push_back(backend);
+
+    // 16 and 32: typical passwords; 111 and 112: the one- and two-block sides of
+    // the padding boundary; 192: a transcript with 32-byte P_i and P_j
+    const size_t lengths[] = {16, 32, 64, 111, 112, 192, 256, 1024};
+    const size_t batch = 1024;
+
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(1);
+
+    try
+    {
+        std::cout << "Cross-checking hash_lanes against crypto_hash_sha512..." << std::endl;
+        int mismatches = cross_check(data, backends);
+        if (mismatches != 0)
+        {
+            std::cerr << "ERROR: " << mismatches << " digests differ from crypto_hash_sha512" << std::endl;
+            return 1;
+        }
+
+        std::cout << "Measuring hashes/sec (" << num_runs << " runs x " << iterations << " messages per length and backend)..." << std::endl;
+
+        ss << "Multi-Buffer SHA-512 Results with " << iterations << " messages x " << num_runs << " runs, batches of " << batch << "\n";
+        ss << "Cross-check: " << backends.size() << " backends, 0 mismatches against crypto_hash_sha512\n";
+        ss << "-------------------------\n";
+        ss << "Hashes/s by message length (speedup over scalar):\n";
+        ss << std::setw(7) << "bytes";
+        for (Backend backend : backends)
+            ss << std::setw(28) << (std::string(protoss::ristretto255::backend_name(backend)) + " x" +
+                                    std::to_string(protoss::ristretto255::backend_lanes(backend)));
+        ss << "\n";
+
+        for (size_t len : lengths)
+        {
+            ss << std::setw(7) << len;
+            double scalar = 0.0;
+            for (Backend backend : backends)
+            {
+                std::vector<double> runs = measure(data, backend, len, batch, iterations, num_runs);
+                double mean = calc_mean(runs);
+                if (backend == Backend::Scalar)
+                    scalar = mean;
+                std::stringstream cell;
+                cell << std::fixed << std::setprecision(0) << mean << " +/- " << calc_stddev(runs) << " ("
+                     << std::setprecision(2) << mean / scalar << "x)";
+                ss << std::setw(28) << cell.str();
+            }
+            ss << "\n";
+        }
+
+        ss << "-------------------------\n";
+        ss << "Hashes/s of 32-byte messages by batch size on " << protoss::ristretto255::backend_name(protoss::ristretto255::active_backend()) << ":\n";
+        for (size_t n : {size_t(1), size_t(2), size_t(4), size_t(8), size_t(16), size_t(64)})
+        {
+            std::vector<double> runs = measure(data, protoss::ristretto255::active_backend(), 32, n, iterations, num_runs);
+            ss << "Batch size " << std::setw(4) << n << ": " << std::setw(11) << calc_mean(runs) << " +/- " << calc_stddev(runs) << " hashes/s\n";
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n"
+              << ss.str();
+
+    auto now = std::time(nullptr);
+    std::stringstream filename;
+    filename << "sha512_lanes_results_it" << iterations << "_" << std::put_time(std::localtime(&now), "%Y-%m-%d_%H-%M-%S") << ".txt";
+    Logger::get_instance().log_to_file(filename.str(), ss.str());
+    std::cout << "\nSHA-512 results saved to benchmark_results/sodium/" << filename.str() << std::endl;
+
+    return 0;
+}
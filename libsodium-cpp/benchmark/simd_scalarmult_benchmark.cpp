@@ -0,0 +1,296 @@
+#include <sodium.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "benchmark_args.hpp"
+#include "benchmark_stats.hpp"
+#include "logger.hpp"
+#include "protoss_batch.hpp"
+#include "protoss_protocol.hpp"
+#include "ristretto255_lanes.hpp"
+
+using protoss::ristretto255::Backend;
+using protoss::ristretto255::GroupElement;
+
+// Random inputs for n multiplications, in both encodings and extended coordinates
+struct Inputs
+{
+    std::vector<protoss::Scalar> k;
+    std::vector<protoss::Point> P;
+    std::vector<GroupElement> p;
+
+    explicit Inputs(size_t n) : k(n), P(n), p(n)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            crypto_core_ristretto255_scalar_random(k[i].data());
+            crypto_core_ristretto255_random(P[i].data());
+            protoss::ristretto255::decode(p[i], P[i]);
+        }
+    }
+
+    ~Inputs() { sodium_memzero(k.data(), k.size() * sizeof(protoss::Scalar)); }
+};
+
+// Checks every supported backend against crypto_scalarmult_ristretto255 on
+// batches that fill, underfill and overrun the registers, with a few zero
+// scalars and identity points mixed in, then checks that batched handshakes
+// agree on the key. Returns the number of mismatches.
+static int cross_check(int trials, const std::vector<Backend> &backends)
+{
+    const size_t batch = 19; // Not a multiple of 4 or 8, to exercise the padded tail
+    int mismatches = 0;
+
+    for (int t = 0; t < trials; t++)
+    {
+        Inputs in(batch);
+        in.k[t % batch] = protoss::Scalar{};
+        in.P[(t + 7) % batch] = protoss::Point{};
+        protoss::ristretto255::decode(in.p[(t + 7) % batch], in.P[(t + 7) % batch]);
+
+        std::vector<protoss::Point> expected(batch);
+        for (size_t i = 0; i < batch; i++)
+            if (crypto_scalarmult_ristretto255(expected[i].data(), in.k[i].data(), in.P[i].data()) != 0)
+                expected[i] = protoss::Point{}; // libsodium reports an identity result as an error
+
+        for (Backend backend : backends)
+        {
+            for (size_t n : {size_t(1), batch})
+            {
+                std::vector<GroupElement> r(n);
+                protoss::ristretto255::scalarmult_lanes(backend, r.data(), in.k.data(), in.p.data(), n);
+                for (size_t i = 0; i < n; i++)
+                {
+                    protoss::Point actual;
+                    protoss::ristretto255::encode(actual, r[i]);
+                    mismatches += actual != expected[i];
+                }
+            }
+        }
+    }
+
+    // Batched handshakes: RspDerBatch and DerBatch must derive the same keys
+    const unsigned char P_i[] = {0x00};
+    const unsigned char P_j[] = {0x01};
+    protoss::Point V;
+    protoss::hash_to_point(V, "SharedPassword");
+    std::vector<protoss::State> states(batch);
+    std::vector<protoss::RspDerRequest> rsp_requests(batch);
+    std::vector<protoss::RspDerResponse> rsp_responses(batch);
+    std::vector<protoss::DerRequest> der_requests(batch);
+    std::vector<protoss::DerResponse> der_responses(batch);
+    for (Backend backend : backends)
+    {
+        protoss::ristretto255::set_active_backend(backend);
+        for (size_t i = 0; i < batch; i++)
+        {
+            protoss::Init(rsp_requests[i].I, states[i], V, P_i, P_j);
+            rsp_requests[i].V = V;
+            rsp_requests[i].P_i = P_i;
+            rsp_requests[i].P_j = P_j;
+        }
+        protoss::RspDerBatch(rsp_requests, rsp_responses);
+        for (size_t i = 0; i < batch; i++)
+            der_requests[i] = protoss::DerRequest{&states[i], rsp_responses[i].R};
+        protoss::DerBatch(der_requests, der_responses);
+        for (size_t i = 0; i < batch; i++)
+        {
+            protoss::SessionKey K_i;
+            protoss::Der(K_i, states[i], rsp_responses[i].R);
+            mismatches += rsp_responses[i].status != protoss::Status::Ok || der_responses[i].status != protoss::Status::Ok ||
+                          der_responses[i].K != rsp_responses[i].K || K_i != rsp_responses[i].K;
+        }
+    }
+    return mismatches;
+}
+
+// Multiplications per second of one backend at one batch size
+static std::vector<double> measure_scalarmult(Backend backend, const Inputs &in, size_t batch_size, int iterations, int num_runs)
+{
+    std::vector<GroupElement> r(batch_size);
+    size_t batches = std::max<size_t>(1, iterations / batch_size);
+    std::vector<double> runs;
+    for (int run = 0; run < num_runs; run++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t b = 0; b < batches; b++)
+            protoss::ristretto255::scalarmult_lanes(backend, r.data(), in.k.data(), in.p.data(), batch_size);
+        auto end = std::chrono::steady_clock::now();
+        runs.push_back(batches * batch_size / std::chrono::duration<double>(end - start).count());
+    }
+    return runs;
+}
+
+// Handshakes per second of RspDerBatch and DerBatch on one backend
+static void measure_handshake_steps(Backend backend, size_t batch_size, int iterations, int num_runs,
+                                    std::vector<double> &rspder_runs, std::vector<double> &der_runs)
+{
+    const unsigned char P_i[] = {0x00};
+    const unsigned char P_j[] = {0x01};
+    protoss::Point V;
+    protoss::hash_to_point(V, "SharedPassword");
+
+    std::vector<protoss::State> states(batch_size);
+    std::vector<protoss::RspDerRequest> rsp_requests(batch_size);
+    std::vector<protoss::RspDerResponse> rsp_responses(batch_size);
+    std::vector<protoss::DerRequest> der_requests(batch_size);
+    std::vector<protoss::DerResponse> der_responses(batch_size);
+    for (size_t i = 0; i < batch_size; i++)
+    {
+        protoss::Init(rsp_requests[i].I, states[i], V, P_i, P_j);
+        rsp_requests[i].V = V;
+        rsp_requests[i].P_i = P_i;
+        rsp_requests[i].P_j = P_j;
+    }
+    protoss::RspDerBatch(rsp_requests, rsp_responses);
+    for (size_t i = 0; i < batch_size; i++)
+        der_requests[i] = protoss::DerRequest{&states[i], rsp_responses[i].R};
+
+    protoss::ristretto255::set_active_backend(backend);
+    size_t batches = std::max<size_t>(1, iterations / batch_size);
+    for (int run = 0; run < num_runs; run++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t b = 0; b < batches; b++)
+            protoss::RspDerBatch(rsp_requests, rsp_responses);
+        auto end = std::chrono::steady_clock::now();
+        rspder_runs.push_back(batches * batch_size / std::chrono::duration<double>(end - start).count());
+
+        // The keys of the last RspDerBatch round are checked by the DerBatch rounds below
+        for (size_t i = 0; i < batch_size; i++)
+            der_requests[i].R = rsp_responses[i].R;
+        start = std::chrono::steady_clock::now();
+        for (size_t b = 0; b < batches; b++)
+            protoss::DerBatch(der_requests, der_responses);
+        end = std::chrono::steady_clock::now();
+        der_runs.push_back(batches * batch_size / std::chrono::duration<double>(end - start).count());
+
+        for (size_t i = 0; i < batch_size; i++)
+            if (der_responses[i].status != protoss::Status::Ok || der_responses[i].K != rsp_responses[i].K)
+                throw std::runtime_error("batched session keys don't match");
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    if (sodium_init() < 0)
+    {
+        std::cerr << "Failed to initialize libsodium" << std::endl;
+        return 1;
+    }
+
+    // Parse optional CLI arguments: [iterations] [num_runs]
+    int iterations = 2000;
+    int num_runs = 5;
+    bool valid = argc <= 3;
+    if (argc >= 2)
+        valid = valid && parse_count(argv[1], iterations);
+    if (argc >= 3)
+        valid = valid && parse_count(argv[2], num_runs);
+    if (!valid)
+        return usage_error(argv[0], "[iterations] [num_runs]");
+
+    std::cout << "Protoss SIMD Scalar Multiplication Benchmark" << std::endl;
+    std::cout << "============================================" << std::endl;
+
+    const Backend automatic = protoss::ristretto255::active_backend();
+    std::vector<Backend> backends;
+    for (Backend backend : {Backend::Scalar, Backend::Avx2, Backend::Avx512Ifma})
+    {
+        bool supported = protoss::ristretto255::backend_supported(backend);
+        std::cout << "Backend " << protoss::ristretto255::backend_name(backend) << ": "
+                  << (supported ? "supported" : "not supported on this CPU") << std::endl;
+        if (supported)
+            backends.push_back(backend);
+    }
+
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(1);
+
+    try
+    {
+        const int trials = 200;
+        std::cout << "Cross-checking every backend against libsodium (" << trials << " trials)..." << std::endl;
+        int mismatches = cross_check(trials, backends);
+        if (mismatches != 0)
+        {
+            std::cerr << "ERROR: " << mismatches << " mismatches between the SIMD backends and libsodium" << std::endl;
+            return 1;
+        }
+
+        const size_t batch_sizes[] = {1, 4, 8, 16, 64, 256};
+        Inputs in(256);
+
+        std::cout << "Measuring scalarmult throughput (" << num_runs << " runs x " << iterations
+                  << " multiplications per batch size)..." << std::endl;
+        ss << "SIMD Scalar Multiplication Results with " << iterations << " multiplications x " << num_runs << " runs\n";
+        ss << "Cross-check: " << trials << " trials per backend, 0 mismatches against libsodium\n";
+        ss << "Automatic backend: " << protoss::ristretto255::backend_name(automatic) << "\n";
+        ss << "-------------------------\n";
+        ss << "scalarmult_lanes, multiplications/s (mean +/- stddev) and speedup over scalar\n";
+        ss << std::left << std::setw(12) << "Backend" << std::right << std::setw(6) << "lanes";
+        for (size_t batch_size : batch_sizes)
+            ss << std::setw(18) << ("batch " + std::to_string(batch_size));
+        ss << "\n";
+
+        std::vector<double> scalar_means;
+        for (Backend backend : backends)
+        {
+            ss << std::left << std::setw(12) << protoss::ristretto255::backend_name(backend) << std::right
+               << std::setw(6) << protoss::ristretto255::backend_lanes(backend);
+            std::stringstream speedups;
+            speedups << std::fixed << std::setprecision(2) << std::setw(18) << "";
+            for (size_t b = 0; b < std::size(batch_sizes); b++)
+            {
+                std::vector<double> runs = measure_scalarmult(backend, in, batch_sizes[b], iterations, num_runs);
+                double mean = calc_mean(runs);
+                if (backend == Backend::Scalar)
+                    scalar_means.push_back(mean);
+                std::stringstream cell;
+                cell << std::fixed << std::setprecision(0) << mean << " +/- " << calc_stddev(runs);
+                ss << std::setw(18) << cell.str();
+                speedups << std::setw(17) << mean / scalar_means[b] << "x";
+            }
+            ss << "\n"
+               << speedups.str() << "\n";
+        }
+
+        const size_t handshake_batch = 64;
+        std::cout << "Measuring RspDerBatch / DerBatch throughput (batch " << handshake_batch << ")..." << std::endl;
+        ss << "-------------------------\n";
+        ss << "Batched handshake steps, batch " << handshake_batch << ", handshakes/s\n";
+        ss << std::left << std::setw(12) << "Backend" << std::right << std::setw(24) << "RspDerBatch" << std::setw(24) << "DerBatch" << "\n";
+        for (Backend backend : backends)
+        {
+            std::vector<double> rspder_runs, der_runs;
+            measure_handshake_steps(backend, handshake_batch, iterations, num_runs, rspder_runs, der_runs);
+            ss << std::left << std::setw(12) << protoss::ristretto255::backend_name(backend) << std::right
+               << std::setw(13) << calc_mean(rspder_runs) << " +/- " << std::setw(6) << calc_stddev(rspder_runs)
+               << std::setw(13) << calc_mean(der_runs) << " +/- " << std::setw(6) << calc_stddev(der_runs) << "\n";
+        }
+        protoss::ristretto255::set_active_backend(automatic);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n"
+              << ss.str();
+
+    auto now = std::time(nullptr);
+    std::stringstream filename;
+    filename << "simd_scalarmult_results_it" << iterations << "_" << std::put_time(std::localtime(&now), "%Y-%m-%d_%H-%M-%S") << ".txt";
+    Logger::get_instance().log_to_file(filename.str(), ss.str());
+    std::cout << "\nSIMD scalarmult results saved to benchmark_results/sodium/" << filename.str() << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,122 @@
+#include <sodium.h>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "benchmark_args.hpp"
+#include "logger.hpp"
+#include "protoss_protocol.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <unistd.h>
+#endif
+
+// Returns the resident set size of this process in KiB, or 0 if unavailable
+static size_t current_rss_kib()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return 0;
+    return counters.WorkingSetSize / 1024;
+#else
+    std::ifstream statm("/proc/self/statm");
+    size_t total_pages = 0, resident_pages = 0;
+    if (!(statm >> total_pages >> resident_pages))
+        return 0;
+    return resident_pages * (size_t)sysconf(_SC_PAGESIZE) / 1024;
+#endif
+}
+
+int main(int argc, char *argv[])
+{
+    if (sodium_init() < 0)
+    {
+        std::cerr << "Failed to initialize libsodium" << std::endl;
+        return 1;
+    }
+
+    // Parse optional CLI arguments: [handshakes] [report_interval]
+    long long handshakes = 2000000;
+    long long report_interval = 100000;
+    bool valid = argc <= 3;
+    if (argc >= 2)
+        valid = valid && parse_count(argv[1], handshakes);
+    if (argc >= 3)
+        valid = valid && parse_count(argv[2], report_interval);
+    if (!valid)
+        return usage_error(argv[0], "[handshakes] [report_interval]");
+
+    std::cout << "Protoss Soak Benchmark" << std::endl;
+    std::cout << "======================" << std::endl;
+    std::cout << "Running " << handshakes << " handshakes through the vector API, sampling RSS every "
+              << report_interval << " handshakes..." << std::endl;
+
+    std::string password = "SharedPassword";
+    std::vector<unsigned char> P_i = {0x00};
+    std::vector<unsigned char> P_j = {0x01};
+
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(3);
+    ss << "Soak Results with " << handshakes << " handshakes (Init + RspDer + Der)\n";
+    ss << "-------------------------\n";
+    ss << "Handshakes      RSS (KiB)     Elapsed (s)\n";
+
+    size_t rss_start = current_rss_kib();
+    size_t rss_peak = rss_start;
+    auto start = std::chrono::steady_clock::now();
+    ss << std::setw(10) << 0 << "  " << std::setw(12) << rss_start << "  " << std::setw(12) << 0.0 << "\n";
+
+    try
+    {
+        for (long long i = 1; i <= handshakes; i++)
+        {
+            ReturnTypeInit res_init = Init(password, P_i, P_j);
+            ReturnTypeRspDer res_rspDer = RspDer(password, P_i, P_j, res_init.I);
+            std::vector<unsigned char> session_key_i = Der(password, res_init.protoss_state, res_rspDer.R);
+            if (session_key_i != res_rspDer.getSessionKey())
+            {
+                std::cerr << "ERROR: Session keys don't match!" << std::endl;
+                return 1;
+            }
+
+            if (i % report_interval == 0 || i == handshakes)
+            {
+                size_t rss = current_rss_kib();
+                if (rss > rss_peak)
+                    rss_peak = rss;
+                double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                ss << std::setw(10) << i << "  " << std::setw(12) << rss << "  " << std::setw(12) << elapsed << "\n";
+                std::cout << "  " << i << " handshakes, RSS " << rss << " KiB" << std::endl;
+            }
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    size_t rss_end = current_rss_kib();
+    ss << "-------------------------\n";
+    ss << "RSS start: " << rss_start << " KiB, end: " << rss_end << " KiB, peak: " << rss_peak << " KiB\n";
+    ss << "RSS growth: " << (long long)rss_end - (long long)rss_start << " KiB\n";
+    std::cout << "\n"
+              << ss.str();
+
+    auto now = std::time(nullptr);
+    std::stringstream filename;
+    filename << "soak_results_hs" << handshakes << "_" << std::put_time(std::localtime(&now), "%Y-%m-%d_%H-%M-%S") << ".txt";
+    Logger::get_instance().log_to_file(filename.str(), ss.str());
+    std::cout << "\nSoak results saved to benchmark_results/sodium/" << filename.str() << std::endl;
+
+    return 0;
+}
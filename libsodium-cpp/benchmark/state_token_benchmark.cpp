@@ -0,0 +1,301 @@
+#include <sodium.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "benchmark_args.hpp"
+#include "benchmark_stats.hpp"
+#include "logger.hpp"
+#include "protoss_protocol.hpp"
+#include "session_table.hpp"
+#include "state_token.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <unistd.h>
+#endif
+
+using protoss::StateSealer;
+using Clock = StateSealer::Clock;
+
+// Returns the resident set size of this process in KiB, or 0 if unavailable
+static size_t current_rss_kib()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return 0;
+    return counters.WorkingSetSize / 1024;
+#else
+    std::ifstream statm("/proc/self/statm");
+    size_t total_pages = 0, resident_pages = 0;
+    if (!(statm >> total_pages >> resident_pages))
+        return 0;
+    return resident_pages * (size_t)sysconf(_SC_PAGESIZE) / 1024;
+#endif
+}
+
+// 16-byte identities, such as device UUIDs
+static const std::vector<unsigned char> P_i(16, 0xa5);
+static std::vector<unsigned char> P_j(16, 0x5a);
+
+// Runs handshakes whose initiator state lives only in a token between Init
+// and Der, checks that tampered, expired and retired-key tokens are
+// rejected, and round-trips the vector API. Returns the number of failures.
+static int functional_check(int handshakes)
+{
+    int failures = 0;
+    const std::string password = "SharedPassword";
+    protoss::Point V;
+    protoss::hash_to_point(V, password);
+    StateSealer sealer(std::chrono::seconds(30), std::chrono::minutes(5));
+
+    for (int k = 0; k < handshakes; k++)
+    {
+        protoss::Point I, R;
+        protoss::SessionKey K_i, K_j;
+        std::vector<unsigned char> token;
+        {
+            protoss::State state;
+            protoss::Init(I, state, V, P_i, P_j);
+            token = sealer.seal(state);
+        }
+        protoss::RspDer(R, K_j, V, P_i, P_j, I);
+        failures += sealer.Der(K_i, token, R) != protoss::Status::Ok;
+        failures += sodium_memcmp(K_i.data(), K_j.data(), K_i.size()) != 0;
+
+        std::vector<unsigned char> tampered = token;
+        tampered[randombytes_uniform(tampered.size())] ^= 1 << randombytes_uniform(8);
+        failures += sealer.Der(K_i, tampered, R) != protoss::Status::InvalidToken;
+        failures += sealer.Der(K_i, std::span(token).first(token.size() - 1), R) != protoss::Status::InvalidToken;
+    }
+
+    // Expiry and rotation, on injected time points
+    const Clock::time_point t0 = Clock::now();
+    protoss::State state;
+    protoss::Point I;
+    protoss::Init(I, state, V, P_i, P_j);
+    std::vector<unsigned char> token = sealer.seal(state, t0);
+    std::vector<unsigned char> identities(StateSealer::identity_bytes(token));
+    protoss::State opened;
+    failures += sealer.open(opened, identities, token, t0 + std::chrono::seconds(29)) != protoss::Status::Ok;
+    failures += opened.x != state.x || opened.I != state.I || opened.V != state.V;
+    failures += !std::equal(opened.P_i.begin(), opened.P_i.end(), P_i.begin(), P_i.end());
+    failures += sealer.open(opened, identities, token, t0 + std::chrono::seconds(31)) != protoss::Status::InvalidToken;
+    sealer.rotate();
+    failures += sealer.open(opened, identities, token, t0) != protoss::Status::Ok;
+    sealer.rotate();
+    failures += sealer.open(opened, identities, token, t0) != protoss::Status::InvalidToken;
+    StateSealer other(std::chrono::seconds(30), std::chrono::minutes(5));
+    failures += other.open(opened, identities, token, t0) != protoss::Status::InvalidToken;
+
+    // Vector API: the ProtossState of Init goes through a token into Der
+    ReturnTypeInit init = Init(password, P_i, P_j);
+    std::vector<unsigned char> sealed = sealer.seal(init.protoss_state);
+    ReturnTypeRspDer response = RspDer(password, P_i, P_j, init.I);
+    failures += Der(password, sealer.open(sealed), response.R) != response.getSessionKey();
+    return failures;
+}
+
+struct Timings
+{
+    std::vector<double> seal, open, der_state, der_token; // ns per operation
+};
+
+static Timings measure(int iterations, int num_runs)
+{
+    Timings timings;
+    protoss::Point V, I, R;
+    protoss::SessionKey K;
+    protoss::hash_to_point(V, "SharedPassword");
+    protoss::State state;
+    protoss::Init(I, state, V, P_i, P_j);
+    protoss::RspDer(R, K, V, P_i, P_j, I);
+
+    StateSealer sealer(std::chrono::seconds(30), std::chrono::minutes(5));
+    std::vector<unsigned char> token(StateSealer::token_bytes(P_i.size() + P_j.size()));
+    std::vector<unsigned char> identities(P_i.size() + P_j.size());
+    auto ns_per_op = [](Clock::time_point start, int ops) {
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / ops;
+    };
+    // Der costs a scalar multiplication, so it gets fewer iterations
+    const int der_iterations = std::max(1, iterations / 50);
+
+    for (int run = 0; run < num_runs; run++)
+    {
+        auto start = Clock::now();
+        for (int i = 0; i < iterations; i++)
+            sealer.seal(token, state);
+        timings.seal.push_back(ns_per_op(start, iterations));
+
+        protoss::State opened;
+        int ok = 0;
+        start = Clock::now();
+        for (int i = 0; i < iterations; i++)
+            ok += sealer.open(opened, identities, token) == protoss::Status::Ok;
+        timings.open.push_back(ns_per_op(start, iterations));
+
+        start = Clock::now();
+        for (int i = 0; i < der_iterations; i++)
+            ok += protoss::TryDer(K, state, R) == protoss::Status::Ok;
+        timings.der_state.push_back(ns_per_op(start, der_iterations));
+
+        start = Clock::now();
+        for (int i = 0; i < der_iterations; i++)
+            ok += sealer.Der(K, token, R) == protoss::Status::Ok;
+        timings.der_token.push_back(ns_per_op(start, der_iterations));
+
+        if (ok != iterations + 2 * der_iterations)
+            throw std::runtime_error("state token failed to open");
+    }
+    return timings;
+}
+
+// Bytes per pending handshake held by the gateway, from the RSS growth of
+// keeping `sessions` states in each kind of store
+struct Memory
+{
+    double protoss_state_map, session_table, tokens;
+    double token_seconds;
+};
+
+static Memory measure_memory(size_t sessions)
+{
+    Memory memory{};
+    protoss::State state;
+    randombytes_buf(state.x.data(), state.x.size());
+    randombytes_buf(state.I.data(), state.I.size());
+    randombytes_buf(state.V.data(), state.V.size());
+    state.P_i = P_i;
+    state.P_j = P_j;
+
+    // Fixed-size records in the session table, measured first: its slot
+    // arrays go back to the system when it is destroyed, unlike the small
+    // blocks of the map, which the allocator keeps for reuse
+    {
+        size_t before = current_rss_kib();
+        protoss::SessionTable table(sessions, std::chrono::seconds(30));
+        protoss::SessionTable::Record record{state.x, state.I, state.V, 0, 1};
+        for (size_t k = 0; k < sessions; k++)
+            table.insert(k + 1, record);
+        memory.session_table = (current_rss_kib() - before) * 1024.0 / sessions;
+        sodium_memzero(record.x.data(), record.x.size());
+    }
+
+    // The vector API: a ProtossState per handshake in a hash map
+    {
+        const std::vector<unsigned char> x(state.x.begin(), state.x.end()), I(state.I.begin(), state.I.end()),
+            V(state.V.begin(), state.V.end());
+        size_t before = current_rss_kib();
+        std::unordered_map<uint64_t, ProtossState> map;
+        map.reserve(sessions);
+        for (size_t k = 0; k < sessions; k++)
+            map.emplace(k + 1, ProtossState(x, I, P_i, P_j, V));
+        memory.protoss_state_map = (current_rss_kib() - before) * 1024.0 / sessions;
+    }
+
+    // Tokens: sealed into one reused buffer, as if each were sent right away
+    {
+        StateSealer sealer(std::chrono::seconds(30), std::chrono::minutes(5));
+        std::vector<unsigned char> token(StateSealer::token_bytes(P_i.size() + P_j.size()));
+        size_t before = current_rss_kib();
+        auto start = Clock::now();
+        for (size_t k = 0; k < sessions; k++)
+            sealer.seal(token, state);
+        memory.token_seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        memory.tokens = (double(current_rss_kib()) - double(before)) * 1024.0 / sessions;
+    }
+    return memory;
+}
+
+int main(int argc, char *argv[])
+{
+    if (sodium_init() < 0)
+    {
+        std::cerr << "Failed to initialize libsodium" << std::endl;
+        return 1;
+    }
+
+    // Parse optional CLI arguments: [iterations] [num_runs] [sessions]
+    int iterations = 100000;
+    int num_runs = 5;
+    size_t sessions = 1000000;
+    bool valid = argc <= 4;
+    if (argc >= 2)
+        valid = valid && parse_count(argv[1], iterations);
+    if (argc >= 3)
+        valid = valid && parse_count(argv[2], num_runs);
+    if (argc >= 4)
+        valid = valid && parse_count(argv[3], sessions);
+    if (!valid)
+        return usage_error(argv[0], "[iterations] [num_runs] [sessions]");
+
+    std::cout << "Protoss State Token Benchmark" << std::endl;
+    std::cout << "=============================" << std::endl;
+
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(1);
+
+    try
+    {
+        std::cout << "Checking handshakes resumed from tokens..." << std::endl;
+        int failures = functional_check(200);
+        if (failures != 0)
+        {
+            std::cerr << "ERROR: " << failures << " state token checks failed" << std::endl;
+            return 1;
+        }
+
+        std::cout << "Measuring seal/open cost (" << num_runs << " runs x " << iterations << " tokens)..." << std::endl;
+        Timings timings = measure(iterations, num_runs);
+
+        std::cout << "Measuring gateway memory with " << sessions << " pending handshakes..." << std::endl;
+        Memory memory = measure_memory(sessions);
+
+        const size_t token_len = StateSealer::token_bytes(P_i.size() + P_j.size());
+        ss << "State Token Results with " << iterations << " iterations x " << num_runs << " runs, 16-byte P_i and P_j\n";
+        ss << "Functional check: 200 handshakes through tokens, keys match; tampered, truncated, expired and retired-key tokens rejected\n";
+        ss << "-------------------------\n";
+        ss << "Token size: " << token_len << " bytes (" << protoss::STATE_TOKEN_OVERHEAD << " + identities)\n";
+        ss << "Seal:               " << std::setw(9) << calc_mean(timings.seal) << " +/- " << calc_stddev(timings.seal) << " ns\n";
+        ss << "Open:               " << std::setw(9) << calc_mean(timings.open) << " +/- " << calc_stddev(timings.open) << " ns\n";
+        ss << "Der from State:     " << std::setw(9) << calc_mean(timings.der_state) << " +/- " << calc_stddev(timings.der_state) << " ns\n";
+        ss << "Der from token:     " << std::setw(9) << calc_mean(timings.der_token) << " +/- " << calc_stddev(timings.der_token) << " ns\n";
+        ss << "Seal + open per handshake: " << calc_mean(timings.seal) + calc_mean(timings.open) << " ns\n";
+        ss << "-------------------------\n";
+        ss << "Gateway memory per pending handshake at " << sessions << " (RSS growth):\n";
+        ss << "ProtossState map:   " << std::setw(9) << memory.protoss_state_map << " bytes, "
+           << memory.protoss_state_map * sessions / (1 << 20) << " MiB\n";
+        ss << "Session table:      " << std::setw(9) << memory.session_table << " bytes, "
+           << memory.session_table * sessions / (1 << 20) << " MiB\n";
+        ss << "Tokens:             " << std::setw(9) << memory.tokens << " bytes (" << token_len
+           << " bytes on the wire each way instead), " << sessions << " sealed in " << std::setprecision(3)
+           << memory.token_seconds << " s\n";
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n"
+              << ss.str();
+
+    auto now = std::time(nullptr);
+    std::stringstream filename;
+    filename << "state_token_results_it" << iterations << "_" << std::put_time(std::localtime(&now), "%Y-%m-%d_%H-%M-%S") << ".txt";
+    Logger::get_instance().log_to_file(filename.str(), ss.str());
+    std::cout << "\nState token results saved to benchmark_results/sodium/" << filename.str() << std::endl;
+
+    return 0;
+}
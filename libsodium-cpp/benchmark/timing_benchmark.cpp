@@ -1,4 +1,5 @@
 #include <sodium.h>
+#include <algorithm>
 #include <stdexcept>
 #include <vector>
 #include <string>
@@ -8,35 +9,44 @@
 #include <cmath>
 #include <cstdlib>
 #include <thread>
+#include <atomic>
 #include <sstream>
+#include "benchmark_args.hpp"
+#include "benchmark_report.hpp"
+#include "latency_histogram.hpp"
 #include "logger.hpp"
 #include "protoss_protocol.hpp"
+#include "protoss_batch.hpp"
+#include "ristretto255.hpp"
 
-static double calc_mean(const std::vector<double> &values)
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// Per-handshake latency distribution of each phase, accumulated over all runs
+struct PhaseHistograms
 {
-    double sum = 0.0;
-    for (double v : values)
-        sum += v;
-    return sum / values.size();
-}
+    LatencyHistogram init, rspder, der, total;
+};
 
-static double calc_stddev(const std::vector<double> &values)
+// Appends one "p50 p90 p99 p99.9 max" row in microseconds
+static void write_percentile_row(std::stringstream &ss, const std::string &name, const LatencyHistogram &hist)
 {
-    if (values.size() < 2)
-        return 0.0;
-    double m = calc_mean(values);
-    double sum_sq = 0.0;
-    for (double v : values)
-    {
-        double diff = v - m;
-        sum_sq += diff * diff;
-    }
-    return std::sqrt(sum_sq / (values.size() - 1));
+    ss << std::left << std::setw(10) << name << std::right;
+    for (double p : {50.0, 90.0, 99.0, 99.9})
+        ss << std::setw(11) << hist.value_at_percentile(p) / 1000.0;
+    ss << std::setw(11) << hist.max() / 1000.0 << "\n";
 }
 
 // Returns true on success, storing per-run averages in out parameters.
+// When histograms is set, every handshake's phase latencies are recorded into it.
 bool run_benchmark(int iterations, int run_id, bool is_warmup,
-                   double &out_init_ms, double &out_rspder_ms, double &out_der_ms)
+                   double &out_init_ms, double &out_rspder_ms, double &out_der_ms,
+                   PhaseHistograms *histograms = nullptr)
 {
     if (is_warmup)
         std::cout << "Warmup: Running Protoss protocol benchmark with " << iterations << " iterations..." << std::endl;
@@ -62,7 +72,8 @@ bool run_benchmark(int iterations, int run_id, bool is_warmup,
             auto start = std::chrono::high_resolution_clock::now();
             ReturnTypeInit res_init = Init(password, P_i, P_j);
             auto end = std::chrono::high_resolution_clock::now();
-            init_time += end - start;
+            auto init_elapsed = end - start;
+            init_time += init_elapsed;
 
             std::vector<unsigned char> I = res_init.I;
             ProtossState protoss_state = res_init.protoss_state;
@@ -71,7 +82,8 @@ bool run_benchmark(int iterations, int run_id, bool is_warmup,
             start = std::chrono::high_resolution_clock::now();
             ReturnTypeRspDer res_rspDer = RspDer(password, P_i, P_j, I);
             end = std::chrono::high_resolution_clock::now();
-            rspder_time += end - start;
+            auto rspder_elapsed = end - start;
+            rspder_time += rspder_elapsed;
 
             std::vector<unsigned char> R = res_rspDer.R;
             std::vector<unsigned char> session_key_j = res_rspDer.getSessionKey();
@@ -80,7 +92,16 @@ bool run_benchmark(int iterations, int run_id, bool is_warmup,
             start = std::chrono::high_resolution_clock::now();
             std::vector<unsigned char> session_key_i = Der(password, protoss_state, R);
             end = std::chrono::high_resolution_clock::now();
-            der_time += end - start;
+            auto der_elapsed = end - start;
+            der_time += der_elapsed;
+
+            if (histograms)
+            {
+                histograms->init.record(init_elapsed);
+                histograms->rspder.record(rspder_elapsed);
+                histograms->der.record(der_elapsed);
+                histograms->total.record(init_elapsed + rspder_elapsed + der_elapsed);
+            }
 
             // We only verify keys match in the first iteration of the first run
             if (i == 0 && run_id == 1 && !is_warmup)
@@ -107,44 +128,36 @@ bool run_benchmark(int iterations, int run_id, bool is_warmup,
     return true;
 }
 
-int main(int argc, char *argv[])
+// Converts per-run averages from ms to the us used by the structured report
+static std::vector<double> to_us(const std::vector<double> &ms)
 {
-    Logger::get_instance().log(LoggingKeyword::BENCHMARK, "See the benchmark_results/sodium folder for the info of this run.");
-    if (sodium_init() < 0)
-    {
-        std::cerr << "Failed to initialize libsodium" << std::endl;
-        return 1;
-    }
-
-    // Default parameters
-    int iterations = 10000;
-    int num_runs = 10;
-
-    // Parse optional CLI arguments: [iterations] [num_runs]
-    if (argc >= 2)
-        iterations = std::atoi(argv[1]);
-    if (argc >= 3)
-        num_runs = std::atoi(argv[2]);
-
-    std::cout << "Protoss Protocol Timing Benchmark" << std::endl;
-    std::cout << "=================================" << std::endl;
+    std::vector<double> us;
+    for (double v : ms)
+        us.push_back(v * 1000.0);
+    return us;
+}
 
+// Default mode: mean latency per phase across runs, optionally also written as JSON and/or CSV
+static bool run_phase_benchmark(int iterations, int num_runs, bool write_json, bool write_csv)
+{
     // First run a warmup to avoid cold-start effects
+    const int warmup_iterations = 100;
     std::cout << "Performing warmup runs..." << std::endl;
     double dummy_init, dummy_rspder, dummy_der;
-    run_benchmark(100, 0, true, dummy_init, dummy_rspder, dummy_der);
+    run_benchmark(warmup_iterations, 0, true, dummy_init, dummy_rspder, dummy_der);
 
     // Run the benchmark multiple times to average out external variability
     std::cout << "\nRunning main benchmark (" << num_runs << " runs x " << iterations << " iterations)..." << std::endl;
     std::vector<double> run_init, run_rspder, run_der, run_total;
+    PhaseHistograms histograms;
 
     for (int r = 1; r <= num_runs; r++)
     {
         double avg_init, avg_rspder, avg_der;
-        if (!run_benchmark(iterations, r, false, avg_init, avg_rspder, avg_der))
+        if (!run_benchmark(iterations, r, false, avg_init, avg_rspder, avg_der, &histograms))
         {
             std::cerr << "ERROR: Run " << r << " failed, aborting." << std::endl;
-            return 1;
+            return false;
         }
         run_init.push_back(avg_init);
         run_rspder.push_back(avg_rspder);
@@ -179,16 +192,424 @@ int main(int argc, char *argv[])
     ss << "Init phase:     " << (mean_init / mean_total * 100) << "%\n";
     ss << "RspDer phase:   " << (mean_rspder / mean_total * 100) << "%\n";
     ss << "Der phase:      " << (mean_der / mean_total * 100) << "%\n";
+    ss << "\nLatency Percentiles over " << histograms.total.count() << " handshakes (us):\n";
+    ss << "Phase             p50        p90        p99      p99.9        max\n";
+    write_percentile_row(ss, "Init", histograms.init);
+    write_percentile_row(ss, "RspDer", histograms.rspder);
+    write_percentile_row(ss, "Der", histograms.der);
+    write_percentile_row(ss, "Total", histograms.total);
 
     // Get current timestamp for the filename
+    auto now = std::time(nullptr);
+    std::stringstream timestamp;
+    timestamp << std::put_time(std::localtime(&now), "%Y-%m-%d_%H-%M-%S");
+    std::string filename = "benchmark_results_it" + std::to_string(iterations) + "_" + timestamp.str() + ".txt";
+    std::string histogram_filename = "benchmark_histogram_it" + std::to_string(iterations) + "_" + timestamp.str() + ".csv";
+
+    // Save to file in benchmark_results folder, with the raw histograms next to the report
+    logger.log_to_file(filename, ss.str());
+    std::stringstream csv;
+    csv << LatencyHistogram::csv_header() << "\n";
+    histograms.init.write_csv(csv, "Init");
+    histograms.rspder.write_csv(csv, "RspDer");
+    histograms.der.write_csv(csv, "Der");
+    histograms.total.write_csv(csv, "Total");
+    logger.log_to_file(histogram_filename, csv.str());
+    std::cout << "\nBenchmark results saved to benchmark_results/sodium/" << filename << std::endl;
+    std::cout << "Latency histograms saved to benchmark_results/sodium/" << histogram_filename << std::endl;
+
+    if (write_json || write_csv)
+    {
+        BenchmarkReport report;
+        report.benchmark = "protoss_timing";
+        report.config = {{"iterations", iterations}, {"num_runs", num_runs}, {"warmup_iterations", warmup_iterations}};
+        report.series = {{"Protoss", "Init", to_us(run_init), &histograms.init},
+                         {"Protoss", "RspDer", to_us(run_rspder), &histograms.rspder},
+                         {"Protoss", "Der", to_us(run_der), &histograms.der},
+                         {"Protoss", "Total", to_us(run_total), &histograms.total}};
+        BenchmarkEnvironment env = BenchmarkEnvironment::collect();
+        std::string stem = "benchmark_results_it" + std::to_string(iterations) + "_" + timestamp.str();
+        if (write_json)
+        {
+            std::stringstream json;
+            report.write_json(json, env);
+            logger.log_to_file(stem + ".json", json.str());
+            std::cout << "JSON report saved to benchmark_results/sodium/" << stem << ".json" << std::endl;
+        }
+        if (write_csv)
+        {
+            std::stringstream csv_report;
+            report.write_csv(csv_report, env);
+            logger.log_to_file(stem + ".csv", csv_report.str());
+            std::cout << "CSV report saved to benchmark_results/sodium/" << stem << ".csv" << std::endl;
+        }
+    }
+
+    return true;
+}
+
+// Batch mode: responder throughput of RspDerBatch against batch size
+static bool run_batch_benchmark(int iterations, int num_runs)
+{
+    const size_t batch_sizes[] = {1, 8, 16, 64, 256, 512, 1024};
+    const size_t max_batch = 1024;
+    const unsigned char P_i[] = {0x00};
+    const unsigned char P_j[] = {0x01};
+
+    protoss::Point V;
+    protoss::hash_to_point(V, "SharedPassword");
+
+    // Pre-generate initiator messages outside the timed region
+    std::vector<protoss::RspDerRequest> requests(max_batch);
+    std::vector<protoss::RspDerResponse> responses(max_batch);
+    std::vector<protoss::State> states(max_batch);
+    for (size_t i = 0; i < max_batch; i++)
+    {
+        protoss::Init(requests[i].I, states[i], V, P_i, P_j);
+        requests[i].V = V;
+        requests[i].P_i = P_i;
+        requests[i].P_j = P_j;
+    }
+
+    std::cout << "Running batched responder benchmark (" << num_runs << " runs x " << iterations
+              << " handshakes per batch size)..." << std::endl;
+
+    // Baseline: one RspDer call per handshake
+    std::vector<double> single_runs;
+    for (int r = 0; r < num_runs; r++)
+    {
+        protoss::Point R;
+        protoss::SessionKey K;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < iterations; i++)
+            protoss::RspDer(R, K, V, P_i, P_j, requests[i % max_batch].I);
+        auto end = std::chrono::high_resolution_clock::now();
+        single_runs.push_back(iterations / std::chrono::duration<double>(end - start).count());
+    }
+    double mean_single = calc_mean(single_runs);
+
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(1);
+    ss << "Batched RspDer Results with " << iterations << " handshakes x " << num_runs << " runs per batch size\n";
+    ss << "-------------------------\n";
+    ss << "Single RspDer:   " << mean_single << " +/- " << calc_stddev(single_runs) << " handshakes/s\n";
+
+    for (size_t batch_size : batch_sizes)
+    {
+        size_t batches = std::max<size_t>(1, iterations / batch_size);
+        std::span<const protoss::RspDerRequest> batch_requests(requests.data(), batch_size);
+        std::span<protoss::RspDerResponse> batch_responses(responses.data(), batch_size);
+
+        std::vector<double> batch_runs;
+        for (int r = 0; r < num_runs; r++)
+        {
+            auto start = std::chrono::high_resolution_clock::now();
+            for (size_t b = 0; b < batches; b++)
+                protoss::RspDerBatch(batch_requests, batch_responses);
+            auto end = std::chrono::high_resolution_clock::now();
+            batch_runs.push_back(batches * batch_size / std::chrono::duration<double>(end - start).count());
+
+            // Every item must succeed and agree with the initiator's key
+            for (size_t i = 0; i < batch_size; i++)
+            {
+                protoss::SessionKey K_i;
+                if (batch_responses[i].status == protoss::Status::Ok)
+                    protoss::Der(K_i, states[i], batch_responses[i].R);
+                if (batch_responses[i].status != protoss::Status::Ok || K_i != batch_responses[i].K)
+                {
+                    std::cerr << "ERROR: Batched RspDer item " << i << " failed!" << std::endl;
+                    return false;
+                }
+            }
+        }
+
+        double mean_batch = calc_mean(batch_runs);
+        ss << "Batch size " << std::setw(4) << batch_size << ":  " << mean_batch << " +/- " << calc_stddev(batch_runs)
+           << " handshakes/s (" << std::setprecision(3) << (mean_batch / mean_single) << "x single)\n"
+           << std::setprecision(1);
+    }
+
+    // RspDerBatch encodes the R and Z of a whole batch together; compare that
+    // with one encode per point and report the saving per handshake (2 points)
+    std::vector<protoss::ristretto255::GroupElement> points(max_batch);
+    std::vector<protoss::Point> encoded(max_batch);
+    for (size_t i = 0; i < max_batch; i++)
+        protoss::ristretto255::decode(points[i], responses[i].R);
+    ss << "-------------------------\n";
+    ss << "Encoding R and Z, us per handshake: one at a time / batched / saving\n";
+    ss << std::setprecision(3);
+    for (size_t batch_size : {size_t(16), size_t(64), size_t(256), max_batch})
+    {
+        size_t batches = std::max<size_t>(1, iterations / batch_size);
+        std::vector<double> single_us, batch_us;
+        for (int r = 0; r < num_runs; r++)
+        {
+            auto start = std::chrono::high_resolution_clock::now();
+            for (size_t b = 0; b < batches; b++)
+                for (size_t i = 0; i < batch_size; i++)
+                    protoss::ristretto255::encode(encoded[i], points[i]);
+            auto end = std::chrono::high_resolution_clock::now();
+            single_us.push_back(2 * std::chrono::duration<double, std::micro>(end - start).count() / (batches * batch_size));
+
+            start = std::chrono::high_resolution_clock::now();
+            for (size_t b = 0; b < batches; b++)
+                protoss::ristretto255::encode_batch(encoded.data(), points.data(), batch_size);
+            end = std::chrono::high_resolution_clock::now();
+            batch_us.push_back(2 * std::chrono::duration<double, std::micro>(end - start).count() / (batches * batch_size));
+        }
+        double saving = calc_mean(single_us) - calc_mean(batch_us);
+        ss << "Batch size " << std::setw(4) << batch_size << ":  " << calc_mean(single_us) << " / " << calc_mean(batch_us)
+           << " / " << saving << " us (" << std::setprecision(1) << saving / calc_mean(single_us) * 100 << "%)\n"
+           << std::setprecision(3);
+    }
+
+    std::cout << "\n"
+              << ss.str();
+
     auto now = std::time(nullptr);
     std::stringstream filename;
-    filename << "benchmark_results_it" << iterations << "_" << std::put_time(std::localtime(&now), "%Y-%m-%d_%H-%M-%S") << ".txt";
+    filename << "batch_results_it" << iterations << "_" << std::put_time(std::localtime(&now), "%Y-%m-%d_%H-%M-%S") << ".txt";
+    Logger::get_instance().log_to_file(filename.str(), ss.str());
+    std::cout << "\nBatch results saved to benchmark_results/sodium/" << filename.str() << std::endl;
+
+    return true;
+}
 
-    // Save to file in benchmark_results folder
-    logger.log_to_file(filename.str(), ss.str());
-    std::cout << "\nBenchmark results saved to benchmark_results/sodium/" << filename.str() << std::endl;
+// Pins the calling thread to one core, so scaling numbers aren't blurred by migration
+static void pin_current_thread(unsigned core)
+{
+#if defined(_WIN32)
+    SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << (core % (8 * sizeof(DWORD_PTR))));
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)core;
+#endif
+}
+
+// Runs work(thread_index) on `threads` pinned threads released at the same time.
+// Returns the wall-clock seconds until the last thread finished, and each thread's own seconds.
+template <typename Work>
+static double run_on_threads(int threads, Work work, std::vector<double> &thread_seconds)
+{
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    std::atomic<int> ready{0};
+    std::atomic<bool> go{false};
+    thread_seconds.assign(threads, 0.0);
+
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; t++)
+    {
+        pool.emplace_back([&, t]
+                          {
+            pin_current_thread(t % cores);
+            ready.fetch_add(1);
+            while (!go.load(std::memory_order_acquire))
+                std::this_thread::yield();
+            auto start = std::chrono::steady_clock::now();
+            work(t);
+            thread_seconds[t] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(); });
+    }
+
+    while (ready.load() < threads)
+        std::this_thread::yield();
+    auto start = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto &thread : pool)
+        thread.join();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Thread mode: aggregate and per-thread throughput from 1..max_threads threads
+static bool run_thread_benchmark(int iterations, int num_runs, int max_threads)
+{
+    const unsigned char P_i[] = {0x00};
+    const unsigned char P_j[] = {0x01};
+    std::atomic<bool> failed{false};
+
+    // Independent Init/RspDer/Der pipelines, one per thread
+    auto handshakes = [&](int)
+    {
+        try
+        {
+            protoss::Point I, R;
+            protoss::State state;
+            protoss::SessionKey K_i, K_j;
+            for (int i = 0; i < iterations; i++)
+            {
+                protoss::Init(I, state, "SharedPassword", P_i, P_j);
+                protoss::RspDer(R, K_j, "SharedPassword", P_i, P_j, I);
+                protoss::Der(K_i, state, R);
+                if (K_i != K_j)
+                    failed = true;
+            }
+        }
+        catch (const std::exception &)
+        {
+            failed = true;
+        }
+    };
+
+    // Contention probe: libsodium's global randombytes, 64 bytes per call as in scalar generation
+    const int random_calls = iterations * 10;
+    auto random_probe = [&](int)
+    {
+        unsigned char buf[64];
+        for (int i = 0; i < random_calls; i++)
+            randombytes_buf(buf, sizeof buf);
+    };
+
+    // Contention probe: concurrent Logger::log calls, each thread appending to its own buffer
+    const int log_calls = std::max(1, iterations / 10);
+    auto logger_probe = [&](int t)
+    {
+        std::string message = "thread " + std::to_string(t) + " handshake complete";
+        for (int i = 0; i < log_calls; i++)
+            Logger::get_instance().log(LoggingKeyword::DEBUG, message);
+    };
+
+    std::cout << "Running multi-threaded benchmark (1.." << max_threads << " threads, " << num_runs << " runs x "
+              << iterations << " handshakes per thread)..." << std::endl;
+
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(1);
+    ss << "Multi-threaded Results with " << iterations << " handshakes per thread x " << num_runs << " runs, "
+       << std::thread::hardware_concurrency() << " hardware threads\n";
+    ss << "-------------------------\n";
+    ss << "Threads   Aggregate (hs/s)   Per-thread (hs/s)   Efficiency   randombytes (calls/s)   Logger (calls/s)\n";
+
+    double baseline = 0.0;
+    std::vector<double> thread_seconds;
+    for (int threads = 1; threads <= max_threads; threads++)
+    {
+        std::cout << "  " << threads << " thread(s)..." << std::endl;
+        std::vector<double> aggregate_runs, per_thread_runs, random_runs, logger_runs;
+        for (int r = 0; r < num_runs; r++)
+        {
+            double wall = run_on_threads(threads, handshakes, thread_seconds);
+            aggregate_runs.push_back(double(threads) * iterations / wall);
+            for (double seconds : thread_seconds)
+                per_thread_runs.push_back(iterations / seconds);
+
+            wall = run_on_threads(threads, random_probe, thread_seconds);
+            random_runs.push_back(double(threads) * random_calls / wall);
+
+            // Keep the probe's entries off the terminal so it doesn't measure the console
+            Logger::get_instance().set_console_output(false);
+            wall = run_on_threads(threads, logger_probe, thread_seconds);
+            Logger::get_instance().flush();
+            Logger::get_instance().set_console_output(true);
+            logger_runs.push_back(double(threads) * log_calls / wall);
+        }
+        if (failed)
+        {
+            std::cerr << "ERROR: A handshake failed or session keys didn't match!" << std::endl;
+            return false;
+        }
+
+        double aggregate = calc_mean(aggregate_runs);
+        if (threads == 1)
+            baseline = aggregate;
+        ss << std::setw(7) << threads << "   " << std::setw(16) << aggregate << "   " << std::setw(17) << calc_mean(per_thread_runs)
+           << "   " << std::setw(9) << std::setprecision(3) << (aggregate / (threads * baseline) * 100) << "%"
+           << std::setprecision(1) << "   " << std::setw(21) << calc_mean(random_runs)
+           << "   " << std::setw(16) << calc_mean(logger_runs) << "\n";
+    }
+    ss << "-------------------------\n";
+    ss << "Efficiency = aggregate / (threads x single-thread aggregate). randombytes and Logger columns are\n";
+    ss << "aggregate call rates of the shared components under the same thread count.\n";
+
+    std::cout << "\n"
+              << ss.str();
+
+    auto now = std::time(nullptr);
+    std::stringstream filename;
+    filename << "thread_results_it" << iterations << "_t" << max_threads << "_" << std::put_time(std::localtime(&now), "%Y-%m-%d_%H-%M-%S") << ".txt";
+    Logger::get_instance().log_to_file(filename.str(), ss.str());
+    std::cout << "\nThread results saved to benchmark_results/sodium/" << filename.str() << std::endl;
+
+    return true;
+}
+
+static const char TIMING_USAGE[] = "[iterations] [num_runs] [--batch] [--threads N] [--json] [--csv]";
+
+int main(int argc, char *argv[])
+{
+    Logger::get_instance().log(LoggingKeyword::BENCHMARK, "See the benchmark_results/sodium folder for the info of this run.");
+    if (sodium_init() < 0)
+    {
+        std::cerr << "Failed to initialize libsodium" << std::endl;
+        return 1;
+    }
+
+    // Default parameters
+    int iterations = 10000;
+    int num_runs = 10;
+    bool batch_mode = false;
+    int max_threads = 0;
+    bool write_json = false;
+    bool write_csv = false;
+
+    // Parse optional CLI arguments: [iterations] [num_runs] [--batch] [--threads N] [--json] [--csv]
+    std::vector<std::string> positional;
+    for (int a = 1; a < argc; a++)
+    {
+        std::string arg = argv[a];
+        if (arg == "--batch")
+            batch_mode = true;
+        else if (arg == "--threads" && a + 1 < argc)
+        {
+            if (!parse_count(argv[++a], max_threads))
+                return usage_error(argv[0], TIMING_USAGE);
+        }
+        else if (arg == "--json")
+            write_json = true;
+        else if (arg == "--csv")
+            write_csv = true;
+        else
+            positional.push_back(arg);
+    }
+    bool valid = positional.size() <= 2;
+    if (positional.size() >= 1)
+        valid = valid && parse_count(positional[0].c_str(), iterations);
+    if (positional.size() >= 2)
+        valid = valid && parse_count(positional[1].c_str(), num_runs);
+    if (!valid)
+        return usage_error(argv[0], TIMING_USAGE);
+    // The structured reports hold per-phase latencies, which only the phase benchmark measures
+    if ((write_json || write_csv) && (batch_mode || max_threads > 0))
+    {
+        std::cerr << "--json and --csv cannot be combined with --batch or --threads" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Protoss Protocol Timing Benchmark" << std::endl;
+    std::cout << "=================================" << std::endl;
+
+    try
+    {
+        bool ok;
+        if (max_threads > 0)
+            ok = run_thread_benchmark(iterations, num_runs, max_threads);
+        else if (batch_mode)
+            ok = run_batch_benchmark(iterations, num_runs);
+        else
+            ok = run_phase_benchmark(iterations, num_runs, write_json, write_csv);
+        if (!ok)
+            return 1;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Exception: " << e.what() << std::endl;
+        return 1;
+    }
 
+#ifdef _WIN32
+    // Keep the console window open when started by double-clicking the executable
     system("pause");
+#endif
     return 0;
 }
@@ -0,0 +1,137 @@
+#include <sodium.h>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "benchmark_args.hpp"
+#include "benchmark_stats.hpp"
+#include "logger.hpp"
+#include "protoss_protocol.hpp"
+#include "transcript_hasher.hpp"
+
+// Transcript fields for one measurement, identities of the given length
+struct Transcript
+{
+    std::vector<unsigned char> Z, I, R, P_i, P_j, V;
+    explicit Transcript(size_t id_len)
+        : Z(POINT_LEN), I(POINT_LEN), R(POINT_LEN), P_i(id_len), P_j(id_len), V(POINT_LEN)
+    {
+        for (auto *field : {&Z, &I, &R, &P_i, &P_j, &V})
+            randombytes_buf(field->data(), field->size());
+    }
+};
+
+// Previous path: concatenate all fields into a fresh buffer, then hash in one shot
+static void hash_concatenated(protoss::SessionKey &K, const Transcript &t)
+{
+    auto concat = concatenate_vectors({t.Z, t.I, t.R, t.P_i, t.P_j, t.V});
+    unsigned char full_hash[crypto_hash_sha512_BYTES];
+    crypto_hash_sha512(full_hash, concat.data(), concat.size());
+    std::copy(full_hash, full_hash + SESSION_KEY_LEN, K.begin());
+}
+
+// Current path: stream the fields through the transcript hasher
+static void hash_streaming(protoss::SessionKey &K, const Transcript &t)
+{
+    protoss::TranscriptHasher hasher;
+    hasher.absorb(t.Z).absorb(t.I).absorb(t.R).absorb(t.P_i).absorb(t.P_j).absorb(t.V);
+    hasher.finalize(K);
+}
+
+// Returns the average time per transcript hash in microseconds
+template <typename HashFn>
+static double time_path(HashFn hash_fn, const Transcript &t, int iterations)
+{
+    protoss::SessionKey K;
+    unsigned char sink = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; i++)
+    {
+        hash_fn(K, t);
+        sink ^= K[0];
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    volatile unsigned char keep = sink;
+    (void)keep;
+    return std::chrono::duration<double, std::micro>(end - start).count() / iterations;
+}
+
+int main(int argc, char *argv[])
+{
+    if (sodium_init() < 0)
+    {
+        std::cerr << "Failed to initialize libsodium" << std::endl;
+        return 1;
+    }
+
+    // Parse optional CLI arguments: [iterations] [num_runs]
+    int iterations = 100000;
+    int num_runs = 10;
+    bool valid = argc <= 3;
+    if (argc >= 2)
+        valid = valid && parse_count(argv[1], iterations);
+    if (argc >= 3)
+        valid = valid && parse_count(argv[2], num_runs);
+    if (!valid)
+        return usage_error(argv[0], "[iterations] [num_runs]");
+
+    std::cout << "Protoss Transcript Hash Benchmark" << std::endl;
+    std::cout << "=================================" << std::endl;
+
+    const size_t id_lengths[] = {1, 32, 256, 1024, 4096};
+
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(3);
+    ss << "Transcript Hash Results with " << iterations << " iterations x " << num_runs << " runs\n";
+    ss << "Transcript: Z || I || R || P_i || P_j || V, with |P_i| = |P_j| = identity length\n";
+    ss << "-------------------------\n";
+
+    for (size_t id_len : id_lengths)
+    {
+        Transcript t(id_len);
+
+        // Both paths must produce the same session key
+        protoss::SessionKey K_concat, K_stream;
+        hash_concatenated(K_concat, t);
+        hash_streaming(K_stream, t);
+        if (K_concat != K_stream)
+        {
+            std::cerr << "ERROR: Streaming and concatenated transcript hashes differ!" << std::endl;
+            return 1;
+        }
+
+        std::cout << "Identity length " << id_len << " bytes..." << std::endl;
+        time_path(hash_concatenated, t, iterations / 10 + 1);
+        time_path(hash_streaming, t, iterations / 10 + 1);
+
+        std::vector<double> concat_runs, stream_runs;
+        for (int r = 0; r < num_runs; r++)
+        {
+            concat_runs.push_back(time_path(hash_concatenated, t, iterations));
+            stream_runs.push_back(time_path(hash_streaming, t, iterations));
+        }
+
+        double mean_concat = calc_mean(concat_runs);
+        double mean_stream = calc_mean(stream_runs);
+        ss << "Identity length " << id_len << " bytes:\n";
+        ss << "  Concatenated: " << mean_concat << " +/- " << calc_stddev(concat_runs) << " us\n";
+        ss << "  Streaming:    " << mean_stream << " +/- " << calc_stddev(stream_runs) << " us\n";
+        ss << "  Saving:       " << ((mean_concat - mean_stream) / mean_concat * 100) << "%\n";
+    }
+
+    std::cout << "\n"
+              << ss.str();
+
+    auto now = std::time(nullptr);
+    std::stringstream filename;
+    filename << "transcript_results_it" << iterations << "_" << std::put_time(std::localtime(&now), "%Y-%m-%d_%H-%M-%S") << ".txt";
+    Logger::get_instance().log_to_file(filename.str(), ss.str());
+    std::cout << "\nTranscript results saved to benchmark_results/sodium/" << filename.str() << std::endl;
+
+    return 0;
+}
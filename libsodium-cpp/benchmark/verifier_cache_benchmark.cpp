@@ -0,0 +1,195 @@
+#include <sodium.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "benchmark_args.hpp"
+#include "benchmark_stats.hpp"
+#include "logger.hpp"
+#include "protoss_protocol.hpp"
+#include "verifier_cache.hpp"
+
+// One device credential and a pre-generated initiator message for it
+struct Credential
+{
+    std::string id;
+    std::string password;
+    protoss::Point I;
+};
+
+// Draws credential indices with a Zipf(1) distribution, so a few credentials are hot
+static std::vector<size_t> make_access_pattern(size_t credentials, size_t handshakes)
+{
+    std::vector<double> cdf(credentials);
+    double total = 0.0;
+    for (size_t k = 0; k < credentials; k++)
+    {
+        total += 1.0 / double(k + 1);
+        cdf[k] = total;
+    }
+
+    std::vector<size_t> pattern(handshakes);
+    for (auto &index : pattern)
+    {
+        double u = double(randombytes_random()) / 4294967296.0 * total;
+        index = std::lower_bound(cdf.begin(), cdf.end(), u) - cdf.begin();
+        if (index >= credentials)
+            index = credentials - 1;
+    }
+    return pattern;
+}
+
+// Uncached: RspDer hashes the password on every handshake. Returns us per handshake.
+static double run_uncached(const std::vector<Credential> &creds, const std::vector<size_t> &pattern)
+{
+    const unsigned char P_i[] = {0x00};
+    const unsigned char P_j[] = {0x01};
+    protoss::Point R;
+    protoss::SessionKey K;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t index : pattern)
+    {
+        const Credential &c = creds[index];
+        protoss::RspDer(R, K, c.password, P_i, P_j, c.I);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count() / pattern.size();
+}
+
+// Cached: look V up by credential ID, hashing only on a miss. Returns us per handshake.
+static double run_cached(protoss::VerifierCache &cache, const std::vector<Credential> &creds, const std::vector<size_t> &pattern)
+{
+    const unsigned char P_i[] = {0x00};
+    const unsigned char P_j[] = {0x01};
+    protoss::Point R, V;
+    protoss::SessionKey K;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t index : pattern)
+    {
+        const Credential &c = creds[index];
+        cache.get(V, c.id, c.password);
+        protoss::RspDer(R, K, V, P_i, P_j, c.I);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count() / pattern.size();
+}
+
+int main(int argc, char *argv[])
+{
+    if (sodium_init() < 0)
+    {
+        std::cerr << "Failed to initialize libsodium" << std::endl;
+        return 1;
+    }
+
+    // Parse optional CLI arguments: [handshakes] [credentials] [capacity] [ttl_ms] [num_runs]
+    size_t handshakes = 100000;
+    size_t credentials = 256;
+    size_t capacity = 64;
+    long long ttl_ms = 0;
+    int num_runs = 4;
+    bool valid = argc <= 6;
+    if (argc >= 2)
+        valid = valid && parse_count(argv[1], handshakes);
+    if (argc >= 3)
+        valid = valid && parse_count(argv[2], credentials);
+    if (argc >= 4)
+        valid = valid && parse_count(argv[3], capacity);
+    if (argc >= 5)
+        valid = valid && parse_count(argv[4], ttl_ms, 0);
+    if (argc >= 6)
+        valid = valid && parse_count(argv[5], num_runs);
+    if (!valid)
+        return usage_error(argv[0], "[handshakes] [credentials] [capacity] [ttl_ms] [num_runs]");
+
+    std::cout << "Protoss Verifier Cache Benchmark" << std::endl;
+    std::cout << "================================" << std::endl;
+
+    const unsigned char P_i[] = {0x00};
+    const unsigned char P_j[] = {0x01};
+
+    // Pre-generate credentials and one initiator message per credential outside the timed region
+    std::vector<Credential> creds(credentials);
+    for (size_t k = 0; k < credentials; k++)
+    {
+        creds[k].id = "device-" + std::to_string(k);
+        creds[k].password = "password-" + std::to_string(k);
+        protoss::State state;
+        protoss::Init(creds[k].I, state, creds[k].password, P_i, P_j);
+    }
+    std::vector<size_t> pattern = make_access_pattern(credentials, handshakes);
+
+    protoss::VerifierCache cache(capacity, std::chrono::milliseconds(ttl_ms));
+
+    try
+    {
+        // Alternate the order of the two paths between runs to avoid ordering bias
+        std::vector<double> uncached_runs, cached_runs;
+        for (int r = 1; r <= num_runs; r++)
+        {
+            if (r % 2 == 1)
+            {
+                uncached_runs.push_back(run_uncached(creds, pattern));
+                cached_runs.push_back(run_cached(cache, creds, pattern));
+            }
+            else
+            {
+                cached_runs.push_back(run_cached(cache, creds, pattern));
+                uncached_runs.push_back(run_uncached(creds, pattern));
+            }
+        }
+        double uncached_us = calc_mean(uncached_runs);
+        double cached_us = calc_mean(cached_runs);
+
+        // Cost of the work a cache hit avoids
+        protoss::Point V;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t index : pattern)
+            protoss::hash_to_point(V, creds[index].password);
+        auto end = std::chrono::high_resolution_clock::now();
+        double hash_us = std::chrono::duration<double, std::micro>(end - start).count() / handshakes;
+
+        protoss::VerifierCache::Stats stats = cache.stats();
+        double lookups = double(stats.hits + stats.misses);
+
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(3);
+        ss << "Verifier Cache Results with " << handshakes << " handshakes x " << num_runs << " runs over " << credentials
+           << " credentials (Zipf access), capacity " << capacity << ", TTL "
+           << (ttl_ms > 0 ? std::to_string(ttl_ms) + " ms" : std::string("disabled")) << "\n";
+        ss << "-------------------------\n";
+        ss << "Hits:            " << stats.hits << " (" << (stats.hits / lookups * 100) << "%)\n";
+        ss << "Misses:          " << stats.misses << " (" << (stats.misses / lookups * 100) << "%)\n";
+        ss << "Evictions:       " << stats.evictions << "\n";
+        ss << "Expirations:     " << stats.expirations << "\n";
+        ss << "-------------------------\n";
+        ss << "hash_to_point:   " << hash_us << " us\n";
+        ss << "RspDer uncached: " << uncached_us << " +/- " << calc_stddev(uncached_runs) << " us per handshake\n";
+        ss << "RspDer cached:   " << cached_us << " +/- " << calc_stddev(cached_runs) << " us per handshake\n";
+        ss << "Saving:          " << (uncached_us - cached_us) << " us per handshake ("
+           << ((uncached_us - cached_us) / uncached_us * 100) << "%)\n";
+        std::cout << "\n"
+                  << ss.str();
+
+        auto now = std::time(nullptr);
+        std::stringstream filename;
+        filename << "verifier_cache_results_hs" << handshakes << "_" << std::put_time(std::localtime(&now), "%Y-%m-%d_%H-%M-%S") << ".txt";
+        Logger::get_instance().log_to_file(filename.str(), ss.str());
+        std::cout << "\nVerifier cache results saved to benchmark_results/sodium/" << filename.str() << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,174 @@
+#include <sodium.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "benchmark_args.hpp"
+#include "logger.hpp"
+#include "protoss_protocol.hpp"
+#include "verifier_record.hpp"
+
+// A pre-generated initiator message for one credential
+struct PendingHandshake
+{
+    std::string id;
+    std::string password;
+    protoss::Point I;
+};
+
+static double elapsed_ms(std::chrono::high_resolution_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+int main(int argc, char *argv[])
+{
+    if (sodium_init() < 0)
+    {
+        std::cerr << "Failed to initialize libsodium" << std::endl;
+        return 1;
+    }
+
+    // Parse optional CLI arguments: [records] [handshakes]
+    size_t num_records = 1000000;
+    size_t handshakes = 20000;
+    bool valid = argc <= 3;
+    if (argc >= 2)
+        valid = valid && parse_count(argv[1], num_records);
+    if (argc >= 3)
+        valid = valid && parse_count(argv[2], handshakes);
+    if (!valid)
+        return usage_error(argv[0], "[records] [handshakes]");
+
+    std::cout << "Protoss Verifier Record Benchmark" << std::endl;
+    std::cout << "=================================" << std::endl;
+
+    std::filesystem::create_directory("benchmark_results");
+    std::filesystem::create_directory("benchmark_results/sodium");
+    const std::string path = "benchmark_results/sodium/verifier_records.bin";
+
+    const unsigned char P_i[] = {0x00};
+    const unsigned char P_j[] = {0x01};
+    protoss::VerifierParams sha512_params;
+
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(3);
+
+    try
+    {
+        // Offline generation of the verifier file
+        std::cout << "Generating " << num_records << " verifier records..." << std::endl;
+        auto start = std::chrono::high_resolution_clock::now();
+        std::vector<protoss::VerifierRecord> records;
+        records.reserve(num_records);
+        for (size_t k = 0; k < num_records; k++)
+            records.push_back(protoss::make_verifier_record("device-" + std::to_string(k), 1,
+                                                            "password-" + std::to_string(k), sha512_params));
+        double generate_ms = elapsed_ms(start);
+
+        start = std::chrono::high_resolution_clock::now();
+        protoss::write_verifier_file(path, records);
+        double write_ms = elapsed_ms(start);
+        records.clear();
+        records.shrink_to_fit();
+
+        // Cost of the optional Argon2id stretch, which only ever runs offline
+        const int argon2_samples = 3;
+        protoss::VerifierParams argon2_params;
+        argon2_params.kdf = protoss::VerifierKdf::Argon2id;
+        argon2_params.opslimit = crypto_pwhash_OPSLIMIT_INTERACTIVE;
+        argon2_params.memlimit_kib = crypto_pwhash_MEMLIMIT_INTERACTIVE / 1024;
+        randombytes_buf(argon2_params.salt.data(), argon2_params.salt.size());
+        start = std::chrono::high_resolution_clock::now();
+        for (int k = 0; k < argon2_samples; k++)
+            protoss::make_verifier_record("device-argon2", 1, "password-argon2", argon2_params);
+        double argon2_ms = elapsed_ms(start) / argon2_samples;
+
+        // Bulk load on the responder, with and without point validation
+        std::cout << "Loading verifier file..." << std::endl;
+        start = std::chrono::high_resolution_clock::now();
+        {
+            protoss::VerifierStore unvalidated = protoss::VerifierStore::load(path, false);
+        }
+        double load_unvalidated_ms = elapsed_ms(start);
+
+        start = std::chrono::high_resolution_clock::now();
+        protoss::VerifierStore store = protoss::VerifierStore::load(path, true);
+        double load_ms = elapsed_ms(start);
+        std::filesystem::remove(path);
+
+        // Pre-generate initiator messages for random credentials outside the timed region
+        std::cout << "Running " << handshakes << " handshakes..." << std::endl;
+        std::vector<PendingHandshake> pending(std::min<size_t>(handshakes, 1024));
+        for (auto &p : pending)
+        {
+            size_t k = randombytes_uniform((uint32_t)num_records);
+            p.id = "device-" + std::to_string(k);
+            p.password = "password-" + std::to_string(k);
+            protoss::State state;
+            protoss::Init(p.I, state, p.password, P_i, P_j);
+        }
+
+        protoss::Point R;
+        protoss::SessionKey K;
+
+        // Responder hashing the cleartext password
+        start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < handshakes; i++)
+        {
+            const PendingHandshake &p = pending[i % pending.size()];
+            protoss::RspDer(R, K, p.password, P_i, P_j, p.I);
+        }
+        double password_us = elapsed_ms(start) * 1000.0 / handshakes;
+
+        // Responder looking the verifier record up
+        start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < handshakes; i++)
+        {
+            const PendingHandshake &p = pending[i % pending.size()];
+            const protoss::VerifierRecord *record = store.find(p.id);
+            if (!record)
+                throw std::runtime_error("missing verifier record for " + p.id);
+            protoss::RspDer(R, K, record->V, P_i, P_j, p.I);
+        }
+        double record_us = elapsed_ms(start) * 1000.0 / handshakes;
+
+        ss << "Verifier Record Results with " << num_records << " records, " << handshakes << " handshakes\n";
+        ss << "Record size: " << protoss::VERIFIER_RECORD_LEN << " bytes, file size: "
+           << (num_records * protoss::VERIFIER_RECORD_LEN / (1024.0 * 1024.0)) << " MiB\n";
+        ss << "-------------------------\n";
+        ss << "Generate (SHA-512):       " << generate_ms << " ms (" << (generate_ms * 1000.0 / num_records) << " us per record)\n";
+        ss << "Generate (Argon2id):      " << argon2_ms << " ms per record (interactive limits)\n";
+        ss << "Write file:               " << write_ms << " ms\n";
+        ss << "Load, no validation:      " << load_unvalidated_ms << " ms\n";
+        ss << "Load, validated:          " << load_ms << " ms (" << (load_ms * 1000.0 / num_records) << " us per record)\n";
+        ss << "-------------------------\n";
+        ss << "RspDer from password:     " << password_us << " us per handshake\n";
+        ss << "RspDer from record:       " << record_us << " us per handshake (lookup included)\n";
+        ss << "Saving:                   " << (password_us - record_us) << " us per handshake ("
+           << ((password_us - record_us) / password_us * 100) << "%)\n";
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Exception: " << e.what() << std::endl;
+        std::filesystem::remove(path);
+        return 1;
+    }
+
+    std::cout << "\n"
+              << ss.str();
+
+    auto now = std::time(nullptr);
+    std::stringstream filename;
+    filename << "verifier_record_results_n" << num_records << "_" << std::put_time(std::localtime(&now), "%Y-%m-%d_%H-%M-%S") << ".txt";
+    Logger::get_instance().log_to_file(filename.str(), ss.str());
+    std::cout << "\nVerifier record results saved to benchmark_results/sodium/" << filename.str() << std::endl;
+
+    return 0;
+}
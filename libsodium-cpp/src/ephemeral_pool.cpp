@@ -0,0 +1,164 @@
+#include "ephemeral_pool.hpp"
+
+namespace protoss
+{
+    static size_t round_up_pow2(size_t n)
+    {
+        size_t p = 2;
+        while (p < n)
+            p <<= 1;
+        return p;
+    }
+
+    EphemeralPool::EphemeralPool(size_t capacity, unsigned refill_threads)
+        : mask_(round_up_pow2(capacity) - 1), slots_(new Slot[mask_ + 1])
+    {
+        if (capacity == 0)
+            throw std::invalid_argument("EphemeralPool capacity must be positive");
+        for (size_t i = 0; i <= mask_; i++)
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        for (unsigned t = 0; t < refill_threads; t++)
+            refillers_.emplace_back(&EphemeralPool::refill_loop, this);
+    }
+
+    EphemeralPool::~EphemeralPool()
+    {
+        stop_.store(true);
+        refill_signal_.fetch_add(1);
+        refill_signal_.notify_all();
+        for (auto &thread : refillers_)
+            thread.join();
+        // Pairs still in the pool are wiped by the Ephemeral destructors
+    }
+
+    bool EphemeralPool::try_put(const Ephemeral &e) noexcept
+    {
+        size_t pos = tail_.load(std::memory_order_relaxed);
+        Slot *slot;
+        for (;;)
+        {
+            slot = &slots_[pos & mask_];
+            size_t seq = slot->sequence.load(std::memory_order_acquire);
+            intptr_t diff = intptr_t(seq) - intptr_t(pos);
+            if (diff == 0)
+            {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+                return false; // Full
+            else
+                pos = tail_.load(std::memory_order_relaxed);
+        }
+
+        slot->pair.s = e.s;
+        slot->pair.S = e.S;
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool EphemeralPool::try_take(Ephemeral &e) noexcept
+    {
+        size_t pos = head_.load(std::memory_order_relaxed);
+        Slot *slot;
+        for (;;)
+        {
+            slot = &slots_[pos & mask_];
+            size_t seq = slot->sequence.load(std::memory_order_acquire);
+            intptr_t diff = intptr_t(seq) - intptr_t(pos + 1);
+            if (diff == 0)
+            {
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+                return false; // Empty
+            else
+                pos = head_.load(std::memory_order_relaxed);
+        }
+
+        // Each pair is used once: copy it out and wipe the slot before releasing it
+        e.s = slot->pair.s;
+        e.S = slot->pair.S;
+        sodium_memzero(slot->pair.s.data(), SCALAR_LEN);
+        sodium_memzero(slot->pair.S.data(), POINT_LEN);
+        slot->sequence.store(pos + mask_ + 1, std::memory_order_release);
+        consumed_.fetch_add(1, std::memory_order_relaxed);
+
+        // Wake the refill threads once the pool has drained to half, rather than on every take
+        if (tail_.load(std::memory_order_relaxed) - (pos + 1) == capacity() / 2)
+        {
+            refill_signal_.fetch_add(1);
+            refill_signal_.notify_all();
+        }
+        return true;
+    }
+
+    void EphemeralPool::take(Ephemeral &e)
+    {
+        if (try_take(e))
+            return;
+        fallbacks_.fetch_add(1, std::memory_order_relaxed);
+        generate_ephemeral(e);
+    }
+
+    void EphemeralPool::fill()
+    {
+        Ephemeral e;
+        for (;;)
+        {
+            generate_ephemeral(e);
+            if (!try_put(e))
+                return;
+            produced_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void EphemeralPool::refill_loop()
+    {
+        Ephemeral e;
+        bool pending = false;
+        while (!stop_.load())
+        {
+            if (!pending)
+            {
+                try
+                {
+                    generate_ephemeral(e);
+                }
+                catch (const std::exception &)
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+                pending = true;
+            }
+
+            // Read the signal before trying, so a drain between the two isn't missed
+            uint32_t seen = refill_signal_.load();
+            if (try_put(e))
+            {
+                pending = false;
+                produced_.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            refill_signal_.wait(seen);
+        }
+    }
+
+    size_t EphemeralPool::size() const
+    {
+        size_t head = head_.load(std::memory_order_relaxed);
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+
+    EphemeralPool::Stats EphemeralPool::stats() const
+    {
+        Stats stats;
+        stats.produced = produced_.load(std::memory_order_relaxed);
+        stats.consumed = consumed_.load(std::memory_order_relaxed);
+        stats.fallbacks = fallbacks_.load(std::memory_order_relaxed);
+        return stats;
+    }
+}
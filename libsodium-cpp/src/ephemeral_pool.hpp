@@ -0,0 +1,74 @@
+#ifndef EPHEMERAL_POOL_HPP
+#define EPHEMERAL_POOL_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "protoss_protocol.hpp"
+
+namespace protoss
+{
+    // Bounded pool of precomputed ephemeral pairs (s, g^s) for Init and RspDer.
+    // Background threads keep it topped up; handshakes take pairs without
+    // locking (a fixed-size multi-producer multi-consumer ring). Each pair is
+    // handed out once and its slot is wiped as it is taken. take() falls back
+    // to generating the pair inline when the pool is empty, so an exhausted
+    // pool costs latency, never correctness.
+    class EphemeralPool
+    {
+    public:
+        struct Stats
+        {
+            uint64_t produced = 0;  // Pairs generated by the refill threads or fill()
+            uint64_t consumed = 0;  // Pairs taken from the pool
+            uint64_t fallbacks = 0; // take() calls that found the pool empty
+        };
+
+        // capacity is rounded up to a power of two. With refill_threads = 0
+        // the pool is only filled by explicit fill() calls.
+        explicit EphemeralPool(size_t capacity, unsigned refill_threads = 1);
+        ~EphemeralPool();
+        EphemeralPool(const EphemeralPool &) = delete;
+        EphemeralPool &operator=(const EphemeralPool &) = delete;
+
+        // Moves a pooled pair into e; returns false if the pool is empty
+        bool try_take(Ephemeral &e) noexcept;
+
+        // Moves a pooled pair into e, or generates one inline if the pool is empty
+        void take(Ephemeral &e);
+
+        // Generates pairs on the calling thread until the pool is full
+        void fill();
+
+        size_t capacity() const { return mask_ + 1; }
+        size_t size() const;
+        Stats stats() const;
+
+    private:
+        struct alignas(64) Slot
+        {
+            std::atomic<size_t> sequence;
+            Ephemeral pair;
+        };
+
+        bool try_put(const Ephemeral &e) noexcept;
+        void refill_loop();
+
+        size_t mask_;
+        std::unique_ptr<Slot[]> slots_;
+        alignas(64) std::atomic<size_t> head_{0}; // Next slot to take
+        alignas(64) std::atomic<size_t> tail_{0}; // Next slot to fill
+
+        alignas(64) std::atomic<uint64_t> produced_{0};
+        std::atomic<uint64_t> consumed_{0};
+        std::atomic<uint64_t> fallbacks_{0};
+
+        std::atomic<uint32_t> refill_signal_{0}; // Bumped to wake refill threads waiting on a full pool
+        std::atomic<bool> stop_{false};
+        std::vector<std::thread> refillers_;
+    };
+}
+
+#endif // EPHEMERAL_POOL_HPP
@@ -1,4 +1,5 @@
 #include "logger.hpp"
+#include <algorithm>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
@@ -7,24 +8,34 @@
 #include <filesystem>
 
 Logger::Logger()
+    : wall_epoch_(std::chrono::system_clock::now()), steady_epoch_(std::chrono::steady_clock::now())
 {
-    logs_.reserve(1000);
+    drainer_ = std::thread(&Logger::drain_loop, this);
 }
 
 Logger::~Logger()
 {
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        stop_ = true;
+    }
+    wake_.notify_one();
+    drainer_.join();
+    flush();
+
     // Creates logs folder to put the different loggings in there
     std::filesystem::create_directory("logs");
     std::filesystem::create_directory("logs/sodium");
-    auto now = std::time(nullptr);
-    std::stringstream ss;
-    ss << std::put_time(std::localtime(&now), "logs/sodium/log_%Y-%m-%d_%H-%M-%S.txt");
-    std::ofstream file(ss.str(), std::ios::out | std::ios::trunc);
+    std::string path = format_timestamp(std::chrono::system_clock::now(), "logs/sodium/log_%Y-%m-%d_%H-%M-%S.txt");
+    std::ofstream file(path, std::ios::out | std::ios::trunc);
     if (file.is_open())
     {
-        for (const auto &log : logs_)
+        if (dropped_ > 0)
+            file << "[" << dropped_ << " older entries dropped]\n";
+        for (const auto &entry : logs_)
         {
-            file << log << '\n';
+            file << "[" << format_timestamp(wall_time(entry.time), "%Y-%m-%d %H:%M:%S") << "] "
+                 << keyword_name(entry.keyword) << " : " << entry.description << '\n';
         }
         file.close();
     }
@@ -36,41 +47,153 @@ Logger &Logger::get_instance()
     return instance;
 }
 
-std::string Logger::get_timestamp()
+const char *Logger::keyword_name(LoggingKeyword keyword)
+{
+    switch (keyword)
+    {
+    case LoggingKeyword::INFO:
+        return "INFO";
+    case LoggingKeyword::ERROR:
+        return "ERROR";
+    case LoggingKeyword::DEBUG:
+        return "DEBUG";
+    case LoggingKeyword::BENCHMARK:
+        return "BENCHMARK";
+    }
+    return "UNKNOWN";
+}
+
+std::string Logger::format_timestamp(std::chrono::system_clock::time_point time, const char *format)
 {
-    auto now = std::time(nullptr);
+    std::time_t t = std::chrono::system_clock::to_time_t(time);
+    std::tm tm{};
+#ifdef _WIN32
+    localtime_s(&tm, &t);
+#else
+    localtime_r(&t, &tm);
+#endif
     std::stringstream ss;
-    ss << std::put_time(std::localtime(&now), "%Y-%m-%d %H:%M:%S");
+    ss << std::put_time(&tm, format);
     return ss.str();
 }
 
+std::chrono::system_clock::time_point Logger::wall_time(std::chrono::steady_clock::time_point time) const
+{
+    return wall_epoch_ + std::chrono::duration_cast<std::chrono::system_clock::duration>(time - steady_epoch_);
+}
+
+Logger::RingBuffer &Logger::local_buffer()
+{
+    thread_local std::shared_ptr<RingBuffer> buffer;
+    if (!buffer)
+    {
+        buffer = std::make_shared<RingBuffer>();
+        std::lock_guard<std::mutex> lock(buffers_mutex_);
+        buffers_.push_back(buffer);
+    }
+    return *buffer;
+}
+
 void Logger::log(LoggingKeyword keyword, const std::string &description)
 {
-    std::string keyword_str;
-    switch (keyword)
+    RingBuffer &ring = local_buffer();
+    size_t tail = ring.tail.load(std::memory_order_relaxed);
+
+    // Wait for the drainer if this thread's ring is full
+    while (tail - ring.head.load(std::memory_order_acquire) >= RING_CAPACITY)
     {
-    case LoggingKeyword::INFO:
-        keyword_str = "INFO";
-        break;
-    case LoggingKeyword::ERROR:
-        keyword_str = "ERROR";
-        break;
-    case LoggingKeyword::DEBUG:
-        keyword_str = "DEBUG";
-        break;
-    case LoggingKeyword::BENCHMARK:
-        keyword_str = "BENCHMARK";
-        break;
+        wake_.notify_one();
+        std::this_thread::yield();
+    }
+
+    Entry &slot = ring.slots[tail % RING_CAPACITY];
+    slot.keyword = keyword;
+    slot.time = std::chrono::steady_clock::now();
+    slot.description = description;
+    ring.tail.store(tail + 1, std::memory_order_release);
+}
+
+void Logger::flush()
+{
+    std::lock_guard<std::mutex> lock(drain_mutex_);
+    drain_locked();
+}
+
+void Logger::set_console_output(bool enabled)
+{
+    console_output_.store(enabled);
+}
+
+void Logger::drain_loop()
+{
+    std::unique_lock<std::mutex> lock(wake_mutex_);
+    while (!stop_)
+    {
+        wake_.wait_for(lock, std::chrono::milliseconds(20));
+        lock.unlock();
+        flush();
+        lock.lock();
+    }
+}
+
+void Logger::drain_locked()
+{
+    std::vector<std::shared_ptr<RingBuffer>> buffers;
+    {
+        std::lock_guard<std::mutex> lock(buffers_mutex_);
+        buffers = buffers_;
     }
-    std::string log_entry = "[" + get_timestamp() + "] " + keyword_str + " : " + description;
-    logs_.push_back(log_entry);
 
-    auto epoch = std::time(nullptr);
-    std::cout << "[" << keyword_str << " - " << epoch << "] " << description << std::endl;
+    // Collect everything published so far, then release the slots to the producers
+    std::vector<Entry> drained;
+    for (auto &ring : buffers)
+    {
+        size_t head = ring->head.load(std::memory_order_relaxed);
+        size_t tail = ring->tail.load(std::memory_order_acquire);
+        for (; head != tail; head++)
+            drained.push_back(std::move(ring->slots[head % RING_CAPACITY]));
+        ring->head.store(head, std::memory_order_release);
+    }
+
+    // Forget rings whose thread has exited and that are now empty
+    {
+        std::lock_guard<std::mutex> lock(buffers_mutex_);
+        buffers_.erase(std::remove_if(buffers_.begin(), buffers_.end(), [](const std::shared_ptr<RingBuffer> &ring)
+                                      { return ring.use_count() <= 2 &&
+                                               ring->head.load() == ring->tail.load(); }),
+                       buffers_.end());
+    }
+    if (drained.empty())
+        return;
+
+    std::stable_sort(drained.begin(), drained.end(), [](const Entry &a, const Entry &b)
+                     { return a.time < b.time; });
+
+    if (console_output_.load())
+    {
+        std::string out;
+        for (const auto &entry : drained)
+        {
+            auto epoch = std::chrono::system_clock::to_time_t(wall_time(entry.time));
+            out += "[" + std::string(keyword_name(entry.keyword)) + " - " + std::to_string(epoch) + "] " + entry.description + '\n';
+        }
+        std::cout << out << std::flush;
+    }
+
+    for (auto &entry : drained)
+    {
+        if (logs_.size() >= MAX_RETAINED_ENTRIES)
+        {
+            logs_.pop_front();
+            dropped_++;
+        }
+        logs_.push_back(std::move(entry));
+    }
 }
 
 void Logger::log_to_file(const std::string &filename, const std::string &content)
 {
+    std::lock_guard<std::mutex> lock(file_mutex_);
     std::filesystem::create_directory("benchmark_results");
     std::filesystem::create_directory("benchmark_results/sodium");
 
@@ -80,4 +203,4 @@ void Logger::log_to_file(const std::string &filename, const std::string &content
         file << content << std::endl;
         file.close();
     }
-}
\ No newline at end of file
+}
@@ -1,7 +1,14 @@
 #ifndef LOGGER_HPP
 #define LOGGER_HPP
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 enum class LoggingKeyword
@@ -12,20 +19,71 @@ enum class LoggingKeyword
     BENCHMARK
 };
 
+// Thread-safe logger. log() only appends to a per-thread ring buffer; a
+// background thread drains the buffers, echoes entries to the console and
+// retains at most MAX_RETAINED_ENTRIES of them for the log file written on
+// shutdown. Timestamps are taken from the monotonic clock and only formatted
+// when an entry is written out.
 class Logger
 {
 public:
+    static constexpr size_t RING_CAPACITY = 1024;           // Entries per thread before log() waits for the drainer
+    static constexpr size_t MAX_RETAINED_ENTRIES = 100000;  // Oldest entries are dropped beyond this
+
     static Logger &get_instance();
     void log(LoggingKeyword keyword, const std::string &description);
     void log_to_file(const std::string &filename, const std::string &content);
+
+    // Blocks until every entry logged before the call has been drained
+    void flush();
+
+    // Enables or disables echoing drained entries to the console
+    void set_console_output(bool enabled);
+
     Logger(const Logger &) = delete;
     Logger &operator=(const Logger &) = delete;
 
 private:
+    struct Entry
+    {
+        LoggingKeyword keyword;
+        std::chrono::steady_clock::time_point time;
+        std::string description;
+    };
+
+    // Single-producer single-consumer ring: the owning thread pushes, the drain side pops
+    struct RingBuffer
+    {
+        Entry slots[RING_CAPACITY];
+        std::atomic<size_t> head{0}; // Next slot to drain
+        std::atomic<size_t> tail{0}; // Next slot to fill
+    };
+
     Logger();
     ~Logger();
-    std::vector<std::string> logs_;
-    static std::string get_timestamp();
+    RingBuffer &local_buffer();
+    void drain_loop();
+    void drain_locked();
+    std::chrono::system_clock::time_point wall_time(std::chrono::steady_clock::time_point time) const;
+    static const char *keyword_name(LoggingKeyword keyword);
+    static std::string format_timestamp(std::chrono::system_clock::time_point time, const char *format);
+
+    std::mutex buffers_mutex_; // Guards buffers_
+    std::vector<std::shared_ptr<RingBuffer>> buffers_;
+
+    std::mutex drain_mutex_; // Serializes consumers; guards logs_ and dropped_
+    std::deque<Entry> logs_;
+    size_t dropped_ = 0;
+
+    std::mutex file_mutex_;
+    std::atomic<bool> console_output_{true};
+    const std::chrono::system_clock::time_point wall_epoch_;
+    const std::chrono::steady_clock::time_point steady_epoch_;
+
+    std::mutex wake_mutex_;
+    std::condition_variable wake_;
+    bool stop_ = false;
+    std::thread drainer_;
 };
 
-#endif // LOGGER_HPP
\ No newline at end of file
+#endif // LOGGER_HPP
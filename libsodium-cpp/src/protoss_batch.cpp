@@ -0,0 +1,234 @@
+#include "protoss_batch.hpp"
+#include "ristretto255.hpp"
+#include "ristretto255_lanes.hpp"
+#include "scalar_drbg.hpp"
+#include "transcript_hasher.hpp"
+#include <algorithm>
+#include <vector>
+
+namespace protoss
+{
+    namespace
+    {
+        using ristretto255::GroupElement;
+
+        template <typename T>
+        using SecureVector = std::vector<T, SecureAllocator<T>>;
+
+        // Per-thread structure-of-arrays scratch for the batched paths. Points
+        // between steps stay in extended coordinates; R and Z are encoded at
+        // the end of a batch, all together. The secret arrays live in secure
+        // memory; they only grow, so this costs a sodium_malloc per array when
+        // a larger batch than before arrives.
+        struct BatchScratch
+        {
+            SecureVector<Scalar> y;
+            std::vector<GroupElement> Y;
+            std::vector<GroupElement> V;
+            std::vector<GroupElement> X_prime;
+            std::vector<GroupElement> R;
+            SecureVector<GroupElement> shared; // Z before encoding
+            std::vector<Point> R_encoded;
+            SecureVector<Point> Z;
+            std::vector<Transcript> transcripts;
+            SecureVector<SessionKey> K;
+            std::vector<size_t> live; // original index of each packed item
+
+            void reserve(size_t n)
+            {
+                if (y.size() >= n)
+                    return;
+                y.resize(n);
+                Y.resize(n);
+                V.resize(n);
+                X_prime.resize(n);
+                R.resize(n);
+                shared.resize(n);
+                R_encoded.resize(n);
+                Z.resize(n);
+                transcripts.resize(n);
+                K.resize(n);
+                live.resize(n);
+            }
+
+            void wipe(size_t n)
+            {
+                sodium_memzero(y.data(), n * sizeof(Scalar));
+                sodium_memzero(shared.data(), n * sizeof(GroupElement));
+                sodium_memzero(Z.data(), n * sizeof(Point));
+                sodium_memzero(K.data(), n * sizeof(SessionKey));
+            }
+        };
+
+        BatchScratch &batch_scratch()
+        {
+            thread_local BatchScratch scratch;
+            return scratch;
+        }
+    }
+
+    size_t RspDerBatch(std::span<const RspDerRequest> requests, std::span<RspDerResponse> responses) noexcept
+    {
+        const size_t n = std::min(requests.size(), responses.size());
+        if (n == 0)
+            return 0;
+
+        BatchScratch &scratch = batch_scratch();
+        try
+        {
+            scratch.reserve(n);
+        }
+        catch (...)
+        {
+            for (size_t i = 0; i < n; i++)
+                responses[i].status = Status::Failure;
+            return n;
+        }
+
+        // Decode I and V and calculate X' = I/V ~> I - V before any scalar
+        // multiplication, so malformed or degenerate items cost a decode. The
+        // items still standing are packed to the front of the scratch arrays,
+        // live[k] holding the request index of packed item k; rejected items
+        // draw no randomness and take no SIMD lanes.
+        size_t live = 0;
+        for (size_t i = 0; i < n; i++)
+        {
+            GroupElement I;
+            responses[i].status = Status::Ok;
+            if (!ristretto255::decode(I, requests[i].I))
+                responses[i].status = Status::InvalidPoint;
+            else if (!ristretto255::decode(scratch.V[live], requests[i].V))
+                responses[i].status = Status::Failure;
+            else
+            {
+                ristretto255::sub(scratch.X_prime[live], I, scratch.V[live]);
+                if (ristretto255::is_identity(scratch.X_prime[live]))
+                    responses[i].status = Status::InvalidPoint;
+                else
+                    scratch.live[live++] = i;
+            }
+            if (responses[i].status != Status::Ok)
+            {
+                sodium_memzero(responses[i].R.data(), POINT_LEN);
+                sodium_memzero(responses[i].K.data(), SESSION_KEY_LEN);
+            }
+        }
+
+        // Choose random y in Z_p for every item from the thread's DRBG buffer
+        drbg::random_scalars(scratch.y.data(), live);
+
+        // Calculate Y = g^y and R = Y*V  ~> Y + V on the elliptic curve, left unencoded
+        for (size_t k = 0; k < live; k++)
+        {
+            ristretto255::scalarmult_base(scratch.Y[k], scratch.y[k]);
+            ristretto255::add(scratch.R[k], scratch.Y[k], scratch.V[k]);
+        }
+
+        // Calculates Z = (X')^y ~> y*X' in elliptic curve calculations, several
+        // items per SIMD register
+        ristretto255::scalarmult_lanes(scratch.shared.data(), scratch.y.data(), scratch.X_prime.data(), live);
+
+        // Encode every R and Z of the batch, their inverse square roots side by side
+        ristretto255::encode_batch(scratch.R_encoded.data(), scratch.R.data(), live);
+        ristretto255::encode_batch(scratch.Z.data(), scratch.shared.data(), live);
+
+        // Calculates K = H'(Z, I, R, P_i, P_j, V), several transcripts per SIMD register
+        for (size_t k = 0; k < live; k++)
+        {
+            const RspDerRequest &req = requests[scratch.live[k]];
+            RspDerResponse &rsp = responses[scratch.live[k]];
+            rsp.R = scratch.R_encoded[k];
+            scratch.transcripts[k] = {scratch.Z[k], req.I, rsp.R, req.P_i, req.P_j, req.V};
+        }
+        derive_session_keys(scratch.K.data(), scratch.transcripts.data(), live);
+        for (size_t k = 0; k < live; k++)
+        {
+            RspDerResponse &rsp = responses[scratch.live[k]];
+            if (ristretto255::is_identity(scratch.shared[k]))
+            {
+                rsp.status = Status::InvalidPoint;
+                sodium_memzero(rsp.R.data(), POINT_LEN);
+                sodium_memzero(rsp.K.data(), SESSION_KEY_LEN);
+            }
+            else
+                rsp.K = scratch.K[k];
+        }
+
+        scratch.wipe(live);
+        return n;
+    }
+
+    size_t DerBatch(std::span<const DerRequest> requests, std::span<DerResponse> responses) noexcept
+    {
+        const size_t n = std::min(requests.size(), responses.size());
+        if (n == 0)
+            return 0;
+
+        BatchScratch &scratch = batch_scratch();
+        try
+        {
+            scratch.reserve(n);
+        }
+        catch (...)
+        {
+            for (size_t i = 0; i < n; i++)
+                responses[i].status = Status::Failure;
+            return n;
+        }
+
+        // Decode R and V and calculate Y' = R/V ~> R - V, packing the items
+        // still standing as in RspDerBatch; X_prime holds Y' here. An R equal
+        // to V makes Y' the identity and is rejected right away.
+        size_t live = 0;
+        for (size_t i = 0; i < n; i++)
+        {
+            const State &state = *requests[i].state;
+            GroupElement R;
+            responses[i].status = Status::Ok;
+            if (!ristretto255::decode(R, requests[i].R))
+                responses[i].status = Status::InvalidPoint;
+            else if (!ristretto255::decode(scratch.V[live], state.V))
+                responses[i].status = Status::Failure;
+            else
+            {
+                ristretto255::sub(scratch.X_prime[live], R, scratch.V[live]);
+                if (ristretto255::is_identity(scratch.X_prime[live]))
+                    responses[i].status = Status::InvalidPoint;
+                else
+                {
+                    scratch.y[live] = state.x;
+                    scratch.live[live++] = i;
+                }
+            }
+            if (responses[i].status != Status::Ok)
+                sodium_memzero(responses[i].K.data(), SESSION_KEY_LEN);
+        }
+
+        // Calculates Z = (Y')^x ~> x*Y', several items per SIMD register
+        ristretto255::scalarmult_lanes(scratch.shared.data(), scratch.y.data(), scratch.X_prime.data(), live);
+        ristretto255::encode_batch(scratch.Z.data(), scratch.shared.data(), live);
+
+        // Calculates K = H'(Z, I, R, P_i, P_j, V), several transcripts per SIMD register
+        for (size_t k = 0; k < live; k++)
+        {
+            const DerRequest &req = requests[scratch.live[k]];
+            const State &state = *req.state;
+            scratch.transcripts[k] = {scratch.Z[k], state.I, req.R, state.P_i, state.P_j, state.V};
+        }
+        derive_session_keys(scratch.K.data(), scratch.transcripts.data(), live);
+        for (size_t k = 0; k < live; k++)
+        {
+            DerResponse &rsp = responses[scratch.live[k]];
+            if (ristretto255::is_identity(scratch.shared[k]))
+            {
+                rsp.status = Status::InvalidPoint;
+                sodium_memzero(rsp.K.data(), SESSION_KEY_LEN);
+            }
+            else
+                rsp.K = scratch.K[k];
+        }
+
+        scratch.wipe(live);
+        return n;
+    }
+}
@@ -0,0 +1,62 @@
+#ifndef PROTOSS_BATCH_HPP
+#define PROTOSS_BATCH_HPP
+
+#include "protoss_protocol.hpp"
+
+namespace protoss
+{
+    // One incoming handshake for the batched responder. V is the precomputed
+    // verifier for the initiator's credential; P_i and P_j must stay valid for
+    // the duration of the call.
+    struct RspDerRequest
+    {
+        Point I;
+        Point V;
+        Bytes P_i;
+        Bytes P_j;
+    };
+
+    struct RspDerResponse
+    {
+        Point R;
+        SessionKey K;
+        Status status;
+    };
+
+    // Response and key derivation (Step 2) for a burst of handshakes. Draws all
+    // random scalars from the thread's buffered DRBG (scalar_drbg.hpp) and
+    // runs each protocol step over the whole batch using per-thread
+    // structure-of-arrays scratch buffers, which only allocate when a larger
+    // batch than before arrives. The shared-secret multiplications run
+    // several per SIMD register on the backend chosen in ristretto255_lanes.hpp.
+    // As in TryRspDer, peer points are checked before any scalar
+    // multiplication, and rejected items take no SIMD lanes.
+    // Never throws: each response carries its own status, and a failed item
+    // leaves the rest of the batch untouched. Processes
+    // min(requests.size(), responses.size()) items and returns that count.
+    size_t RspDerBatch(std::span<const RspDerRequest> requests,
+                       std::span<RspDerResponse> responses) noexcept;
+
+    // One pending handshake for the batched initiator: the state left by Init
+    // and the responder's R. The state must stay valid for the duration of
+    // the call.
+    struct DerRequest
+    {
+        const State *state;
+        Point R;
+    };
+
+    struct DerResponse
+    {
+        SessionKey K;
+        Status status;
+    };
+
+    // Key derivation (Step 3) for a burst of handshakes, with the same
+    // per-thread scratch and error reporting as RspDerBatch. Processes
+    // min(requests.size(), responses.size()) items and returns that count.
+    size_t DerBatch(std::span<const DerRequest> requests,
+                    std::span<DerResponse> responses) noexcept;
+}
+
+#endif // PROTOSS_BATCH_HPP
@@ -0,0 +1,114 @@
+#ifndef PROTOSS_PROBES_HPP
+#define PROTOSS_PROBES_HPP
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#endif
+
+// Cycle counter reads and sub-phase probes for the protocol steps.
+//
+// read_cycles_begin()/read_cycles_end() read the time-stamp counter with the
+// fences needed to keep the measured code between them; on other
+// architectures they fall back to steady_clock nanoseconds.
+//
+// PROTOSS_PROBED(kind, expr) evaluates expr and, in builds with PROTOSS_PROBES
+// defined, adds the cycles it took to the calling thread's ProbeTotals. Without
+// PROTOSS_PROBES it expands to (expr), so the default build pays nothing.
+namespace protoss
+{
+    inline uint64_t read_cycles_begin()
+    {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+        _mm_lfence();
+        return __rdtsc();
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    inline uint64_t read_cycles_end()
+    {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+        unsigned aux;
+        uint64_t t = __rdtscp(&aux);
+        _mm_lfence();
+        return t;
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    // Sub-phase operations timed by the probes
+    enum class Probe : unsigned
+    {
+        ScalarRandom,   // drbg::random_scalar, from the active scalar source
+        HashToPoint,    // SHA-512 of the password and the map to a point
+        ScalarMultBase, // g^x
+        ScalarMult,     // (X')^y and (Y')^x
+        AddSub,         // point additions and subtractions
+        PointCodec,     // ristretto255 encodings and decodings of the fused pipeline
+        TranscriptHash, // K = H'(Z, I, R, P_i, P_j, V)
+        Count
+    };
+
+    constexpr size_t PROBE_COUNT = size_t(Probe::Count);
+
+    inline const char *probe_name(Probe probe)
+    {
+        static const char *const names[PROBE_COUNT] = {"scalar_random", "hash_to_point", "scalarmult_base",
+                                                       "scalarmult", "add/sub", "point_codec", "transcript_hash"};
+        return names[size_t(probe)];
+    }
+
+#ifdef PROTOSS_PROBES
+    constexpr bool probes_enabled = true;
+#else
+    constexpr bool probes_enabled = false;
+#endif
+
+    // Cycles and calls accumulated per probe on one thread
+    struct ProbeTotals
+    {
+        std::array<uint64_t, PROBE_COUNT> cycles{};
+        std::array<uint64_t, PROBE_COUNT> calls{};
+    };
+
+    inline ProbeTotals &probe_totals()
+    {
+        thread_local ProbeTotals totals;
+        return totals;
+    }
+
+    inline void reset_probes() { probe_totals() = ProbeTotals{}; }
+
+    template <typename Fn>
+    inline decltype(auto) probed(Probe probe, Fn &&fn)
+    {
+        struct Scope
+        {
+            Probe probe;
+            uint64_t start = read_cycles_begin();
+            ~Scope()
+            {
+                ProbeTotals &totals = probe_totals();
+                totals.cycles[size_t(probe)] += read_cycles_end() - start;
+                totals.calls[size_t(probe)]++;
+            }
+        } scope{probe};
+        return fn();
+    }
+}
+
+#ifdef PROTOSS_PROBES
+#define PROTOSS_PROBED(kind, expr) ::protoss::probed(::protoss::Probe::kind, [&]() -> decltype(auto) { return expr; })
+#else
+#define PROTOSS_PROBED(kind, expr) (expr)
+#endif
+
+#endif // PROTOSS_PROBES_HPP
@@ -1,18 +1,351 @@
-
 #include "protoss_protocol.hpp"
+#include "protoss_probes.hpp"
+#include "ristretto255.hpp"
+#include "scalar_drbg.hpp"
+#include "sha512_lanes.hpp"
+#include "transcript_hasher.hpp"
+#include <algorithm>
 
-// Hash password -> 64-byte hash -> map to Ristretto point
-std::vector<unsigned char> hash_to_point(const std::string &password)
+// The protocol steps keep points in extended coordinates between group
+// operations (ristretto255.hpp): each step decodes its input points once and
+// encodes only the points it sends or hashes, instead of paying an encode and
+// a decode around every libsodium call.
+namespace protoss
 {
-    std::vector<unsigned char> hash(INPUT_LEN_RISTRETTO_HASH_TO_POINT, 0);
-    if (crypto_hash_sha512(hash.data(), (const unsigned char *)password.data(), password.size()) != 0)
-        throw std::runtime_error("crypto_hash_sha512 failed");
+    namespace
+    {
+        using ristretto255::GroupElement;
+
+        // Wipes a consumed ephemeral scalar when the step using it returns
+        struct ScalarWipe
+        {
+            Scalar &s;
+            ~ScalarWipe() { sodium_memzero(s.data(), s.size()); }
+        };
+
+        // The throwing API: every step is its Try* counterpart plus this check
+        void check(Status status, const char *step)
+        {
+            if (status == Status::InvalidPoint)
+                throw std::runtime_error(std::string(step) + ": invalid peer point");
+            if (status != Status::Ok)
+                throw std::runtime_error(std::string(step) + " failed");
+        }
+
+        Status hash_password(Point &out, std::string_view password) noexcept
+        {
+            unsigned char hash[INPUT_LEN_RISTRETTO_HASH_TO_POINT];
+            if (crypto_hash_sha512(hash, (const unsigned char *)password.data(), password.size()) != 0)
+                return Status::Failure;
+            const int rc = crypto_core_ristretto255_from_hash(out.data(), hash);
+            sodium_memzero(hash, sizeof hash);
+            return rc == 0 ? Status::Ok : Status::Failure;
+        }
+
+        // Calculates Z = k * P, rejecting an exchange that degenerates to the
+        // identity. P itself is the identity when the peer point equals V;
+        // that is rejected before paying for the multiplication.
+        Status shared_point(Point &Z, const Scalar &k, const GroupElement &P) noexcept
+        {
+            if (ristretto255::is_identity(P))
+                return Status::InvalidPoint;
+
+            GroupElement Z_point;
+            PROTOSS_PROBED(ScalarMult, ristretto255::scalarmult(Z_point, k, P));
+            bool identity = ristretto255::is_identity(Z_point);
+            if (!identity)
+                PROTOSS_PROBED(PointCodec, ristretto255::encode(Z, Z_point));
+            sodium_memzero(&Z_point, sizeof Z_point);
+            return identity ? Status::InvalidPoint : Status::Ok;
+        }
+
+        // I = X + V on the initiator side
+        Status init_from(Point &I, State &state, const GroupElement &X, const Point &V, Bytes P_i, Bytes P_j) noexcept
+        {
+            GroupElement V_point, I_point;
+            if (!PROTOSS_PROBED(PointCodec, ristretto255::decode(V_point, V)))
+                return Status::Failure;
+
+            // Calculate I = X*V ~> X + V in elliptic curves
+            PROTOSS_PROBED(AddSub, ristretto255::add(I_point, X, V_point));
+            PROTOSS_PROBED(PointCodec, ristretto255::encode(I, I_point));
+
+            state.V = V;
+            state.I = I;
+            state.P_i = P_i;
+            state.P_j = P_j;
+            return Status::Ok;
+        }
+
+        // Everything the responder checks before paying for a scalar
+        // multiplication: V decodes and X' = I - V is not the identity, which
+        // an I equal to V would make it and Z with it
+        Status respond_prepare(GroupElement &V_point, GroupElement &X_prime, const Point &V,
+                               const GroupElement &I_point) noexcept
+        {
+            if (!PROTOSS_PROBED(PointCodec, ristretto255::decode(V_point, V)))
+                return Status::Failure;
+
+            // Calculates X' = I/V ~> I - V, because I and V are elliptic curve points
+            PROTOSS_PROBED(AddSub, ristretto255::sub(X_prime, I_point, V_point));
+            return ristretto255::is_identity(X_prime) ? Status::InvalidPoint : Status::Ok;
+        }
+
+        // R = Y + V, Z = y * X' and K on the responder side
+        Status respond_from(Point &R, SessionKey &K, const Point &V, Bytes P_i, Bytes P_j, const Point &I,
+                            const GroupElement &V_point, const GroupElement &X_prime,
+                            const Scalar &y, const GroupElement &Y) noexcept
+        {
+            // Calculate R = Y*V  ~> Y + V on the elliptic curve
+            GroupElement R_point;
+            PROTOSS_PROBED(AddSub, ristretto255::add(R_point, Y, V_point));
+            PROTOSS_PROBED(PointCodec, ristretto255::encode(R, R_point));
+
+            // Calculates Z = (X')^y ~> y*X' in elliptic curve calculations
+            Point Z;
+            Status status = shared_point(Z, y, X_prime);
+            if (status != Status::Ok)
+                return status;
+
+            // Calculates K = H'(Z, I, R, P_i, P_j, V)
+            PROTOSS_PROBED(TranscriptHash, derive_session_key(K, Z, I, R, P_i, P_j, V));
+            sodium_memzero(Z.data(), Z.size());
+            return Status::Ok;
+        }
+
+        // Responder with a fresh y. Its callers decode I first, so a malformed
+        // I from the network costs one decode and no scalar multiplication.
+        Status respond(Point &R, SessionKey &K, const Point &V, Bytes P_i, Bytes P_j, const Point &I,
+                       const GroupElement &I_point) noexcept
+        {
+            GroupElement V_point, X_prime;
+            Status status = respond_prepare(V_point, X_prime, V, I_point);
+            if (status != Status::Ok)
+                return status;
+
+            // Choose random y in Z_p and calculate Y = g^y, left unencoded
+            Scalar y;
+            ScalarWipe wipe{y};
+            PROTOSS_PROBED(ScalarRandom, drbg::random_scalar(y));
+            GroupElement Y;
+            PROTOSS_PROBED(ScalarMultBase, ristretto255::scalarmult_base(Y, y));
+
+            return respond_from(R, K, V, P_i, P_j, I, V_point, X_prime, y, Y);
+        }
+
+        // A failed responder step leaves nothing usable behind
+        Status respond_result(Status status, Point &R, SessionKey &K) noexcept
+        {
+            if (status != Status::Ok)
+            {
+                sodium_memzero(R.data(), R.size());
+                sodium_memzero(K.data(), K.size());
+            }
+            return status;
+        }
+    }
+
+    // Hash password -> 64-byte hash -> map to Ristretto point
+    void hash_to_point(Point &out, std::string_view password)
+    {
+        check(hash_password(out, password), "hash_to_point");
+    }
+
+    void hash_to_point_batch(std::span<Point> out, std::span<const std::string_view> passwords)
+    {
+        if (out.size() != passwords.size())
+            throw std::runtime_error("hash_to_point_batch needs one output per password");
+
+        // SHA-512 prehash of a whole chunk first, several passwords per SIMD
+        // register, then the map and the encoding with their inverse square
+        // roots batched across the chunk
+        constexpr size_t CHUNK = 64;
+        static_assert(INPUT_LEN_RISTRETTO_HASH_TO_POINT == sha512::BYTES);
+        unsigned char hashes[CHUNK * INPUT_LEN_RISTRETTO_HASH_TO_POINT];
+        Bytes fields[CHUNK];
+        sha512::Fields messages[CHUNK];
+        GroupElement points[CHUNK];
+        for (size_t i = 0; i < out.size(); i += CHUNK)
+        {
+            const size_t n = std::min(CHUNK, out.size() - i);
+            for (size_t j = 0; j < n; j++)
+            {
+                fields[j] = Bytes((const unsigned char *)passwords[i + j].data(), passwords[i + j].size());
+                messages[j] = sha512::Fields(&fields[j], 1);
+            }
+            sha512::hash_lanes(hashes, messages, n);
+            ristretto255::from_hash_batch(points, hashes, n);
+            ristretto255::encode_batch(&out[i], points, n);
+        }
+        sodium_memzero(hashes, sizeof hashes);
+    }
+
+    void generate_ephemeral(Ephemeral &e)
+    {
+        // choose random s in Z_p
+        PROTOSS_PROBED(ScalarRandom, drbg::random_scalar(e.s));
+
+        // calculate S = g^s
+        GroupElement S;
+        PROTOSS_PROBED(ScalarMultBase, ristretto255::scalarmult_base(S, e.s));
+        PROTOSS_PROBED(PointCodec, ristretto255::encode(e.S, S));
+    }
+
+    Status TryInit(Point &I, State &state, std::string_view password, Bytes P_i, Bytes P_j) noexcept
+    {
+        // Calculate V = Hash(pwd)
+        Point V;
+        Status status = PROTOSS_PROBED(HashToPoint, hash_password(V, password));
+        if (status != Status::Ok)
+            return status;
+
+        return TryInit(I, state, V, P_i, P_j);
+    }
+
+    Status TryInit(Point &I, State &state, const Point &V, Bytes P_i, Bytes P_j) noexcept
+    {
+        // choose random x in Z_p
+        PROTOSS_PROBED(ScalarRandom, drbg::random_scalar(state.x));
+
+        // calculate X = g^x, left unencoded
+        GroupElement X;
+        PROTOSS_PROBED(ScalarMultBase, ristretto255::scalarmult_base(X, state.x));
+
+        return init_from(I, state, X, V, P_i, P_j);
+    }
+
+    Status TryInit(Point &I, State &state, const Point &V, Bytes P_i, Bytes P_j, Ephemeral &x) noexcept
+    {
+        ScalarWipe wipe{x.s};
+        GroupElement X;
+        if (!PROTOSS_PROBED(PointCodec, ristretto255::decode(X, x.S)))
+            return Status::Failure;
+        state.x = x.s;
+
+        return init_from(I, state, X, V, P_i, P_j);
+    }
 
-    std::vector<unsigned char> point(POINT_LEN, 0);
-    if (crypto_core_ristretto255_from_hash(point.data(), hash.data()) != 0)
-        throw std::runtime_error("crypto_core_ristretto255_from_hash failed");
+    Status TryRspDer(Point &R, SessionKey &K, std::string_view password, Bytes P_i, Bytes P_j, const Point &I) noexcept
+    {
+        // Reject a malformed I before hashing the password
+        GroupElement I_point;
+        if (!PROTOSS_PROBED(PointCodec, ristretto255::decode(I_point, I)))
+            return respond_result(Status::InvalidPoint, R, K);
 
-    return point;
+        // Calculate V = Hash(pwd)
+        Point V;
+        Status status = PROTOSS_PROBED(HashToPoint, hash_password(V, password));
+        if (status == Status::Ok)
+            status = respond(R, K, V, P_i, P_j, I, I_point);
+        return respond_result(status, R, K);
+    }
+
+    Status TryRspDer(Point &R, SessionKey &K, const Point &V, Bytes P_i, Bytes P_j, const Point &I) noexcept
+    {
+        GroupElement I_point;
+        if (!PROTOSS_PROBED(PointCodec, ristretto255::decode(I_point, I)))
+            return respond_result(Status::InvalidPoint, R, K);
+
+        return respond_result(respond(R, K, V, P_i, P_j, I, I_point), R, K);
+    }
+
+    Status TryRspDer(Point &R, SessionKey &K, const Point &V, Bytes P_i, Bytes P_j, const Point &I, Ephemeral &y) noexcept
+    {
+        ScalarWipe wipe{y.s};
+        GroupElement I_point, V_point, X_prime, Y;
+        if (!PROTOSS_PROBED(PointCodec, ristretto255::decode(I_point, I)))
+            return respond_result(Status::InvalidPoint, R, K);
+        Status status = respond_prepare(V_point, X_prime, V, I_point);
+        if (status == Status::Ok && !PROTOSS_PROBED(PointCodec, ristretto255::decode(Y, y.S)))
+            status = Status::Failure;
+        if (status == Status::Ok)
+            status = respond_from(R, K, V, P_i, P_j, I, V_point, X_prime, y.s, Y);
+        return respond_result(status, R, K);
+    }
+
+    Status TryDer(SessionKey &K, const State &state, const Point &R) noexcept
+    {
+        GroupElement R_point, V_point, Y_prime;
+        Status status = Status::Ok;
+        if (!PROTOSS_PROBED(PointCodec, ristretto255::decode(R_point, R)))
+            status = Status::InvalidPoint;
+        else if (!PROTOSS_PROBED(PointCodec, ristretto255::decode(V_point, state.V)))
+            status = Status::Failure;
+
+        Point Z;
+        if (status == Status::Ok)
+        {
+            // Calculate Y' = R/V ~> R - V because R and V are elliptic curve points
+            PROTOSS_PROBED(AddSub, ristretto255::sub(Y_prime, R_point, V_point));
+
+            // Calculates Z = (Y')^x ~> x*Y' in elliptic curve calcuations
+            status = shared_point(Z, state.x, Y_prime);
+        }
+        if (status != Status::Ok)
+        {
+            sodium_memzero(K.data(), K.size());
+            return status;
+        }
+
+        // Calculates K = H'(Z, I, R, P_i, P_j, V)
+        PROTOSS_PROBED(TranscriptHash, derive_session_key(K, Z, state.I, R, state.P_i, state.P_j, state.V));
+        sodium_memzero(Z.data(), Z.size());
+        return Status::Ok;
+    }
+
+    void Init(Point &I, State &state, std::string_view password, Bytes P_i, Bytes P_j)
+    {
+        check(TryInit(I, state, password, P_i, P_j), "Init");
+    }
+
+    void Init(Point &I, State &state, const Point &V, Bytes P_i, Bytes P_j)
+    {
+        check(TryInit(I, state, V, P_i, P_j), "Init");
+    }
+
+    void Init(Point &I, State &state, const Point &V, Bytes P_i, Bytes P_j, Ephemeral &x)
+    {
+        check(TryInit(I, state, V, P_i, P_j, x), "Init");
+    }
+
+    void RspDer(Point &R, SessionKey &K, std::string_view password, Bytes P_i, Bytes P_j, const Point &I)
+    {
+        check(TryRspDer(R, K, password, P_i, P_j, I), "RspDer");
+    }
+
+    void RspDer(Point &R, SessionKey &K, const Point &V, Bytes P_i, Bytes P_j, const Point &I)
+    {
+        check(TryRspDer(R, K, V, P_i, P_j, I), "RspDer");
+    }
+
+    void RspDer(Point &R, SessionKey &K, const Point &V, Bytes P_i, Bytes P_j, const Point &I, Ephemeral &y)
+    {
+        check(TryRspDer(R, K, V, P_i, P_j, I, y), "RspDer");
+    }
+
+    void Der(SessionKey &K, const State &state, const Point &R)
+    {
+        check(TryDer(K, state, R), "Der");
+    }
+}
+
+// Copies a fixed-size value out of a vector, rejecting buffers of the wrong length
+template <size_t N, typename Allocator>
+static std::array<unsigned char, N> to_array(const std::vector<unsigned char, Allocator> &v, const char *what)
+{
+    if (v.size() != N)
+        throw std::runtime_error(std::string(what) + " has invalid length");
+    std::array<unsigned char, N> out;
+    std::copy(v.begin(), v.end(), out.begin());
+    return out;
+}
+
+// Hash password -> 64-byte hash -> map to Ristretto point
+std::vector<unsigned char> hash_to_point(const std::string &password)
+{
+    protoss::Point point;
+    protoss::hash_to_point(point, password);
+    return std::vector<unsigned char>(point.begin(), point.end());
 }
 
 // Concatenate multiple byte vectors
@@ -26,90 +359,36 @@ std::vector<unsigned char> concatenate_vectors(const std::vector<std::vector<uns
 
 ReturnTypeInit Init(const std::string &password, const std::vector<unsigned char> &P_i, std::vector<unsigned char> &P_j)
 {
+    protoss::Point I;
+    protoss::State state;
+    protoss::Init(I, state, password, P_i, P_j);
 
-    // choose random x in Z_p
-    std::vector<unsigned char> x(SCALAR_LEN);
-    crypto_core_ristretto255_scalar_random(x.data());
-
-    // calculate X = g^x
-    std::vector<unsigned char> X(POINT_LEN);
-    if (crypto_scalarmult_ristretto255_base(X.data(), x.data()) != 0)
-        throw std::runtime_error("crypto_scalarmult_ristretto255_base failed");
-
-    // Calculate V = Hash(pwd)
-    std::vector<unsigned char> V = hash_to_point(password);
-
-    // Calculate I = X*V ~> X + V in elliptic curves
-    std::vector<unsigned char> I(POINT_LEN);
-    if (crypto_core_ristretto255_add(I.data(), X.data(), V.data()) != 0)
-        throw std::runtime_error("crypto_core_ristretto255_add failed");
-
-    ProtossState *state = new ProtossState(x, I, P_i, P_j, V);
-    return ReturnTypeInit(I, *state);
+    std::vector<unsigned char> I_vec(I.begin(), I.end());
+    return ReturnTypeInit(I_vec, ProtossState(state.x, I_vec, P_i, P_j,
+                                              std::vector<unsigned char>(state.V.begin(), state.V.end())));
 }
 
 ReturnTypeRspDer RspDer(const std::string &password, const std::vector<unsigned char> &P_i, std::vector<unsigned char> &P_j, std::vector<unsigned char> I)
 {
+    protoss::Point R;
+    protoss::SessionKey K;
+    protoss::RspDer(R, K, password, P_i, P_j, to_array<POINT_LEN>(I, "I"));
 
-    // Choose random y in Z_p
-    std::vector<unsigned char> y(SCALAR_LEN);
-    crypto_core_ristretto255_scalar_random(y.data());
-
-    // Calculate Y = g^y
-    std::vector<unsigned char> Y(POINT_LEN);
-    if (crypto_scalarmult_ristretto255_base(Y.data(), y.data()) != 0)
-        throw std::runtime_error("crypto_scalarmult_ristretto255_base failed");
-
-    // Calculate V = Hash(pwd)
-    std::vector<unsigned char> V = hash_to_point(password);
-
-    // Calculate R = Y*V  ~> Y + V on the elliptic curve
-    std::vector<unsigned char> R(POINT_LEN);
-    if (crypto_core_ristretto255_add(R.data(), Y.data(), V.data()) != 0)
-        throw std::runtime_error("crypto_core_ristretto255_add failed");
-
-    // Calculates X' = I/V ~> I - V, because I and V are elliptic curve points
-    std::vector<unsigned char> X_prime(POINT_LEN);
-    if (crypto_core_ristretto255_sub(X_prime.data(), I.data(), V.data()) != 0)
-        throw std::runtime_error("crypto_core_ristretto255_sub failed");
-
-    // Calculates Z = (X')^y ~> y*X' in elliptic curve calculations
-    std::vector<unsigned char> Z(POINT_LEN);
-    if (crypto_scalarmult_ristretto255(Z.data(), y.data(), X_prime.data()) != 0)
-        throw std::runtime_error("crypto_scalarmult_ristretto255 failed");
-
-    // Calculates K = H'(Z, I, R, P_i, P_j, V)
-    auto concat = concatenate_vectors({Z, I, R, P_i, P_j, V});
-    std::vector<unsigned char> full_hash(crypto_hash_sha512_BYTES);
-    if (crypto_hash_sha512(full_hash.data(), concat.data(), concat.size()) != 0)
-        throw std::runtime_error("crypto_hash_sha512 failed");
-    std::vector<unsigned char> K(full_hash.begin(), full_hash.begin() + SESSION_KEY_LEN);
-
-    return ReturnTypeRspDer(R, K);
+    ReturnTypeRspDer result(std::vector<unsigned char>(R.begin(), R.end()), K);
+    sodium_memzero(K.data(), K.size());
+    return result;
 }
 
 std::vector<unsigned char> Der(const std::string &password, ProtossState protoss_state, std::vector<unsigned char> R)
 {
-
     // Gets state vars
     auto &[x, I, P_i, P_j, V] = protoss_state;
 
-    // Calculate Y' = R/V ~> R - V because R and V are elliptic curve points
-    std::vector<unsigned char> Y_prime(POINT_LEN);
-    if (crypto_core_ristretto255_sub(Y_prime.data(), R.data(), V.data()) != 0)
-        throw std::runtime_error("crypto_core_ristretto255_sub failed");
-
-    // Calculates Z = (Y')^x ~> x*Y' in elliptic curve calcuations
-    std::vector<unsigned char> Z(POINT_LEN);
-    if (crypto_scalarmult_ristretto255(Z.data(), x.data(), Y_prime.data()) != 0)
-        throw std::runtime_error("crypto_scalarmult_ristretto255 failed");
-
-    // Calculates K = H'(Z, I, R, P_i, P_j, V)
-    auto concat = concatenate_vectors({Z, I, R, P_i, P_j, V});
-    std::vector<unsigned char> full_hash(crypto_hash_sha512_BYTES);
-    if (crypto_hash_sha512(full_hash.data(), concat.data(), concat.size()) != 0)
-        throw std::runtime_error("crypto_hash_sha512 failed");
-    std::vector<unsigned char> K(full_hash.begin(), full_hash.begin() + SESSION_KEY_LEN);
-
-    return K;
-}
\ No newline at end of file
+    protoss::State state{to_array<SCALAR_LEN>(x, "x"), to_array<POINT_LEN>(I, "I"), to_array<POINT_LEN>(V, "V"), P_i, P_j};
+    protoss::SessionKey K;
+    protoss::Der(K, state, to_array<POINT_LEN>(R, "R"));
+
+    std::vector<unsigned char> result(K.begin(), K.end());
+    sodium_memzero(K.data(), K.size());
+    return result;
+}
@@ -1,10 +1,15 @@
 #ifndef PROTOSS_PROTOCOL_HPP
 #define PROTOSS_PROTOCOL_HPP
 
+#include <array>
+#include <span>
+#include <string_view>
+#include <utility>
 #include <vector>
 #include <string>
 #include <sodium.h>
 #include <stdexcept>
+#include "secure_arena.hpp"
 
 // Constants for the protocol
 constexpr size_t SCALAR_LEN = crypto_core_ristretto255_SCALARBYTES;
@@ -12,37 +17,167 @@ constexpr size_t POINT_LEN = crypto_core_ristretto255_BYTES;
 constexpr size_t INPUT_LEN_RISTRETTO_HASH_TO_POINT = 64; // Input size for crypto_core_ristretto255_from_hash
 constexpr size_t SESSION_KEY_LEN = 32;                   // Output size for session key
 
-// Protoss state structure for maintaining protocol state
+// Fixed-size API: all scalars, points and keys live in std::array values and
+// results are written to out-parameters, so a full handshake performs no heap
+// allocations. The vector-based API below is a thin wrapper over this one.
+namespace protoss
+{
+    using Scalar = std::array<unsigned char, SCALAR_LEN>;
+    using Point = std::array<unsigned char, POINT_LEN>;
+    using SessionKey = std::array<unsigned char, SESSION_KEY_LEN>;
+    using Bytes = std::span<const unsigned char>;
+
+    // Result codes for the non-throwing APIs
+    enum class Status
+    {
+        Ok = 0,
+        InvalidPoint, // A peer point does not decode, or the exchange degenerates to the identity
+        Failure,      // A local computation failed
+        InvalidToken  // A sealed state token is malformed, forged, expired or under a retired key
+    };
+
+    // Initiator state kept between Init and Der. x and V = H(pwd), a password
+    // equivalent, are wiped on destruction. P_i and P_j are views: the
+    // identity buffers must outlive the state.
+    struct State
+    {
+        Scalar x;
+        Point I;
+        Point V;
+        Bytes P_i;
+        Bytes P_j;
+        ~State()
+        {
+            sodium_memzero(x.data(), x.size());
+            sodium_memzero(V.data(), V.size());
+        }
+    };
+
+    // Ephemeral key pair (s, S = g^s) for one handshake, wiped on destruction
+    struct Ephemeral
+    {
+        Scalar s;
+        Point S;
+        ~Ephemeral() { sodium_memzero(s.data(), s.size()); }
+    };
+
+    // Hash password to point
+    void hash_to_point(Point &out, std::string_view password);
+
+    // Hash many passwords to points, out[i] identical to hash_to_point(out[i],
+    // passwords[i]); for provisioning or rotating verifiers in bulk
+    void hash_to_point_batch(std::span<Point> out, std::span<const std::string_view> passwords);
+
+    // Choose a random scalar s in Z_p and compute S = g^s
+    void generate_ephemeral(Ephemeral &e);
+
+    // Initialize protocol state (Step 1)
+    void Init(Point &I, State &state,
+              std::string_view password,
+              Bytes P_i, Bytes P_j);
+
+    // Initialize protocol state (Step 1) from a precomputed verifier V
+    void Init(Point &I, State &state,
+              const Point &V,
+              Bytes P_i, Bytes P_j);
+
+    // Initialize protocol state (Step 1) from a precomputed verifier V and a
+    // precomputed ephemeral pair, which is consumed and wiped
+    void Init(Point &I, State &state,
+              const Point &V,
+              Bytes P_i, Bytes P_j,
+              Ephemeral &x);
+
+    // Response and key derivation (Step 2)
+    void RspDer(Point &R, SessionKey &K,
+                std::string_view password,
+                Bytes P_i, Bytes P_j,
+                const Point &I);
+
+    // Response and key derivation (Step 2) from a precomputed verifier V
+    void RspDer(Point &R, SessionKey &K,
+                const Point &V,
+                Bytes P_i, Bytes P_j,
+                const Point &I);
+
+    // Response and key derivation (Step 2) from a precomputed verifier V and a
+    // precomputed ephemeral pair, which is consumed and wiped
+    void RspDer(Point &R, SessionKey &K,
+                const Point &V,
+                Bytes P_i, Bytes P_j,
+                const Point &I,
+                Ephemeral &y);
+
+    // Key derivation (Step 3)
+    void Der(SessionKey &K, const State &state, const Point &R);
+
+    // Non-throwing counterparts of Init, RspDer and Der, for servers facing
+    // untrusted input: the same steps, reporting failures as a Status instead
+    // of an exception. The throwing functions above are these plus a throw.
+    // Peer points are decoded and checked before any scalar multiplication,
+    // so a malformed I or R, or one equal to V, is rejected for the cost of a
+    // decode; the responder does so before drawing y or hashing the password.
+    // On failure R and K are zeroed.
+    Status TryInit(Point &I, State &state, std::string_view password, Bytes P_i, Bytes P_j) noexcept;
+    Status TryInit(Point &I, State &state, const Point &V, Bytes P_i, Bytes P_j) noexcept;
+    Status TryInit(Point &I, State &state, const Point &V, Bytes P_i, Bytes P_j, Ephemeral &x) noexcept;
+
+    Status TryRspDer(Point &R, SessionKey &K, std::string_view password, Bytes P_i, Bytes P_j, const Point &I) noexcept;
+    Status TryRspDer(Point &R, SessionKey &K, const Point &V, Bytes P_i, Bytes P_j, const Point &I) noexcept;
+    Status TryRspDer(Point &R, SessionKey &K, const Point &V, Bytes P_i, Bytes P_j, const Point &I, Ephemeral &y) noexcept;
+
+    Status TryDer(SessionKey &K, const State &state, const Point &R) noexcept;
+}
+
+// Protoss state structure for maintaining protocol state, wiped on destruction.
+// x lives in the secure arena.
 struct ProtossState
 {
-    std::vector<unsigned char> x, I, P_i, P_j, V;
+    protoss::SecureBytes x;
+    std::vector<unsigned char> I, P_i, P_j, V;
     ProtossState(const std::vector<unsigned char> &x,
                  const std::vector<unsigned char> &I,
                  const std::vector<unsigned char> &P_i,
                  const std::vector<unsigned char> &P_j,
                  const std::vector<unsigned char> &V)
-        : x(x), I(I), P_i(P_i), P_j(P_j), V(V) {}
+        : x(x.begin(), x.end()), I(I), P_i(P_i), P_j(P_j), V(V) {}
+    ProtossState(const protoss::Scalar &x,
+                 const std::vector<unsigned char> &I,
+                 const std::vector<unsigned char> &P_i,
+                 const std::vector<unsigned char> &P_j,
+                 const std::vector<unsigned char> &V)
+        : x(x.begin(), x.end()), I(I), P_i(P_i), P_j(P_j), V(V) {}
+    ProtossState(const ProtossState &) = default;
+    ProtossState(ProtossState &&) = default;
+    ProtossState &operator=(const ProtossState &) = default;
+    ProtossState &operator=(ProtossState &&) = default;
+    ~ProtossState()
+    {
+        for (auto *field : {&I, &P_i, &P_j, &V})
+            sodium_memzero(field->data(), field->size());
+    }
 };
 
-// Return type for Init function
+// Return type for Init function, owns the initiator state by value
 struct ReturnTypeInit
 {
     std::vector<unsigned char> I;
-    ProtossState &protoss_state;
-    ReturnTypeInit(const std::vector<unsigned char> &I, ProtossState &protoss_state)
-        : I(I), protoss_state(protoss_state) {}
+    ProtossState protoss_state;
+    ReturnTypeInit(const std::vector<unsigned char> &I, ProtossState protoss_state)
+        : I(I), protoss_state(std::move(protoss_state)) {}
 };
 
-// Return type for RspDer function
+// Return type for RspDer function; K lives in the secure arena
 struct ReturnTypeRspDer
 {
 private:
-    std::vector<unsigned char> K;
+    protoss::SecureBytes K;
 
 public:
     std::vector<unsigned char> R;
-    std::vector<unsigned char> getSessionKey() { return K; }
-    ReturnTypeRspDer(std::vector<unsigned char> R, std::vector<unsigned char> K) : R(R), K(K) {}
+    std::vector<unsigned char> getSessionKey() { return std::vector<unsigned char>(K.begin(), K.end()); }
+    ReturnTypeRspDer(std::vector<unsigned char> R, std::vector<unsigned char> K) : K(K.begin(), K.end()), R(R) {}
+    ReturnTypeRspDer(std::vector<unsigned char> R, const protoss::SessionKey &K) : K(K.begin(), K.end()), R(R) {}
 };
 
 // Hash password to point
@@ -67,4 +202,4 @@ std::vector<unsigned char> Der(const std::string &password,
                                ProtossState protoss_state,
                                std::vector<unsigned char> R);
 
-#endif // PROTOSS_PROTOCOL_HPP
\ No newline at end of file
+#endif // PROTOSS_PROTOCOL_HPP
@@ -0,0 +1,921 @@
+#include "ristretto255.hpp"
+#include "ristretto255_lanes.hpp"
+#include <algorithm>
+
+namespace protoss::ristretto255
+{
+    namespace
+    {
+        using u128 = unsigned __int128;
+
+        constexpr uint64_t MASK51 = (uint64_t(1) << 51) - 1;
+
+        constexpr Fe FE_ZERO = {{0, 0, 0, 0, 0}};
+        constexpr Fe FE_ONE = {{1, 0, 0, 0, 0}};
+
+        // Edwards d = -121665/121666 and 2d
+        constexpr Fe FE_D = {{0x34dca135978a3, 0x1a8283b156ebd, 0x5e7a26001c029, 0x739c663a03cbb, 0x52036cee2b6ff}};
+        constexpr Fe FE_D2 = {{0x69b9426b2f159, 0x35050762add7a, 0x3cf44c0038052, 0x6738cc7407977, 0x2406d9dc56dff}};
+
+        // sqrt(-1) and 1/sqrt(a - d), the constants of RFC 9496
+        constexpr Fe FE_SQRTM1 = {{0x61b274a0ea0b0, 0xd5a5fc8f189d, 0x7ef5e9cbd0c60, 0x78595a6804c9e, 0x2b8324804fc1d}};
+        constexpr Fe FE_INVSQRT_A_MINUS_D = {{0xfdaa805d40ea, 0x2eb482e57d339, 0x7610274bc58, 0x6510b613dc8ff, 0x786c8905cfaff}};
+
+        // 1 - d^2, (d - 1)^2 and sqrt(a d - 1), the constants of the Elligator map
+        constexpr Fe FE_ONE_MINUS_D_SQ = {{0x409c1945fc176, 0x719abc6a1fc4f, 0x1c37f90b20684, 0x6bccca55eedf, 0x29072a8b2b3e}};
+        constexpr Fe FE_D_MINUS_ONE_SQ = {{0x55aaa44ed4d20, 0x59603c3332635, 0x26d3baf4a7928, 0x120a66e6997a9, 0x5968b37af66c2}};
+        constexpr Fe FE_SQRT_AD_MINUS_ONE = {{0x7f6a0497b2e1b, 0x1836f0a97afd2, 0x7d747f6be7638, 0x456079e7e6498, 0x376931bf2b834}};
+
+        // The ed25519 base point, in extended coordinates with Z = 1
+        constexpr GroupElement BASE_POINT = {
+            {{0x62d608f25d51a, 0x412a4b4f6592a, 0x75b7171a4b31d, 0x1ff60527118fe, 0x216936d3cd6e5}},
+            {{0x6666666666658, 0x4cccccccccccc, 0x1999999999999, 0x3333333333333, 0x6666666666666}},
+            {{1, 0, 0, 0, 0}},
+            {{0x68ab3a5b7dda3, 0xeea2a5eadbb, 0x2af8df483c27e, 0x332b375274732, 0x67875f0fd78b7}}};
+
+        // Field arithmetic, as in ref10: products and squares leave their
+        // limbs carried to just above 2^51, sums and differences do not, and
+        // every input stays below 2^54, where the 128-bit products in mul
+        // and sq cannot overflow.
+
+        inline void fe_carry(Fe &h)
+        {
+            uint64_t c;
+            c = h.v[0] >> 51, h.v[0] &= MASK51, h.v[1] += c;
+            c = h.v[1] >> 51, h.v[1] &= MASK51, h.v[2] += c;
+            c = h.v[2] >> 51, h.v[2] &= MASK51, h.v[3] += c;
+            c = h.v[3] >> 51, h.v[3] &= MASK51, h.v[4] += c;
+            c = h.v[4] >> 51, h.v[4] &= MASK51, h.v[0] += 19 * c;
+        }
+
+        inline void fe_add(Fe &h, const Fe &f, const Fe &g)
+        {
+            h.v[0] = f.v[0] + g.v[0];
+            h.v[1] = f.v[1] + g.v[1];
+            h.v[2] = f.v[2] + g.v[2];
+            h.v[3] = f.v[3] + g.v[3];
+            h.v[4] = f.v[4] + g.v[4];
+        }
+
+        // h = f + 2p - g, with g carried first so no limb underflows
+        inline void fe_sub(Fe &h, const Fe &f, const Fe &g)
+        {
+            Fe t = g;
+            fe_carry(t);
+            h.v[0] = f.v[0] + 0xfffffffffffda - t.v[0];
+            h.v[1] = f.v[1] + 0xffffffffffffe - t.v[1];
+            h.v[2] = f.v[2] + 0xffffffffffffe - t.v[2];
+            h.v[3] = f.v[3] + 0xffffffffffffe - t.v[3];
+            h.v[4] = f.v[4] + 0xffffffffffffe - t.v[4];
+        }
+
+        inline void fe_neg(Fe &h, const Fe &f) { fe_sub(h, FE_ZERO, f); }
+
+        inline void fe_mul(Fe &h, const Fe &f, const Fe &g)
+        {
+            const uint64_t f0 = f.v[0], f1 = f.v[1], f2 = f.v[2], f3 = f.v[3], f4 = f.v[4];
+            const uint64_t g0 = g.v[0], g1 = g.v[1], g2 = g.v[2], g3 = g.v[3], g4 = g.v[4];
+            const uint64_t g1_19 = 19 * g1, g2_19 = 19 * g2, g3_19 = 19 * g3, g4_19 = 19 * g4;
+
+            u128 r0 = (u128)f0 * g0 + (u128)f1 * g4_19 + (u128)f2 * g3_19 + (u128)f3 * g2_19 + (u128)f4 * g1_19;
+            u128 r1 = (u128)f0 * g1 + (u128)f1 * g0 + (u128)f2 * g4_19 + (u128)f3 * g3_19 + (u128)f4 * g2_19;
+            u128 r2 = (u128)f0 * g2 + (u128)f1 * g1 + (u128)f2 * g0 + (u128)f3 * g4_19 + (u128)f4 * g3_19;
+            u128 r3 = (u128)f0 * g3 + (u128)f1 * g2 + (u128)f2 * g1 + (u128)f3 * g0 + (u128)f4 * g4_19;
+            u128 r4 = (u128)f0 * g4 + (u128)f1 * g3 + (u128)f2 * g2 + (u128)f3 * g1 + (u128)f4 * g0;
+
+            r1 += (uint64_t)(r0 >> 51);
+            r2 += (uint64_t)(r1 >> 51);
+            r3 += (uint64_t)(r2 >> 51);
+            r4 += (uint64_t)(r3 >> 51);
+            uint64_t h0 = (uint64_t)r0 & MASK51;
+            h0 += 19 * (uint64_t)(r4 >> 51);
+            h.v[1] = ((uint64_t)r1 & MASK51) + (h0 >> 51);
+            h.v[0] = h0 & MASK51;
+            h.v[2] = (uint64_t)r2 & MASK51;
+            h.v[3] = (uint64_t)r3 & MASK51;
+            h.v[4] = (uint64_t)r4 & MASK51;
+        }
+
+        inline void fe_sq(Fe &h, const Fe &f)
+        {
+            const uint64_t f0 = f.v[0], f1 = f.v[1], f2 = f.v[2], f3 = f.v[3], f4 = f.v[4];
+            const uint64_t f0_2 = 2 * f0, f1_2 = 2 * f1;
+            const uint64_t f1_38 = 38 * f1, f2_38 = 38 * f2, f3_38 = 38 * f3;
+            const uint64_t f3_19 = 19 * f3, f4_19 = 19 * f4;
+
+            u128 r0 = (u128)f0 * f0 + (u128)f1_38 * f4 + (u128)f2_38 * f3;
+            u128 r1 = (u128)f0_2 * f1 + (u128)f2_38 * f4 + (u128)f3_19 * f3;
+            u128 r2 = (u128)f0_2 * f2 + (u128)f1 * f1 + (u128)f3_38 * f4;
+            u128 r3 = (u128)f0_2 * f3 + (u128)f1_2 * f2 + (u128)f4_19 * f4;
+            u128 r4 = (u128)f0_2 * f4 + (u128)f1_2 * f3 + (u128)f2 * f2;
+
+            r1 += (uint64_t)(r0 >> 51);
+            r2 += (uint64_t)(r1 >> 51);
+            r3 += (uint64_t)(r2 >> 51);
+            r4 += (uint64_t)(r3 >> 51);
+            uint64_t h0 = (uint64_t)r0 & MASK51;
+            h0 += 19 * (uint64_t)(r4 >> 51);
+            h.v[1] = ((uint64_t)r1 & MASK51) + (h0 >> 51);
+            h.v[0] = h0 & MASK51;
+            h.v[2] = (uint64_t)r2 & MASK51;
+            h.v[3] = (uint64_t)r3 & MASK51;
+            h.v[4] = (uint64_t)r4 & MASK51;
+        }
+
+        // h = f^(2^n)
+        inline void fe_sqn(Fe &h, const Fe &f, int n)
+        {
+            fe_sq(h, f);
+            while (--n > 0)
+                fe_sq(h, h);
+        }
+
+        inline uint64_t load64_le(const unsigned char *s)
+        {
+            uint64_t w = 0;
+            for (int i = 7; i >= 0; i--)
+                w = (w << 8) | s[i];
+            return w;
+        }
+
+        inline void store64_le(unsigned char *s, uint64_t w)
+        {
+            for (int i = 0; i < 8; i++, w >>= 8)
+                s[i] = (unsigned char)w;
+        }
+
+        // Ignores the top bit of s
+        inline void fe_frombytes(Fe &h, const unsigned char *s)
+        {
+            h.v[0] = load64_le(s) & MASK51;
+            h.v[1] = (load64_le(s + 6) >> 3) & MASK51;
+            h.v[2] = (load64_le(s + 12) >> 6) & MASK51;
+            h.v[3] = (load64_le(s + 19) >> 1) & MASK51;
+            h.v[4] = (load64_le(s + 24) >> 12) & MASK51;
+        }
+
+        // Writes the unique representative in [0, p)
+        inline void fe_tobytes(unsigned char *s, const Fe &f)
+        {
+            Fe t = f;
+            fe_carry(t);
+            fe_carry(t);
+
+            // t is now below 2^255 and fully carried. Adding 19 carries out of
+            // bit 255 exactly when t >= p; that carry wraps back in as +19.
+            t.v[0] += 19;
+            fe_carry(t);
+
+            // Add 2^255 - 19 and drop bit 255, which subtracts the 19 again
+            t.v[0] += 0x8000000000000 - 19;
+            for (int i = 1; i < 5; i++)
+                t.v[i] += 0x8000000000000 - 1;
+            t.v[1] += t.v[0] >> 51, t.v[0] &= MASK51;
+            t.v[2] += t.v[1] >> 51, t.v[1] &= MASK51;
+            t.v[3] += t.v[2] >> 51, t.v[2] &= MASK51;
+            t.v[4] += t.v[3] >> 51, t.v[3] &= MASK51;
+            t.v[4] &= MASK51;
+
+            store64_le(s, t.v[0] | (t.v[1] << 51));
+            store64_le(s + 8, (t.v[1] >> 13) | (t.v[2] << 38));
+            store64_le(s + 16, (t.v[2] >> 26) | (t.v[3] << 25));
+            store64_le(s + 24, (t.v[3] >> 39) | (t.v[4] << 12));
+        }
+
+        // f = g if b == 1, unchanged if b == 0
+        inline void fe_cmov(Fe &f, const Fe &g, unsigned b)
+        {
+            const uint64_t mask = 0 - (uint64_t)b;
+            f.v[0] ^= mask & (f.v[0] ^ g.v[0]);
+            f.v[1] ^= mask & (f.v[1] ^ g.v[1]);
+            f.v[2] ^= mask & (f.v[2] ^ g.v[2]);
+            f.v[3] ^= mask & (f.v[3] ^ g.v[3]);
+            f.v[4] ^= mask & (f.v[4] ^ g.v[4]);
+        }
+
+        inline unsigned fe_isnegative(const Fe &f)
+        {
+            unsigned char s[32];
+            fe_tobytes(s, f);
+            return s[0] & 1;
+        }
+
+        inline unsigned fe_iszero(const Fe &f)
+        {
+            unsigned char s[32];
+            fe_tobytes(s, f);
+            unsigned char d = 0;
+            for (unsigned char b : s)
+                d |= b;
+            return 1 & (((unsigned)d - 1) >> 8);
+        }
+
+        inline unsigned fe_equal(const Fe &f, const Fe &g)
+        {
+            Fe h;
+            fe_sub(h, f, g);
+            return fe_iszero(h);
+        }
+
+        inline void fe_cneg(Fe &f, unsigned b)
+        {
+            Fe neg;
+            fe_neg(neg, f);
+            fe_cmov(f, neg, b);
+        }
+
+        inline void fe_abs(Fe &f) { fe_cneg(f, fe_isnegative(f)); }
+
+        // out = z^(p - 2) = 1/z
+        void fe_invert(Fe &out, const Fe &z)
+        {
+            Fe t0, t1, t2, t3;
+            fe_sq(t0, z);           // 2
+            fe_sqn(t1, t0, 2);      // 8
+            fe_mul(t1, z, t1);      // 9
+            fe_mul(t0, t0, t1);     // 11
+            fe_sq(t2, t0);          // 22
+            fe_mul(t1, t1, t2);     // 2^5 - 1
+            fe_sqn(t2, t1, 5);      //
+            fe_mul(t1, t2, t1);     // 2^10 - 1
+            fe_sqn(t2, t1, 10);     //
+            fe_mul(t2, t2, t1);     // 2^20 - 1
+            fe_sqn(t3, t2, 20);     //
+            fe_mul(t2, t3, t2);     // 2^40 - 1
+            fe_sqn(t2, t2, 10);     //
+            fe_mul(t1, t2, t1);     // 2^50 - 1
+            fe_sqn(t2, t1, 50);     //
+            fe_mul(t2, t2, t1);     // 2^100 - 1
+            fe_sqn(t3, t2, 100);    //
+            fe_mul(t2, t3, t2);     // 2^200 - 1
+            fe_sqn(t2, t2, 50);     //
+            fe_mul(t1, t2, t1);     // 2^250 - 1
+            fe_sqn(t1, t1, 5);      // 2^255 - 32
+            fe_mul(out, t1, t0);    // 2^255 - 21
+        }
+
+        // out = z^((p - 5) / 8) = z^(2^252 - 3)
+        void fe_pow22523(Fe &out, const Fe &z)
+        {
+            Fe t0, t1, t2;
+            fe_sq(t0, z);           // 2
+            fe_sqn(t1, t0, 2);      // 8
+            fe_mul(t1, z, t1);      // 9
+            fe_mul(t0, t0, t1);     // 11
+            fe_sq(t0, t0);          // 22
+            fe_mul(t0, t1, t0);     // 2^5 - 1
+            fe_sqn(t1, t0, 5);      //
+            fe_mul(t0, t1, t0);     // 2^10 - 1
+            fe_sqn(t1, t0, 10);     //
+            fe_mul(t1, t1, t0);     // 2^20 - 1
+            fe_sqn(t2, t1, 20);     //
+            fe_mul(t1, t2, t1);     // 2^40 - 1
+            fe_sqn(t1, t1, 10);     //
+            fe_mul(t0, t1, t0);     // 2^50 - 1
+            fe_sqn(t1, t0, 50);     //
+            fe_mul(t1, t1, t0);     // 2^100 - 1
+            fe_sqn(t2, t1, 100);    //
+            fe_mul(t1, t2, t1);     // 2^200 - 1
+            fe_sqn(t1, t1, 50);     //
+            fe_mul(t0, t1, t0);     // 2^250 - 1
+            fe_sqn(t0, t0, 2);      // 2^252 - 4
+            fe_mul(out, t0, z);     // 2^252 - 3
+        }
+
+        // SQRT_RATIO_M1 (RFC 9496) split around its exponentiation, so that a
+        // batch can run all its exponentiations side by side: begin sets w to
+        // u v^7, the caller raises w to (p - 5) / 8, and end finishes the root.
+        struct SqrtRatio
+        {
+            Fe u, v, v3, w;
+        };
+
+        void sqrt_ratio_begin(SqrtRatio &q, const Fe &u, const Fe &v)
+        {
+            Fe v7;
+            q.u = u;
+            q.v = v;
+            fe_sq(q.v3, v);
+            fe_mul(q.v3, q.v3, v); // v^3
+            fe_sq(v7, q.v3);
+            fe_mul(v7, v7, v); // v^7
+            fe_mul(q.w, u, v7);
+        }
+
+        // r = sqrt(u / v) made non-negative, or sqrt(i * u / v) when u / v is
+        // not a square. Returns 1 in the first case.
+        unsigned sqrt_ratio_end(Fe &r, const SqrtRatio &q)
+        {
+            Fe check, u_neg, u_neg_i, r_prime;
+            fe_mul(r, q.w, q.v3);
+            fe_mul(r, r, q.u); // (u v^3) (u v^7)^((p - 5) / 8)
+
+            fe_sq(check, r);
+            fe_mul(check, check, q.v);
+            fe_neg(u_neg, q.u);
+            fe_mul(u_neg_i, u_neg, FE_SQRTM1);
+
+            unsigned correct_sign = fe_equal(check, q.u);
+            unsigned flipped_sign = fe_equal(check, u_neg);
+            unsigned flipped_sign_i = fe_equal(check, u_neg_i);
+
+            fe_mul(r_prime, r, FE_SQRTM1);
+            fe_cmov(r, r_prime, flipped_sign | flipped_sign_i);
+            fe_abs(r);
+            return correct_sign | flipped_sign;
+        }
+
+        unsigned fe_sqrt_ratio_m1(Fe &r, const Fe &u, const Fe &v)
+        {
+            SqrtRatio q;
+            sqrt_ratio_begin(q, u, v);
+            fe_pow22523(q.w, q.w);
+            return sqrt_ratio_end(r, q);
+        }
+
+        // Points per chunk of from_hash_batch and encode_batch, whose scratch
+        // lives on the stack
+        constexpr size_t BATCH_CHUNK = 32;
+
+        // Raises the pending root of each item to (p - 5) / 8, several per SIMD register
+        template <typename Pending>
+        void pow_roots(Pending *pending, size_t n)
+        {
+            Fe w[2 * BATCH_CHUNK];
+            for (size_t i = 0; i < n; i++)
+                w[i] = pending[i].root.w;
+            pow22523_lanes(w, w, n);
+            for (size_t i = 0; i < n; i++)
+                pending[i].root.w = w[i];
+        }
+
+        // The Elligator map of 32 bytes to a point (MAP, RFC 9496), split around
+        // its inverse square root like SqrtRatio
+        struct Elligator
+        {
+            Fe t, r;
+            SqrtRatio root;
+        };
+
+        void elligator_begin(Elligator &e, const unsigned char *bytes)
+        {
+            Fe u, v, c, r_plus_d;
+            fe_frombytes(e.t, bytes);
+            fe_sq(e.r, e.t);
+            fe_mul(e.r, e.r, FE_SQRTM1); // r = i t^2
+
+            fe_add(u, e.r, FE_ONE);
+            fe_mul(u, u, FE_ONE_MINUS_D_SQ); // u = (r + 1)(1 - d^2)
+
+            fe_neg(c, FE_ONE);
+            fe_add(r_plus_d, e.r, FE_D);
+            fe_mul(v, e.r, FE_D);
+            fe_sub(v, c, v);
+            fe_mul(v, v, r_plus_d); // v = (-1 - r d)(r + d)
+
+            sqrt_ratio_begin(e.root, u, v);
+        }
+
+        void elligator_end(GroupElement &p, const Elligator &e)
+        {
+            Fe s, s_prime, c, n, w0, w1, w2, w3, ss;
+            unsigned wasnt_square = 1 - sqrt_ratio_end(s, e.root);
+
+            fe_mul(s_prime, s, e.t);
+            fe_abs(s_prime);
+            fe_neg(s_prime, s_prime); // s' = -|s t|
+            fe_cmov(s, s_prime, wasnt_square);
+            fe_neg(c, FE_ONE);
+            fe_cmov(c, e.r, wasnt_square);
+
+            fe_sub(n, e.r, FE_ONE);
+            fe_mul(n, n, c);
+            fe_mul(n, n, FE_D_MINUS_ONE_SQ);
+            fe_sub(n, n, e.root.v); // n = c (r - 1)(d - 1)^2 - v
+
+            fe_add(w0, s, s);
+            fe_mul(w0, w0, e.root.v); // w0 = 2 s v
+            fe_mul(w1, n, FE_SQRT_AD_MINUS_ONE);
+            fe_sq(ss, s);
+            fe_sub(w2, FE_ONE, ss);
+            fe_add(w3, FE_ONE, ss);
+
+            fe_mul(p.X, w0, w3);
+            fe_mul(p.Y, w2, w1);
+            fe_mul(p.Z, w1, w3);
+            fe_mul(p.T, w0, w2);
+        }
+
+        // The ristretto255 encoding, split around its inverse square root like SqrtRatio
+        struct Encoding
+        {
+            Fe u1, u2;
+            SqrtRatio root;
+        };
+
+        void encoding_begin(Encoding &e, const GroupElement &p)
+        {
+            Fe t, u1_u2u2;
+
+            // u1 = (Z + Y)(Z - Y), u2 = X Y
+            fe_add(t, p.Z, p.Y);
+            fe_sub(e.u1, p.Z, p.Y);
+            fe_mul(e.u1, e.u1, t);
+            fe_mul(e.u2, p.X, p.Y);
+
+            fe_sq(u1_u2u2, e.u2);
+            fe_mul(u1_u2u2, u1_u2u2, e.u1);
+            sqrt_ratio_begin(e.root, FE_ONE, u1_u2u2);
+        }
+
+        void encoding_end(Point &s, const GroupElement &p, const Encoding &e)
+        {
+            Fe inv_sqrt, den1, den2, z_inv, ix, iy, enchanted_denominator;
+            Fe x, y, den_inv, t;
+            sqrt_ratio_end(inv_sqrt, e.root);
+
+            fe_mul(den1, inv_sqrt, e.u1);
+            fe_mul(den2, inv_sqrt, e.u2);
+            fe_mul(z_inv, den1, den2);
+            fe_mul(z_inv, z_inv, p.T);
+
+            fe_mul(ix, p.X, FE_SQRTM1);
+            fe_mul(iy, p.Y, FE_SQRTM1);
+            fe_mul(enchanted_denominator, den1, FE_INVSQRT_A_MINUS_D);
+
+            fe_mul(t, p.T, z_inv);
+            unsigned rotate = fe_isnegative(t);
+
+            x = p.X;
+            y = p.Y;
+            den_inv = den2;
+            fe_cmov(x, iy, rotate);
+            fe_cmov(y, ix, rotate);
+            fe_cmov(den_inv, enchanted_denominator, rotate);
+
+            fe_mul(t, x, z_inv);
+            fe_cneg(y, fe_isnegative(t));
+
+            // s = |den_inv (Z - Y)|
+            fe_sub(t, p.Z, y);
+            fe_mul(t, den_inv, t);
+            fe_abs(t);
+            fe_tobytes(s.data(), t);
+        }
+
+        // Curve representations from ref10: completed (P1p1) results of an
+        // addition or doubling, projective (P2) inputs to doubling, and the
+        // cached and precomputed (affine) forms of addends.
+
+        struct P1p1
+        {
+            Fe X, Y, Z, T;
+        };
+
+        struct P2
+        {
+            Fe X, Y, Z;
+        };
+
+        struct Cached
+        {
+            Fe YplusX, YminusX, Z, T2d;
+        };
+
+        struct Precomp
+        {
+            Fe yplusx, yminusx, xy2d;
+        };
+
+        inline void to_cached(Cached &r, const GroupElement &p)
+        {
+            fe_add(r.YplusX, p.Y, p.X);
+            fe_sub(r.YminusX, p.Y, p.X);
+            r.Z = p.Z;
+            fe_mul(r.T2d, p.T, FE_D2);
+        }
+
+        inline void p1p1_to_p2(P2 &r, const P1p1 &p)
+        {
+            fe_mul(r.X, p.X, p.T);
+            fe_mul(r.Y, p.Y, p.Z);
+            fe_mul(r.Z, p.Z, p.T);
+        }
+
+        inline void p1p1_to_p3(GroupElement &r, const P1p1 &p)
+        {
+            fe_mul(r.X, p.X, p.T);
+            fe_mul(r.Y, p.Y, p.Z);
+            fe_mul(r.Z, p.Z, p.T);
+            fe_mul(r.T, p.X, p.Y);
+        }
+
+        inline void p2_dbl(P1p1 &r, const P2 &p)
+        {
+            Fe t0;
+            fe_sq(r.X, p.X);
+            fe_sq(r.Z, p.Y);
+            fe_sq(r.T, p.Z);
+            fe_add(r.T, r.T, r.T);
+            fe_add(r.Y, p.X, p.Y);
+            fe_sq(t0, r.Y);
+            fe_add(r.Y, r.Z, r.X);
+            fe_sub(r.Z, r.Z, r.X);
+            fe_sub(r.X, t0, r.Y);
+            fe_sub(r.T, r.T, r.Z);
+        }
+
+        inline void p3_dbl(P1p1 &r, const GroupElement &p)
+        {
+            P2 q{p.X, p.Y, p.Z};
+            p2_dbl(r, q);
+        }
+
+        inline void add_cached(P1p1 &r, const GroupElement &p, const Cached &q)
+        {
+            Fe t0;
+            fe_add(r.X, p.Y, p.X);
+            fe_sub(r.Y, p.Y, p.X);
+            fe_mul(r.Z, r.X, q.YplusX);
+            fe_mul(r.Y, r.Y, q.YminusX);
+            fe_mul(r.T, q.T2d, p.T);
+            fe_mul(r.X, p.Z, q.Z);
+            fe_add(t0, r.X, r.X);
+            fe_sub(r.X, r.Z, r.Y);
+            fe_add(r.Y, r.Z, r.Y);
+            fe_add(r.Z, t0, r.T);
+            fe_sub(r.T, t0, r.T);
+        }
+
+        inline void sub_cached(P1p1 &r, const GroupElement &p, const Cached &q)
+        {
+            Fe t0;
+            fe_add(r.X, p.Y, p.X);
+            fe_sub(r.Y, p.Y, p.X);
+            fe_mul(r.Z, r.X, q.YminusX);
+            fe_mul(r.Y, r.Y, q.YplusX);
+            fe_mul(r.T, q.T2d, p.T);
+            fe_mul(r.X, p.Z, q.Z);
+            fe_add(t0, r.X, r.X);
+            fe_sub(r.X, r.Z, r.Y);
+            fe_add(r.Y, r.Z, r.Y);
+            fe_sub(r.Z, t0, r.T);
+            fe_add(r.T, t0, r.T);
+        }
+
+        inline void add_precomp(P1p1 &r, const GroupElement &p, const Precomp &q)
+        {
+            Fe t0;
+            fe_add(r.X, p.Y, p.X);
+            fe_sub(r.Y, p.Y, p.X);
+            fe_mul(r.Z, r.X, q.yplusx);
+            fe_mul(r.Y, r.Y, q.yminusx);
+            fe_mul(r.T, q.xy2d, p.T);
+            fe_add(t0, p.Z, p.Z);
+            fe_sub(r.X, r.Z, r.Y);
+            fe_add(r.Y, r.Z, r.Y);
+            fe_add(r.Z, t0, r.T);
+            fe_sub(r.T, t0, r.T);
+        }
+
+        inline unsigned char ct_equal(unsigned char b, unsigned char c)
+        {
+            return (unsigned char)(((uint32_t)(b ^ c) - 1U) >> 31);
+        }
+
+        inline unsigned char ct_negative(signed char b)
+        {
+            return (unsigned char)((uint64_t)(int64_t)b >> 63);
+        }
+
+        // t = b * pi[0] for b in [-8, 8], where pi[j] = (j + 1) * P, without secret-dependent branches or loads
+        void select_cached(Cached &t, const Cached pi[8], signed char b)
+        {
+            const unsigned char negative = ct_negative(b);
+            const unsigned char babs = (unsigned char)(b - (((-negative) & b) * 2));
+
+            t = Cached{FE_ONE, FE_ONE, FE_ONE, FE_ZERO};
+            for (int j = 0; j < 8; j++)
+            {
+                unsigned char match = ct_equal(babs, (unsigned char)(j + 1));
+                fe_cmov(t.YplusX, pi[j].YplusX, match);
+                fe_cmov(t.YminusX, pi[j].YminusX, match);
+                fe_cmov(t.Z, pi[j].Z, match);
+                fe_cmov(t.T2d, pi[j].T2d, match);
+            }
+
+            Cached minus{t.YminusX, t.YplusX, t.Z, {}};
+            fe_neg(minus.T2d, t.T2d);
+            fe_cmov(t.YplusX, minus.YplusX, negative);
+            fe_cmov(t.YminusX, minus.YminusX, negative);
+            fe_cmov(t.T2d, minus.T2d, negative);
+        }
+
+        void select_precomp(Precomp &t, const Precomp row[8], signed char b)
+        {
+            const unsigned char negative = ct_negative(b);
+            const unsigned char babs = (unsigned char)(b - (((-negative) & b) * 2));
+
+            t = Precomp{FE_ONE, FE_ONE, FE_ZERO};
+            for (int j = 0; j < 8; j++)
+            {
+                unsigned char match = ct_equal(babs, (unsigned char)(j + 1));
+                fe_cmov(t.yplusx, row[j].yplusx, match);
+                fe_cmov(t.yminusx, row[j].yminusx, match);
+                fe_cmov(t.xy2d, row[j].xy2d, match);
+            }
+
+            Precomp minus{t.yminusx, t.yplusx, {}};
+            fe_neg(minus.xy2d, t.xy2d);
+            fe_cmov(t.yplusx, minus.yplusx, negative);
+            fe_cmov(t.yminusx, minus.yminusx, negative);
+            fe_cmov(t.xy2d, minus.xy2d, negative);
+        }
+
+        // table[i][j] = (j + 1) * 256^i * g in affine form, built on first use
+        struct BaseTable
+        {
+            Precomp table[32][8];
+
+            BaseTable()
+            {
+                GroupElement points[32][8];
+                GroupElement row_base = BASE_POINT;
+                for (int i = 0; i < 32; i++)
+                {
+                    Cached base_cached;
+                    to_cached(base_cached, row_base);
+                    points[i][0] = row_base;
+                    for (int j = 1; j < 8; j++)
+                    {
+                        P1p1 sum;
+                        add_cached(sum, points[i][j - 1], base_cached);
+                        p1p1_to_p3(points[i][j], sum);
+                    }
+                    for (int d = 0; d < 8; d++)
+                    {
+                        P1p1 dbl;
+                        p3_dbl(dbl, row_base);
+                        p1p1_to_p3(row_base, dbl);
+                    }
+                }
+
+                // One inversion for all 256 Z coordinates (Montgomery's trick)
+                GroupElement *flat = &points[0][0];
+                Fe prefix[256];
+                Fe acc = FE_ONE;
+                for (int n = 0; n < 256; n++)
+                {
+                    prefix[n] = acc;
+                    fe_mul(acc, acc, flat[n].Z);
+                }
+                Fe inv;
+                fe_invert(inv, acc);
+                for (int n = 255; n >= 0; n--)
+                {
+                    Fe z_inv, x, y;
+                    fe_mul(z_inv, inv, prefix[n]);
+                    fe_mul(inv, inv, flat[n].Z);
+                    fe_mul(x, flat[n].X, z_inv);
+                    fe_mul(y, flat[n].Y, z_inv);
+
+                    Precomp &out = table[n / 8][n % 8];
+                    fe_add(out.yplusx, y, x);
+                    fe_sub(out.yminusx, y, x);
+                    fe_mul(out.xy2d, x, y);
+                    fe_mul(out.xy2d, out.xy2d, FE_D2);
+                }
+            }
+        };
+
+        const BaseTable &base_table()
+        {
+            static const BaseTable table;
+            return table;
+        }
+    }
+
+    void pow22523(Fe &out, const Fe &z)
+    {
+        fe_pow22523(out, z);
+    }
+
+    void to_radix16(signed char e[64], const Scalar &k)
+    {
+        for (int i = 0; i < 32; i++)
+        {
+            unsigned char byte = (i == 31) ? (k[i] & 127) : k[i];
+            e[2 * i] = (signed char)(byte & 15);
+            e[2 * i + 1] = (signed char)(byte >> 4);
+        }
+        signed char carry = 0;
+        for (int i = 0; i < 63; i++)
+        {
+            e[i] += carry;
+            carry = (signed char)((e[i] + 8) >> 4);
+            e[i] -= (signed char)(carry * 16);
+        }
+        e[63] += carry;
+    }
+
+    bool decode(GroupElement &p, const Point &s)
+    {
+        // Reject non-canonical field encodings (s >= p or bit 255 set) and negative s
+        Fe s_;
+        fe_frombytes(s_, s.data());
+        Point canonical;
+        fe_tobytes(canonical.data(), s_);
+        unsigned char diff = 0;
+        for (size_t i = 0; i < POINT_LEN; i++)
+            diff |= canonical[i] ^ s[i];
+        if (diff != 0 || (s[0] & 1) != 0)
+            return false;
+
+        Fe ss, u1, u2, u2_sqr, v, inv_sqrt, den_x, den_y, t;
+        fe_sq(ss, s_);
+        fe_sub(u1, FE_ONE, ss); // 1 + a s^2 with a = -1
+        fe_add(u2, FE_ONE, ss); // 1 - a s^2
+        fe_sq(u2_sqr, u2);
+
+        // v = -(d u1^2) - u2^2
+        fe_sq(v, u1);
+        fe_mul(v, v, FE_D);
+        fe_neg(v, v);
+        fe_sub(v, v, u2_sqr);
+
+        fe_mul(t, v, u2_sqr);
+        unsigned was_square = fe_sqrt_ratio_m1(inv_sqrt, FE_ONE, t);
+
+        fe_mul(den_x, inv_sqrt, u2);
+        fe_mul(den_y, inv_sqrt, den_x);
+        fe_mul(den_y, den_y, v);
+
+        // x = |2 s den_x|, y = u1 den_y, t = x y
+        fe_mul(p.X, s_, den_x);
+        fe_add(p.X, p.X, p.X);
+        fe_abs(p.X);
+        fe_carry(p.X);
+        fe_mul(p.Y, u1, den_y);
+        p.Z = FE_ONE;
+        fe_mul(p.T, p.X, p.Y);
+
+        return (was_square & (1 - fe_isnegative(p.T)) & (1 - fe_iszero(p.Y))) != 0;
+    }
+
+    void encode(Point &s, const GroupElement &p)
+    {
+        Encoding e;
+        encoding_begin(e, p);
+        fe_pow22523(e.root.w, e.root.w);
+        encoding_end(s, p, e);
+    }
+
+    void encode_batch(Point *s, const GroupElement *p, size_t n)
+    {
+        Encoding e[BATCH_CHUNK];
+        for (size_t i = 0; i < n; i += BATCH_CHUNK)
+        {
+            const size_t m = std::min(BATCH_CHUNK, n - i);
+            for (size_t j = 0; j < m; j++)
+                encoding_begin(e[j], p[i + j]);
+            pow_roots(e, m);
+            for (size_t j = 0; j < m; j++)
+                encoding_end(s[i + j], p[i + j], e[j]);
+        }
+    }
+
+    void from_hash(GroupElement &p, const unsigned char *h)
+    {
+        from_hash_batch(&p, h, 1);
+    }
+
+    void from_hash_batch(GroupElement *p, const unsigned char *h, size_t n)
+    {
+        // Each point is the sum of the maps of the two halves of its 64 bytes
+        Elligator e[2 * BATCH_CHUNK];
+        for (size_t i = 0; i < n; i += BATCH_CHUNK)
+        {
+            const size_t m = std::min(BATCH_CHUNK, n - i);
+            for (size_t j = 0; j < 2 * m; j++)
+                elligator_begin(e[j], h + 64 * i + 32 * j);
+            pow_roots(e, 2 * m);
+            for (size_t j = 0; j < m; j++)
+            {
+                GroupElement p0, p1;
+                elligator_end(p0, e[2 * j]);
+                elligator_end(p1, e[2 * j + 1]);
+                add(p[i + j], p0, p1);
+            }
+        }
+    }
+
+    void add(GroupElement &r, const GroupElement &p, const GroupElement &q)
+    {
+        Cached q_cached;
+        P1p1 sum;
+        to_cached(q_cached, q);
+        add_cached(sum, p, q_cached);
+        p1p1_to_p3(r, sum);
+    }
+
+    void sub(GroupElement &r, const GroupElement &p, const GroupElement &q)
+    {
+        Cached q_cached;
+        P1p1 diff;
+        to_cached(q_cached, q);
+        sub_cached(diff, p, q_cached);
+        p1p1_to_p3(r, diff);
+    }
+
+    void scalarmult_base(GroupElement &r, const Scalar &k)
+    {
+        const BaseTable &base = base_table();
+        signed char e[64];
+        to_radix16(e, k);
+
+        Precomp t;
+        P1p1 sum;
+        P2 s;
+        GroupElement h = IDENTITY;
+
+        // Odd digits, times 16, then even digits: 64 table additions, 4 doublings
+        for (int i = 1; i < 64; i += 2)
+        {
+            select_precomp(t, base.table[i / 2], e[i]);
+            add_precomp(sum, h, t);
+            p1p1_to_p3(h, sum);
+        }
+
+        p3_dbl(sum, h);
+        p1p1_to_p2(s, sum);
+        p2_dbl(sum, s);
+        p1p1_to_p2(s, sum);
+        p2_dbl(sum, s);
+        p1p1_to_p2(s, sum);
+        p2_dbl(sum, s);
+        p1p1_to_p3(h, sum);
+
+        for (int i = 0; i < 64; i += 2)
+        {
+            select_precomp(t, base.table[i / 2], e[i]);
+            add_precomp(sum, h, t);
+            p1p1_to_p3(h, sum);
+        }
+
+        r = h;
+        sodium_memzero(e, sizeof e);
+        sodium_memzero(&t, sizeof t);
+    }
+
+    void scalarmult(GroupElement &r, const Scalar &k, const GroupElement &p)
+    {
+        signed char e[64];
+        to_radix16(e, k);
+
+        // pi[j] = (j + 1) * p: even multiples by doubling, odd ones by adding p
+        GroupElement multiples[8];
+        Cached pi[8];
+        P1p1 sum;
+        multiples[0] = p;
+        to_cached(pi[0], p);
+        for (int j = 1; j < 8; j++)
+        {
+            if (j % 2 == 1)
+                p3_dbl(sum, multiples[(j - 1) / 2]);
+            else
+                add_cached(sum, multiples[j - 1], pi[0]);
+            p1p1_to_p3(multiples[j], sum);
+            to_cached(pi[j], multiples[j]);
+        }
+
+        Cached t;
+        P2 s;
+        GroupElement h = IDENTITY;
+        for (int i = 63; i > 0; i--)
+        {
+            select_cached(t, pi, e[i]);
+            add_cached(sum, h, t);
+            p1p1_to_p2(s, sum);
+            p2_dbl(sum, s);
+            p1p1_to_p2(s, sum);
+            p2_dbl(sum, s);
+            p1p1_to_p2(s, sum);
+            p2_dbl(sum, s);
+            p1p1_to_p2(s, sum);
+            p2_dbl(sum, s);
+            p1p1_to_p3(h, sum);
+        }
+        select_cached(t, pi, e[0]);
+        add_cached(sum, h, t);
+        p1p1_to_p3(r, sum);
+
+        sodium_memzero(e, sizeof e);
+        sodium_memzero(&t, sizeof t);
+    }
+
+    bool is_identity(const GroupElement &p)
+    {
+        // The identity's class is the 4-torsion {(0, 1), (0, -1), (i, 0), (-i, 0)}
+        return (fe_iszero(p.X) | fe_iszero(p.Y)) != 0;
+    }
+}
@@ -0,0 +1,76 @@
+#ifndef RISTRETTO255_HPP
+#define RISTRETTO255_HPP
+
+#include <cstdint>
+#include "protoss_protocol.hpp"
+
+// Vendored ristretto255 group arithmetic (RFC 9496) that keeps points in
+// extended twisted Edwards coordinates between operations. libsodium only
+// exposes ristretto255 through 32-byte encodings, so every add, sub and
+// scalar multiplication there decodes its inputs and encodes its output,
+// each costing an inverse square root. With this module a protocol step
+// decodes its inputs once, chains the group operations, and encodes only the
+// points that leave it.
+//
+// The field and curve formulas follow libsodium's ref10 code (5 x 51-bit
+// limbs); encodings are byte-for-byte identical to libsodium's. All functions
+// that touch secret scalars run in constant time.
+namespace protoss::ristretto255
+{
+    // Element of GF(2^255 - 19) in radix 2^51
+    struct Fe
+    {
+        uint64_t v[5];
+    };
+
+    // Point in extended coordinates (X : Y : Z : T) with x = X/Z, y = Y/Z, xy = T/Z
+    struct GroupElement
+    {
+        Fe X, Y, Z, T;
+    };
+
+    // The neutral element (0 : 1 : 1 : 0)
+    inline constexpr GroupElement IDENTITY = {{{0, 0, 0, 0, 0}}, {{1, 0, 0, 0, 0}}, {{1, 0, 0, 0, 0}}, {{0, 0, 0, 0, 0}}};
+
+    // Decodes a ristretto255 encoding; returns false for non-canonical or invalid
+    // input. Encodings with bit 255 set are rejected as RFC 9496 requires;
+    // libsodium 1.0.18 ignores that bit, later releases reject it too.
+    bool decode(GroupElement &p, const Point &s);
+
+    // Writes the canonical encoding of p
+    void encode(Point &s, const GroupElement &p);
+
+    // Maps 64 uniform bytes to a point exactly as crypto_core_ristretto255_from_hash
+    void from_hash(GroupElement &p, const unsigned char *h);
+
+    // Batched from_hash (64 bytes of h per point) and encode, identical to
+    // the one-at-a-time calls. Each point costs inverse square roots, which
+    // are exponentiations that Montgomery's trick cannot share; instead the
+    // exponentiations of a batch run several per SIMD register through
+    // ristretto255_lanes.hpp.
+    void from_hash_batch(GroupElement *p, const unsigned char *h, size_t n);
+    void encode_batch(Point *s, const GroupElement *p, size_t n);
+
+    // r = p + q and r = p - q
+    void add(GroupElement &r, const GroupElement &p, const GroupElement &q);
+    void sub(GroupElement &r, const GroupElement &p, const GroupElement &q);
+
+    // r = k * g. Like libsodium, the top bit of k is ignored.
+    void scalarmult_base(GroupElement &r, const Scalar &k);
+
+    // r = k * p. Like libsodium, the top bit of k is ignored.
+    void scalarmult(GroupElement &r, const Scalar &k, const GroupElement &p);
+
+    // True if p encodes to the identity (all-zero) encoding
+    bool is_identity(const GroupElement &p);
+
+    // out = z^((p - 5) / 8), the exponentiation inside every inverse square
+    // root; shared with the multi-lane backends
+    void pow22523(Fe &out, const Fe &z);
+
+    // Splits k, top bit cleared, into 64 signed radix-16 digits in [-8, 8] with
+    // k = sum e[i] 16^i; shared with the multi-lane backends
+    void to_radix16(signed char e[64], const Scalar &k);
+}
+
+#endif // RISTRETTO255_HPP
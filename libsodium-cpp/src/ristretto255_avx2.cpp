@@ -0,0 +1,236 @@
+#include "ristretto255_lanes.hpp"
+
+#ifdef PROTOSS_X86_LANES
+
+#include <immintrin.h>
+
+// Everything below is compiled for AVX2 and only called after the dispatcher
+// in ristretto255_lanes.cpp has checked for it
+#pragma GCC push_options
+#pragma GCC target("avx2")
+
+#include "ristretto255_lanes_impl.hpp"
+
+namespace protoss::ristretto255
+{
+    namespace
+    {
+        // Four field elements in radix 2^25.5: ten limbs of alternately 26 and 25
+        // bits, one 64-bit lane per element. _mm256_mul_epu32 multiplies the low
+        // 32 bits of each lane, so every operation leaves its limbs carried to at
+        // most a few units above 2^26 / 2^25; products then stay below 2^61.
+        struct FieldAvx2
+        {
+            static constexpr size_t LANES = 4;
+            // A padded block costs about as much as four scalar multiplications
+            static constexpr size_t MIN_TAIL = 4;
+
+            struct Elem
+            {
+                __m256i v[10];
+            };
+
+            struct Digits
+            {
+                __m256i abs;
+                __m256i negative;
+            };
+
+            static constexpr int bits(int i) { return i % 2 == 0 ? 26 : 25; }
+
+            static __m256i times19(__m256i c)
+            {
+                return _mm256_add_epi64(c, _mm256_add_epi64(_mm256_slli_epi64(c, 1), _mm256_slli_epi64(c, 4)));
+            }
+
+            // All limbs at once: enough after an addition or subtraction
+            static void carry(Elem &h)
+            {
+                __m256i c[10];
+#pragma GCC unroll 10
+                for (int i = 0; i < 10; i++)
+                {
+                    c[i] = _mm256_srli_epi64(h.v[i], bits(i));
+                    h.v[i] = _mm256_and_si256(h.v[i], _mm256_set1_epi64x((int64_t(1) << bits(i)) - 1));
+                }
+#pragma GCC unroll 9
+                for (int i = 1; i < 10; i++)
+                    h.v[i] = _mm256_add_epi64(h.v[i], c[i - 1]);
+                h.v[0] = _mm256_add_epi64(h.v[0], times19(c[9]));
+            }
+
+            static Elem constant(const Fe &c)
+            {
+                Elem e;
+                for (int m = 0; m < 5; m++)
+                {
+                    e.v[2 * m] = _mm256_set1_epi64x(int64_t(c.v[m] & ((uint64_t(1) << 26) - 1)));
+                    e.v[2 * m + 1] = _mm256_set1_epi64x(int64_t(c.v[m] >> 26));
+                }
+                return e;
+            }
+
+            static void load(Elem &e, const Fe *const lanes[LANES])
+            {
+                for (int m = 0; m < 5; m++)
+                {
+                    uint64_t lo[LANES], hi[LANES];
+                    for (size_t l = 0; l < LANES; l++)
+                    {
+                        lo[l] = lanes[l]->v[m] & ((uint64_t(1) << 26) - 1);
+                        hi[l] = lanes[l]->v[m] >> 26;
+                    }
+                    e.v[2 * m] = _mm256_loadu_si256((const __m256i *)lo);
+                    e.v[2 * m + 1] = _mm256_loadu_si256((const __m256i *)hi);
+                }
+                carry(e);
+                carry(e);
+            }
+
+            static void store(Fe *const lanes[LANES], const Elem &e)
+            {
+                for (int m = 0; m < 5; m++)
+                {
+                    uint64_t lo[LANES], hi[LANES];
+                    _mm256_storeu_si256((__m256i *)lo, e.v[2 * m]);
+                    _mm256_storeu_si256((__m256i *)hi, e.v[2 * m + 1]);
+                    for (size_t l = 0; l < LANES; l++)
+                        lanes[l]->v[m] = lo[l] + (hi[l] << 26);
+                }
+            }
+
+            static void add(Elem &h, const Elem &f, const Elem &g)
+            {
+#pragma GCC unroll 10
+                for (int i = 0; i < 10; i++)
+                    h.v[i] = _mm256_add_epi64(f.v[i], g.v[i]);
+                carry(h);
+            }
+
+            // h = f + 2p - g
+            static void sub(Elem &h, const Elem &f, const Elem &g)
+            {
+#pragma GCC unroll 10
+                for (int i = 0; i < 10; i++)
+                {
+                    const int64_t two_p = i == 0 ? (int64_t(1) << 27) - 38 : (int64_t(1) << (bits(i) + 1)) - 2;
+                    h.v[i] = _mm256_sub_epi64(_mm256_add_epi64(f.v[i], _mm256_set1_epi64x(two_p)), g.v[i]);
+                }
+                carry(h);
+            }
+
+            static void neg(Elem &h, const Elem &f)
+            {
+                Elem zero;
+                for (auto &limb : zero.v)
+                    limb = _mm256_setzero_si256();
+                sub(h, zero, f);
+            }
+
+            // Sequential carry of a product: limb 9 wraps into limb 0 times 19,
+            // then 0 into 1 once more
+            static void carry_product(Elem &h, __m256i r[10])
+            {
+#pragma GCC unroll 9
+                for (int i = 0; i < 9; i++)
+                {
+                    r[i + 1] = _mm256_add_epi64(r[i + 1], _mm256_srli_epi64(r[i], bits(i)));
+                    r[i] = _mm256_and_si256(r[i], _mm256_set1_epi64x((int64_t(1) << bits(i)) - 1));
+                }
+                r[0] = _mm256_add_epi64(r[0], times19(_mm256_srli_epi64(r[9], 25)));
+                r[9] = _mm256_and_si256(r[9], _mm256_set1_epi64x((int64_t(1) << 25) - 1));
+                r[1] = _mm256_add_epi64(r[1], _mm256_srli_epi64(r[0], 26));
+                r[0] = _mm256_and_si256(r[0], _mm256_set1_epi64x((int64_t(1) << 26) - 1));
+#pragma GCC unroll 10
+                for (int i = 0; i < 10; i++)
+                    h.v[i] = r[i];
+            }
+
+            // mul and sq stay out of line: inlined into every curve formula at
+            // -O3 they made the ladder about 40% slower
+            __attribute__((noinline)) static void mul(Elem &h, const Elem &f, const Elem &g)
+            {
+                // Odd-by-odd limb products carry an extra factor 2, and products
+                // that wrap past 2^255 a factor 19
+                __m256i f2[10], g19[10], r[10];
+#pragma GCC unroll 10
+                for (int i = 0; i < 10; i++)
+                {
+                    f2[i] = i % 2 == 1 ? _mm256_add_epi64(f.v[i], f.v[i]) : f.v[i];
+                    g19[i] = _mm256_mul_epu32(g.v[i], _mm256_set1_epi64x(19));
+                    r[i] = _mm256_setzero_si256();
+                }
+#pragma GCC unroll 10
+                for (int i = 0; i < 10; i++)
+                {
+#pragma GCC unroll 10
+                    for (int j = 0; j < 10; j++)
+                    {
+                        const __m256i fi = (i % 2 == 1 && j % 2 == 1) ? f2[i] : f.v[i];
+                        const __m256i gj = i + j >= 10 ? g19[j] : g.v[j];
+                        r[(i + j) % 10] = _mm256_add_epi64(r[(i + j) % 10], _mm256_mul_epu32(fi, gj));
+                    }
+                }
+                carry_product(h, r);
+            }
+
+            // As mul, with each cross product computed once and doubled
+            __attribute__((noinline)) static void sq(Elem &h, const Elem &f)
+            {
+                __m256i f2[10], f4[10], f19[10], r[10];
+#pragma GCC unroll 10
+                for (int i = 0; i < 10; i++)
+                {
+                    f2[i] = _mm256_add_epi64(f.v[i], f.v[i]);
+                    f4[i] = _mm256_add_epi64(f2[i], f2[i]);
+                    f19[i] = _mm256_mul_epu32(f.v[i], _mm256_set1_epi64x(19));
+                    r[i] = _mm256_setzero_si256();
+                }
+#pragma GCC unroll 10
+                for (int i = 0; i < 10; i++)
+                {
+#pragma GCC unroll 10
+                    for (int j = i; j < 10; j++)
+                    {
+                        const int factor = (i < j ? 2 : 1) * (i % 2 == 1 && j % 2 == 1 ? 2 : 1);
+                        const __m256i fi = factor == 4 ? f4[i] : factor == 2 ? f2[i] : f.v[i];
+                        const __m256i fj = i + j >= 10 ? f19[j] : f.v[j];
+                        r[(i + j) % 10] = _mm256_add_epi64(r[(i + j) % 10], _mm256_mul_epu32(fi, fj));
+                    }
+                }
+                carry_product(h, r);
+            }
+
+            static void select(Elem &f, const Elem &g, __m256i mask)
+            {
+#pragma GCC unroll 10
+                for (int i = 0; i < 10; i++)
+                    f.v[i] = _mm256_blendv_epi8(f.v[i], g.v[i], mask);
+            }
+
+            static Digits digits(const signed char (*e)[64], int i)
+            {
+                const __m256i d = _mm256_set_epi64x(e[3][i], e[2][i], e[1][i], e[0][i]);
+                const __m256i negative = _mm256_cmpgt_epi64(_mm256_setzero_si256(), d);
+                return Digits{_mm256_sub_epi64(_mm256_xor_si256(d, negative), negative), negative};
+            }
+
+            static __m256i abs_equal(const Digits &d, int j) { return _mm256_cmpeq_epi64(d.abs, _mm256_set1_epi64x(j)); }
+            static __m256i negative(const Digits &d) { return d.negative; }
+        };
+    }
+
+    void scalarmult_lanes_avx2(GroupElement *r, const Scalar *k, const GroupElement *p, size_t n)
+    {
+        LanePoints<FieldAvx2>::scalarmult_blocks(r, k, p, n);
+    }
+
+    void pow22523_lanes_avx2(Fe *out, const Fe *z, size_t n)
+    {
+        LanePoints<FieldAvx2>::pow22523_blocks(out, z, n);
+    }
+}
+
+#pragma GCC pop_options
+
+#endif // PROTOSS_X86_LANES
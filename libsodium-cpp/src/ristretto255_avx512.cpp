@@ -0,0 +1,193 @@
+#include "ristretto255_lanes.hpp"
+
+#ifdef PROTOSS_X86_LANES
+
+#include <immintrin.h>
+
+// Everything below is compiled for AVX-512 IFMA and only called after the
+// dispatcher in ristretto255_lanes.cpp has checked for it
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx512vl,avx512ifma")
+
+#include "ristretto255_lanes_impl.hpp"
+
+namespace protoss::ristretto255
+{
+    namespace
+    {
+        // Eight field elements in radix 2^51, the same five limbs as Fe, one
+        // 64-bit lane per element. vpmadd52luq/huq multiply the low 52 bits of
+        // each lane, so every operation carries its limbs back below 2^52.
+        struct FieldAvx512
+        {
+            static constexpr size_t LANES = 8;
+            // A padded block costs less than two scalar multiplications
+            static constexpr size_t MIN_TAIL = 2;
+
+            struct Elem
+            {
+                __m512i v[5];
+            };
+
+            struct Digits
+            {
+                __m512i abs;
+                __mmask8 negative;
+            };
+
+            static __m512i mask51() { return _mm512_set1_epi64((int64_t(1) << 51) - 1); }
+
+            // Shifts through the zero-masking forms: GCC 12 warns that the plain
+            // intrinsics read an uninitialized pass-through operand
+            static __m512i shl(__m512i x, unsigned n) { return _mm512_maskz_slli_epi64(0xff, x, n); }
+            static __m512i shr(__m512i x, unsigned n) { return _mm512_maskz_srli_epi64(0xff, x, n); }
+
+            static __m512i times19(__m512i c)
+            {
+                return _mm512_add_epi64(c, _mm512_add_epi64(shl(c, 1), shl(c, 4)));
+            }
+
+            // All limbs at once: leaves each limb below 2^51 plus a small carry
+            static void carry(Elem &h)
+            {
+                __m512i c[5];
+#pragma GCC unroll 5
+                for (int i = 0; i < 5; i++)
+                {
+                    c[i] = shr(h.v[i], 51);
+                    h.v[i] = _mm512_and_si512(h.v[i], mask51());
+                }
+#pragma GCC unroll 4
+                for (int i = 1; i < 5; i++)
+                    h.v[i] = _mm512_add_epi64(h.v[i], c[i - 1]);
+                h.v[0] = _mm512_add_epi64(h.v[0], times19(c[4]));
+            }
+
+            static Elem constant(const Fe &c)
+            {
+                Elem e;
+                for (int i = 0; i < 5; i++)
+                    e.v[i] = _mm512_set1_epi64(int64_t(c.v[i]));
+                return e;
+            }
+
+            static void load(Elem &e, const Fe *const lanes[LANES])
+            {
+                for (int i = 0; i < 5; i++)
+                {
+                    uint64_t limb[LANES];
+                    for (size_t l = 0; l < LANES; l++)
+                        limb[l] = lanes[l]->v[i];
+                    e.v[i] = _mm512_loadu_si512(limb);
+                }
+                carry(e);
+            }
+
+            static void store(Fe *const lanes[LANES], const Elem &e)
+            {
+                for (int i = 0; i < 5; i++)
+                {
+                    uint64_t limb[LANES];
+                    _mm512_storeu_si512(limb, e.v[i]);
+                    for (size_t l = 0; l < LANES; l++)
+                        lanes[l]->v[i] = limb[l];
+                }
+            }
+
+            static void add(Elem &h, const Elem &f, const Elem &g)
+            {
+#pragma GCC unroll 5
+                for (int i = 0; i < 5; i++)
+                    h.v[i] = _mm512_add_epi64(f.v[i], g.v[i]);
+                carry(h);
+            }
+
+            // h = f + 2p - g
+            static void sub(Elem &h, const Elem &f, const Elem &g)
+            {
+#pragma GCC unroll 5
+                for (int i = 0; i < 5; i++)
+                {
+                    const int64_t two_p = i == 0 ? (int64_t(1) << 52) - 38 : (int64_t(1) << 52) - 2;
+                    h.v[i] = _mm512_sub_epi64(_mm512_add_epi64(f.v[i], _mm512_set1_epi64(two_p)), g.v[i]);
+                }
+                carry(h);
+            }
+
+            static void neg(Elem &h, const Elem &f)
+            {
+                Elem zero;
+                for (auto &limb : zero.v)
+                    limb = _mm512_setzero_si512();
+                sub(h, zero, f);
+            }
+
+            static void mul(Elem &h, const Elem &f, const Elem &g)
+            {
+                // lo[k] and hi[k] collect the low and high 52 bits of the products
+                // at position k; hi[k] belongs to bit 52 of position k, that is
+                // twice position k + 1 in radix 2^51
+                __m512i lo[9], hi[9];
+#pragma GCC unroll 9
+                for (int k = 0; k < 9; k++)
+                    lo[k] = hi[k] = _mm512_setzero_si512();
+#pragma GCC unroll 5
+                for (int i = 0; i < 5; i++)
+                {
+#pragma GCC unroll 5
+                    for (int j = 0; j < 5; j++)
+                    {
+                        lo[i + j] = _mm512_madd52lo_epu64(lo[i + j], f.v[i], g.v[j]);
+                        hi[i + j] = _mm512_madd52hi_epu64(hi[i + j], f.v[i], g.v[j]);
+                    }
+                }
+
+                __m512i z[10];
+                z[0] = lo[0];
+#pragma GCC unroll 8
+                for (int k = 1; k < 9; k++)
+                    z[k] = _mm512_add_epi64(lo[k], _mm512_add_epi64(hi[k - 1], hi[k - 1]));
+                z[9] = _mm512_add_epi64(hi[8], hi[8]);
+
+                // Positions 5..9 wrap past 2^255 with a factor 19
+#pragma GCC unroll 5
+                for (int k = 0; k < 5; k++)
+                    h.v[k] = _mm512_add_epi64(z[k], times19(z[k + 5]));
+                carry(h);
+            }
+
+            static void sq(Elem &h, const Elem &f) { mul(h, f, f); }
+
+            static void select(Elem &f, const Elem &g, __mmask8 mask)
+            {
+#pragma GCC unroll 5
+                for (int i = 0; i < 5; i++)
+                    f.v[i] = _mm512_mask_blend_epi64(mask, f.v[i], g.v[i]);
+            }
+
+            static Digits digits(const signed char (*e)[64], int i)
+            {
+                const __m512i d = _mm512_set_epi64(e[7][i], e[6][i], e[5][i], e[4][i], e[3][i], e[2][i], e[1][i], e[0][i]);
+                const __mmask8 negative = _mm512_cmplt_epi64_mask(d, _mm512_setzero_si512());
+                return Digits{_mm512_mask_sub_epi64(d, negative, _mm512_setzero_si512(), d), negative};
+            }
+
+            static __mmask8 abs_equal(const Digits &d, int j) { return _mm512_cmpeq_epi64_mask(d.abs, _mm512_set1_epi64(j)); }
+            static __mmask8 negative(const Digits &d) { return d.negative; }
+        };
+    }
+
+    void scalarmult_lanes_avx512ifma(GroupElement *r, const Scalar *k, const GroupElement *p, size_t n)
+    {
+        LanePoints<FieldAvx512>::scalarmult_blocks(r, k, p, n);
+    }
+
+    void pow22523_lanes_avx512ifma(Fe *out, const Fe *z, size_t n)
+    {
+        LanePoints<FieldAvx512>::pow22523_blocks(out, z, n);
+    }
+}
+
+#pragma GCC pop_options
+
+#endif // PROTOSS_X86_LANES
@@ -0,0 +1,135 @@
+#include "ristretto255_lanes.hpp"
+
+#include <atomic>
+
+namespace protoss::ristretto255
+{
+#ifdef PROTOSS_X86_LANES
+    // Defined in ristretto255_avx2.cpp and ristretto255_avx512.cpp
+    void scalarmult_lanes_avx2(GroupElement *r, const Scalar *k, const GroupElement *p, size_t n);
+    void scalarmult_lanes_avx512ifma(GroupElement *r, const Scalar *k, const GroupElement *p, size_t n);
+    void pow22523_lanes_avx2(Fe *out, const Fe *z, size_t n);
+    void pow22523_lanes_avx512ifma(Fe *out, const Fe *z, size_t n);
+#endif
+
+    namespace
+    {
+        Backend widest_supported()
+        {
+            if (backend_supported(Backend::Avx512Ifma))
+                return Backend::Avx512Ifma;
+            if (backend_supported(Backend::Avx2))
+                return Backend::Avx2;
+            return Backend::Scalar;
+        }
+
+        std::atomic<Backend> &active()
+        {
+            static std::atomic<Backend> backend{widest_supported()};
+            return backend;
+        }
+    }
+
+    const char *backend_name(Backend backend)
+    {
+        switch (backend)
+        {
+        case Backend::Avx2:
+            return "avx2";
+        case Backend::Avx512Ifma:
+            return "avx512ifma";
+        default:
+            return "scalar";
+        }
+    }
+
+    size_t backend_lanes(Backend backend)
+    {
+        switch (backend)
+        {
+        case Backend::Avx2:
+            return 4;
+        case Backend::Avx512Ifma:
+            return 8;
+        default:
+            return 1;
+        }
+    }
+
+    bool backend_supported(Backend backend)
+    {
+        switch (backend)
+        {
+#ifdef PROTOSS_X86_LANES
+        case Backend::Avx2:
+            return __builtin_cpu_supports("avx2");
+        case Backend::Avx512Ifma:
+            return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vl") &&
+                   __builtin_cpu_supports("avx512ifma");
+#endif
+        case Backend::Scalar:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    Backend active_backend()
+    {
+        return active().load(std::memory_order_relaxed);
+    }
+
+    bool set_active_backend(Backend backend)
+    {
+        if (!backend_supported(backend))
+            return false;
+        active().store(backend, std::memory_order_relaxed);
+        return true;
+    }
+
+    void scalarmult_lanes(Backend backend, GroupElement *r, const Scalar *k, const GroupElement *p, size_t n)
+    {
+        switch (backend)
+        {
+#ifdef PROTOSS_X86_LANES
+        case Backend::Avx2:
+            scalarmult_lanes_avx2(r, k, p, n);
+            return;
+        case Backend::Avx512Ifma:
+            scalarmult_lanes_avx512ifma(r, k, p, n);
+            return;
+#endif
+        default:
+            for (size_t i = 0; i < n; i++)
+                scalarmult(r[i], k[i], p[i]);
+        }
+    }
+
+    void scalarmult_lanes(GroupElement *r, const Scalar *k, const GroupElement *p, size_t n)
+    {
+        scalarmult_lanes(active_backend(), r, k, p, n);
+    }
+
+    void pow22523_lanes(Backend backend, Fe *out, const Fe *z, size_t n)
+    {
+        switch (backend)
+        {
+#ifdef PROTOSS_X86_LANES
+        case Backend::Avx2:
+            pow22523_lanes_avx2(out, z, n);
+            return;
+        case Backend::Avx512Ifma:
+            pow22523_lanes_avx512ifma(out, z, n);
+            return;
+#endif
+        default:
+            for (size_t i = 0; i < n; i++)
+                pow22523(out[i], z[i]);
+        }
+    }
+
+    void pow22523_lanes(Fe *out, const Fe *z, size_t n)
+    {
+        pow22523_lanes(active_backend(), out, z, n);
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef RISTRETTO255_LANES_HPP
+#define RISTRETTO255_LANES_HPP
+
+#include <cstddef>
+#include "ristretto255.hpp"
+
+// The SIMD backends need x86-64 and GCC/Clang target attributes
+#if defined(__x86_64__) && defined(__GNUC__)
+#define PROTOSS_X86_LANES 1
+#endif
+
+// Batched variable-base scalar multiplication that runs independent
+// multiplications side by side in SIMD lanes: 4 per AVX2 register (radix
+// 2^25.5, 32-bit multiplies) or 8 per AVX-512 register (radix 2^51 on the
+// 52-bit IFMA multiplier). The backend is picked at run time from the CPU
+// features; the one-at-a-time ristretto255::scalarmult is the fallback and
+// also takes tails too short to be worth a padded register.
+//
+// Every lane runs the same constant-time signed radix-16 ladder as
+// ristretto255::scalarmult, with table lookups done by per-lane masks, so the
+// results are identical and no secret reaches a branch or an address. The
+// same backends run the exponentiation of batched inverse square roots.
+namespace protoss::ristretto255
+{
+    enum class Backend
+    {
+        Scalar,    // ristretto255::scalarmult, one at a time
+        Avx2,      // 4 lanes
+        Avx512Ifma // 8 lanes
+    };
+
+    const char *backend_name(Backend backend);
+    size_t backend_lanes(Backend backend);
+
+    // True if this build includes the backend and the CPU and OS support it
+    bool backend_supported(Backend backend);
+
+    // The backend used by scalarmult_lanes without an explicit choice: the
+    // widest supported one, unless set_active_backend picked another
+    Backend active_backend();
+
+    // Overrides the automatic choice; returns false if backend is unsupported
+    bool set_active_backend(Backend backend);
+
+    // r[i] = k[i] * p[i] for i < n
+    void scalarmult_lanes(Backend backend, GroupElement *r, const Scalar *k, const GroupElement *p, size_t n);
+    void scalarmult_lanes(GroupElement *r, const Scalar *k, const GroupElement *p, size_t n);
+
+    // out[i] = z[i]^((p - 5) / 8) for i < n, the exponentiation inside each
+    // inverse square root of from_hash_batch and encode_batch; out may alias z
+    void pow22523_lanes(Backend backend, Fe *out, const Fe *z, size_t n);
+    void pow22523_lanes(Fe *out, const Fe *z, size_t n);
+}
+
+#endif // RISTRETTO255_LANES_HPP
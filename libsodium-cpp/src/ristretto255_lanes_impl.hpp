@@ -0,0 +1,306 @@
+#ifndef RISTRETTO255_LANES_IMPL_HPP
+#define RISTRETTO255_LANES_IMPL_HPP
+
+// Lane-generic curve formulas and scalar multiplication ladder shared by the
+// SIMD backends. Each backend translation unit includes this header after its
+// `#pragma GCC target`, with a field type F providing:
+//
+//   F::LANES, F::Elem            lane count and field element of LANES values
+//   F::MIN_TAIL                  smallest partial block worth padding
+//   F::Digits                    per-lane signed digits of one window
+//   constant(c)                  c broadcast to every lane
+//   add, sub, neg, mul, sq       lane-wise field arithmetic
+//   select(f, g, m)              f = g in the lanes selected by mask m
+//   digits(e, i)                 window i of every lane's radix-16 digits
+//   abs_equal(d, j), negative(d) lane masks |d| == j and d < 0
+//   load(e, fe), store(fe, e)    transposition from and to LANES Fe values
+//
+// Everything lives in an anonymous namespace so each backend gets its own
+// copy compiled for its own instruction set.
+
+#include "ristretto255_lanes.hpp"
+
+namespace protoss::ristretto255
+{
+    namespace
+    {
+        // 2d, as in ristretto255.cpp
+        constexpr Fe LANE_D2 = {{0x69b9426b2f159, 0x35050762add7a, 0x3cf44c0038052, 0x6738cc7407977, 0x2406d9dc56dff}};
+        constexpr Fe LANE_ZERO = {{0, 0, 0, 0, 0}};
+        constexpr Fe LANE_ONE = {{1, 0, 0, 0, 0}};
+
+        template <typename F>
+        struct LanePoints
+        {
+            using Elem = typename F::Elem;
+
+            struct P3
+            {
+                Elem X, Y, Z, T;
+            };
+
+            struct P1p1
+            {
+                Elem X, Y, Z, T;
+            };
+
+            struct P2
+            {
+                Elem X, Y, Z;
+            };
+
+            struct Cached
+            {
+                Elem YplusX, YminusX, Z, T2d;
+            };
+
+            static void to_cached(Cached &r, const P3 &p, const Elem &d2)
+            {
+                F::add(r.YplusX, p.Y, p.X);
+                F::sub(r.YminusX, p.Y, p.X);
+                r.Z = p.Z;
+                F::mul(r.T2d, p.T, d2);
+            }
+
+            static void p1p1_to_p2(P2 &r, const P1p1 &p)
+            {
+                F::mul(r.X, p.X, p.T);
+                F::mul(r.Y, p.Y, p.Z);
+                F::mul(r.Z, p.Z, p.T);
+            }
+
+            static void p1p1_to_p3(P3 &r, const P1p1 &p)
+            {
+                F::mul(r.X, p.X, p.T);
+                F::mul(r.Y, p.Y, p.Z);
+                F::mul(r.Z, p.Z, p.T);
+                F::mul(r.T, p.X, p.Y);
+            }
+
+            static void p2_dbl(P1p1 &r, const P2 &p)
+            {
+                Elem t0;
+                F::sq(r.X, p.X);
+                F::sq(r.Z, p.Y);
+                F::sq(r.T, p.Z);
+                F::add(r.T, r.T, r.T);
+                F::add(r.Y, p.X, p.Y);
+                F::sq(t0, r.Y);
+                F::add(r.Y, r.Z, r.X);
+                F::sub(r.Z, r.Z, r.X);
+                F::sub(r.X, t0, r.Y);
+                F::sub(r.T, r.T, r.Z);
+            }
+
+            static void p3_dbl(P1p1 &r, const P3 &p)
+            {
+                P2 q{p.X, p.Y, p.Z};
+                p2_dbl(r, q);
+            }
+
+            static void add_cached(P1p1 &r, const P3 &p, const Cached &q)
+            {
+                Elem t0;
+                F::add(r.X, p.Y, p.X);
+                F::sub(r.Y, p.Y, p.X);
+                F::mul(r.Z, r.X, q.YplusX);
+                F::mul(r.Y, r.Y, q.YminusX);
+                F::mul(r.T, q.T2d, p.T);
+                F::mul(r.X, p.Z, q.Z);
+                F::add(t0, r.X, r.X);
+                F::sub(r.X, r.Z, r.Y);
+                F::add(r.Y, r.Z, r.Y);
+                F::add(r.Z, t0, r.T);
+                F::sub(r.T, t0, r.T);
+            }
+
+            // t = d * pi[0] in every lane, d in [-8, 8], using masks only
+            static void select_cached(Cached &t, const Cached pi[8], const typename F::Digits &d,
+                                      const Elem &zero, const Elem &one)
+            {
+                t = Cached{one, one, one, zero};
+                for (int j = 0; j < 8; j++)
+                {
+                    auto match = F::abs_equal(d, j + 1);
+                    F::select(t.YplusX, pi[j].YplusX, match);
+                    F::select(t.YminusX, pi[j].YminusX, match);
+                    F::select(t.Z, pi[j].Z, match);
+                    F::select(t.T2d, pi[j].T2d, match);
+                }
+
+                auto negative = F::negative(d);
+                Elem swapped = t.YplusX, neg_T2d;
+                F::neg(neg_T2d, t.T2d);
+                F::select(t.YplusX, t.YminusX, negative);
+                F::select(t.YminusX, swapped, negative);
+                F::select(t.T2d, neg_T2d, negative);
+            }
+
+            // r[l] = k[l] * p[l] for the F::LANES lanes l
+            static void scalarmult(GroupElement *r, const Scalar *k, const GroupElement *p)
+            {
+                constexpr size_t L = F::LANES;
+                const Elem d2 = F::constant(LANE_D2);
+                const Elem zero = F::constant(LANE_ZERO);
+                const Elem one = F::constant(LANE_ONE);
+
+                signed char e[L][64];
+                for (size_t l = 0; l < L; l++)
+                    to_radix16(e[l], k[l]);
+
+                P3 base;
+                {
+                    const Fe *X[L], *Y[L], *Z[L], *T[L];
+                    for (size_t l = 0; l < L; l++)
+                        X[l] = &p[l].X, Y[l] = &p[l].Y, Z[l] = &p[l].Z, T[l] = &p[l].T;
+                    F::load(base.X, X);
+                    F::load(base.Y, Y);
+                    F::load(base.Z, Z);
+                    F::load(base.T, T);
+                }
+
+                // pi[j] = (j + 1) * p: even multiples by doubling, odd ones by adding p
+                P3 multiples[8];
+                Cached pi[8];
+                P1p1 sum;
+                multiples[0] = base;
+                to_cached(pi[0], base, d2);
+                for (int j = 1; j < 8; j++)
+                {
+                    if (j % 2 == 1)
+                        p3_dbl(sum, multiples[(j - 1) / 2]);
+                    else
+                        add_cached(sum, multiples[j - 1], pi[0]);
+                    p1p1_to_p3(multiples[j], sum);
+                    to_cached(pi[j], multiples[j], d2);
+                }
+
+                Cached t;
+                P2 s;
+                P3 h{zero, one, one, zero};
+                for (int i = 63; i >= 0; i--)
+                {
+                    select_cached(t, pi, F::digits(e, i), zero, one);
+                    add_cached(sum, h, t);
+                    if (i == 0)
+                        break;
+                    for (int d = 0; d < 4; d++)
+                    {
+                        p1p1_to_p2(s, sum);
+                        p2_dbl(sum, s);
+                    }
+                    p1p1_to_p3(h, sum);
+                }
+                p1p1_to_p3(h, sum);
+
+                Fe *X[L], *Y[L], *Z[L], *T[L];
+                for (size_t l = 0; l < L; l++)
+                    X[l] = &r[l].X, Y[l] = &r[l].Y, Z[l] = &r[l].Z, T[l] = &r[l].T;
+                F::store(X, h.X);
+                F::store(Y, h.Y);
+                F::store(Z, h.Z);
+                F::store(T, h.T);
+
+                sodium_memzero(e, sizeof e);
+                sodium_memzero(&t, sizeof t);
+            }
+
+            static void sqn(Elem &h, const Elem &f, int n)
+            {
+                F::sq(h, f);
+                for (int i = 1; i < n; i++)
+                    F::sq(h, h);
+            }
+
+            // out[l] = z[l]^((p - 5) / 8) for the F::LANES lanes l, the chain of
+            // ristretto255.cpp's fe_pow22523
+            static void pow22523(Fe *out, const Fe *z)
+            {
+                constexpr size_t L = F::LANES;
+                const Fe *in[L];
+                Fe *result[L];
+                for (size_t l = 0; l < L; l++)
+                    in[l] = &z[l], result[l] = &out[l];
+
+                Elem x, t0, t1, t2;
+                F::load(x, in);
+                F::sq(t0, x);        // 2
+                sqn(t1, t0, 2);      // 8
+                F::mul(t1, x, t1);   // 9
+                F::mul(t0, t0, t1);  // 11
+                F::sq(t0, t0);       // 22
+                F::mul(t0, t1, t0);  // 2^5 - 1
+                sqn(t1, t0, 5);      //
+                F::mul(t0, t1, t0);  // 2^10 - 1
+                sqn(t1, t0, 10);     //
+                F::mul(t1, t1, t0);  // 2^20 - 1
+                sqn(t2, t1, 20);     //
+                F::mul(t1, t2, t1);  // 2^40 - 1
+                sqn(t1, t1, 10);     //
+                F::mul(t0, t1, t0);  // 2^50 - 1
+                sqn(t1, t0, 50);     //
+                F::mul(t1, t1, t0);  // 2^100 - 1
+                sqn(t2, t1, 100);    //
+                F::mul(t1, t2, t1);  // 2^200 - 1
+                sqn(t1, t1, 50);     //
+                F::mul(t0, t1, t0);  // 2^250 - 1
+                sqn(t0, t0, 2);      // 2^252 - 4
+                F::mul(t0, t0, x);   // 2^252 - 3
+                F::store(result, t0);
+            }
+
+            static void pow22523_blocks(Fe *out, const Fe *z, size_t n)
+            {
+                constexpr size_t L = F::LANES;
+                size_t i = 0;
+                for (; i + L <= n; i += L)
+                    pow22523(out + i, z + i);
+                if (n - i < F::MIN_TAIL)
+                {
+                    for (; i < n; i++)
+                        ristretto255::pow22523(out[i], z[i]);
+                    return;
+                }
+
+                Fe pad_z[L], pad_out[L];
+                for (size_t l = 0; l < L; l++)
+                    pad_z[l] = i + l < n ? z[i + l] : LANE_ONE;
+                pow22523(pad_out, pad_z);
+                for (size_t l = 0; i + l < n; l++)
+                    out[i + l] = pad_out[l];
+            }
+
+            // Runs n multiplications in blocks of F::LANES. A partial last block of
+            // at least F::MIN_TAIL items is padded with the identity and a zero
+            // scalar; a shorter one runs one at a time, which is cheaper.
+            static void scalarmult_blocks(GroupElement *r, const Scalar *k, const GroupElement *p, size_t n)
+            {
+                constexpr size_t L = F::LANES;
+                size_t i = 0;
+                for (; i + L <= n; i += L)
+                    scalarmult(r + i, k + i, p + i);
+                if (n - i < F::MIN_TAIL)
+                {
+                    for (; i < n; i++)
+                        ristretto255::scalarmult(r[i], k[i], p[i]);
+                    return;
+                }
+
+                GroupElement pad_p[L], pad_r[L];
+                Scalar pad_k[L];
+                for (size_t l = 0; l < L; l++)
+                {
+                    pad_p[l] = i + l < n ? p[i + l] : IDENTITY;
+                    pad_k[l] = i + l < n ? k[i + l] : Scalar{};
+                }
+                scalarmult(pad_r, pad_k, pad_p);
+                for (size_t l = 0; i + l < n; l++)
+                    r[i + l] = pad_r[l];
+                sodium_memzero(pad_k, sizeof pad_k);
+                sodium_memzero(pad_r, sizeof pad_r);
+            }
+        };
+    }
+}
+
+#endif // RISTRETTO255_LANES_IMPL_HPP
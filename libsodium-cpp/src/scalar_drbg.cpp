@@ -0,0 +1,204 @@
+#include "scalar_drbg.hpp"
+#include <algorithm>
+#include <atomic>
+
+#ifdef _WIN32
+#include <process.h>
+#define protoss_getpid _getpid
+#else
+#include <pthread.h>
+#include <unistd.h>
+#define protoss_getpid getpid
+#endif
+
+#ifdef PROTOSS_DETERMINISTIC
+#pragma message("PROTOSS_DETERMINISTIC: random scalars can be fixed by a seed; not for production builds")
+#endif
+
+namespace protoss::drbg
+{
+    namespace
+    {
+        constexpr size_t KEY_LEN = crypto_stream_chacha20_ietf_KEYBYTES;
+        constexpr size_t SEED_LEN = crypto_core_ristretto255_NONREDUCEDSCALARBYTES;
+        constexpr size_t STREAM_BYTES = KEY_LEN + BUFFER_BYTES; // Next key, then output
+
+        // A seed never straddles two refills
+        static_assert(BUFFER_BYTES % SEED_LEN == 0);
+
+        std::atomic<Source> &active()
+        {
+            static std::atomic<Source> source{Source::Drbg};
+            return source;
+        }
+
+        // Forks seen by this process's fork children. A fork copies the
+        // forking thread's buffered output into the child, so a state whose
+        // count is stale must be reseeded before its next draw. Checked per
+        // call instead of getpid(), which is a system call.
+        std::atomic<unsigned long> g_forks{0};
+
+        void on_fork_child()
+        {
+            g_forks.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        struct DrbgState
+        {
+            unsigned char key[KEY_LEN];
+            unsigned char buffer[STREAM_BYTES];
+            size_t position;       // Next unread buffer byte; STREAM_BYTES when empty
+            size_t since_reseed;   // Output bytes since the key last took OS randomness
+            long pid;              // Process the key was last seeded in
+            unsigned long forks;   // g_forks when the key last took OS randomness
+            bool deterministic;    // Seeded by seed_thread; never takes OS randomness
+        };
+
+        void mix_os_randomness(DrbgState &state)
+        {
+            unsigned char fresh[KEY_LEN];
+            randombytes_buf(fresh, sizeof fresh);
+            for (size_t i = 0; i < KEY_LEN; i++)
+                state.key[i] ^= fresh[i];
+            sodium_memzero(fresh, sizeof fresh);
+            sodium_memzero(state.buffer, sizeof state.buffer);
+            state.position = STREAM_BYTES;
+            state.since_reseed = 0;
+            state.pid = (long)protoss_getpid();
+            state.forks = g_forks.load(std::memory_order_relaxed);
+            state.deterministic = false;
+        }
+
+        // Each refill uses a new key, so the nonce can stay zero
+        void refill(DrbgState &state)
+        {
+            if (!state.deterministic &&
+                (state.since_reseed >= RESEED_BYTES || state.pid != (long)protoss_getpid()))
+                mix_os_randomness(state);
+
+            static const unsigned char nonce[crypto_stream_chacha20_ietf_NONCEBYTES] = {};
+            crypto_stream_chacha20_ietf(state.buffer, STREAM_BYTES, nonce, state.key);
+            std::copy(state.buffer, state.buffer + KEY_LEN, state.key);
+            sodium_memzero(state.buffer, KEY_LEN);
+            state.position = KEY_LEN;
+            state.since_reseed += BUFFER_BYTES;
+        }
+
+        // Owns the calling thread's state; sodium_free wipes it at thread exit
+        struct ThreadDrbg
+        {
+            DrbgState *state = nullptr;
+
+            ThreadDrbg()
+            {
+#ifndef _WIN32
+                static const bool atfork_registered = pthread_atfork(nullptr, nullptr, on_fork_child) == 0;
+                (void)atfork_registered;
+#endif
+                state = static_cast<DrbgState *>(sodium_malloc(sizeof(DrbgState)));
+                if (!state)
+                    return;
+                sodium_memzero(state, sizeof(DrbgState));
+                mix_os_randomness(*state);
+            }
+            ~ThreadDrbg()
+            {
+                if (state)
+                    sodium_free(state);
+            }
+        };
+
+        DrbgState *thread_state()
+        {
+            thread_local ThreadDrbg drbg;
+            return drbg.state;
+        }
+
+        void draw(DrbgState &state, Scalar &out)
+        {
+            do
+            {
+                if (state.position == STREAM_BYTES)
+                    refill(state);
+                unsigned char *seed = state.buffer + state.position;
+                crypto_core_ristretto255_scalar_reduce(out.data(), seed);
+                sodium_memzero(seed, SEED_LEN);
+                state.position += SEED_LEN;
+            } while (sodium_is_zero(out.data(), out.size()));
+        }
+    }
+
+    const char *source_name(Source source)
+    {
+        return source == Source::Drbg ? "drbg" : "system";
+    }
+
+    Source active_source()
+    {
+        return active().load(std::memory_order_relaxed);
+    }
+
+    void set_active_source(Source source)
+    {
+        active().store(source, std::memory_order_relaxed);
+    }
+
+    void random_scalar(Scalar &out) noexcept
+    {
+        random_scalars(&out, 1);
+    }
+
+    void random_scalars(Scalar *out, size_t n) noexcept
+    {
+        DrbgState *state = active_source() == Source::Drbg ? thread_state() : nullptr;
+#ifdef PROTOSS_DETERMINISTIC
+        if (DrbgState *seeded = thread_state(); seeded && seeded->deterministic)
+            state = seeded;
+#endif
+        // Discard output buffered before a fork; a deterministic state replays
+        // by design. refill() also compares pids, for forks that bypass
+        // pthread_atfork.
+        if (state && !state->deterministic && state->forks != g_forks.load(std::memory_order_relaxed))
+            mix_os_randomness(*state);
+        for (size_t i = 0; i < n; i++)
+        {
+            if (state)
+                draw(*state, out[i]);
+            else
+                crypto_core_ristretto255_scalar_random(out[i].data());
+        }
+    }
+
+    void reseed() noexcept
+    {
+        if (DrbgState *state = thread_state())
+            mix_os_randomness(*state);
+    }
+
+#ifdef PROTOSS_DETERMINISTIC
+    void seed_thread(uint64_t seed, uint64_t stream) noexcept
+    {
+        DrbgState *state = thread_state();
+        if (!state)
+            return;
+
+        static const char domain[] = "protoss deterministic scalar drbg";
+        unsigned char input[16];
+        for (int i = 0; i < 8; i++)
+        {
+            input[i] = (unsigned char)(seed >> (8 * i));
+            input[8 + i] = (unsigned char)(stream >> (8 * i));
+        }
+        crypto_generichash_state hash;
+        crypto_generichash_init(&hash, nullptr, 0, KEY_LEN);
+        crypto_generichash_update(&hash, reinterpret_cast<const unsigned char *>(domain), sizeof domain - 1);
+        crypto_generichash_update(&hash, input, sizeof input);
+        crypto_generichash_final(&hash, state->key, KEY_LEN);
+
+        sodium_memzero(state->buffer, sizeof state->buffer);
+        state->position = STREAM_BYTES;
+        state->since_reseed = 0;
+        state->deterministic = true;
+    }
+#endif
+}
@@ -0,0 +1,61 @@
+#ifndef SCALAR_DRBG_HPP
+#define SCALAR_DRBG_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include "protoss_protocol.hpp"
+
+// Per-thread buffered ChaCha20 DRBG for the random scalars of the protocol
+// (x in Init, y in RspDer, ephemeral pairs, the y of a batch).
+//
+// Each thread owns a 32-byte key, seeded from the OS on first use. A refill
+// runs ChaCha20 under the key for 32 + BUFFER_BYTES bytes; the first 32 become
+// the next key and the old one is gone (fast key erasure), so a later
+// compromise of the thread's state does not reveal scalars already handed
+// out. Scalars are reduced from 64 buffer bytes each, which are wiped as they
+// are consumed. Every RESEED_BYTES of output, and before the first draw after a
+// fork (discarding the buffered output the child inherited), fresh OS
+// randomness is mixed into the key. The state sits in sodium_malloc memory.
+//
+// The result is one randombytes call per RESEED_BYTES instead of one per
+// scalar, and no state shared between threads.
+namespace protoss::drbg
+{
+    constexpr size_t BUFFER_BYTES = 4096;
+    constexpr size_t RESEED_BYTES = size_t(1) << 20;
+
+    enum class Source
+    {
+        Drbg,  // The per-thread DRBG
+        System // crypto_core_ristretto255_scalar_random, libsodium's global randombytes per scalar
+    };
+
+    const char *source_name(Source source);
+
+    // The source of random_scalar and random_scalars for all threads; Drbg
+    // unless set_active_source picked another
+    Source active_source();
+    void set_active_source(Source source);
+
+    // A uniform non-zero scalar. Falls back to the System source if the
+    // thread's DRBG state cannot be allocated.
+    void random_scalar(Scalar &out) noexcept;
+
+    // n of them, for the batched paths
+    void random_scalars(Scalar *out, size_t n) noexcept;
+
+    // Mixes fresh OS randomness into the calling thread's key now and drops
+    // its buffered output. Also ends deterministic mode on the thread.
+    void reseed() noexcept;
+
+#ifdef PROTOSS_DETERMINISTIC
+    // Benchmark and regression builds only (CMake option PROTOSS_DETERMINISTIC).
+    // Replaces the calling thread's key with one derived from (seed, stream)
+    // and stops all OS reseeding on the thread, so the scalars it draws from
+    // then on are a fixed function of the seed, whatever the active source.
+    // Threads that should not share a sequence take different streams.
+    void seed_thread(uint64_t seed, uint64_t stream = 0) noexcept;
+#endif
+}
+
+#endif // SCALAR_DRBG_HPP
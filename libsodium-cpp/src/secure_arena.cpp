@@ -0,0 +1,131 @@
+#include "secure_arena.hpp"
+#include <algorithm>
+
+namespace protoss
+{
+    namespace
+    {
+        // Set once the calling thread's cache is destroyed; later releases on
+        // that thread, from other thread_local destructors, go to the arena
+        thread_local bool cache_retired = false;
+    }
+
+    SecureArena &SecureArena::instance()
+    {
+        static SecureArena *arena = new SecureArena();
+        return *arena;
+    }
+
+    SecureArena::ThreadCache *SecureArena::thread_cache()
+    {
+        if (cache_retired)
+            return nullptr;
+        thread_local ThreadCache cache;
+        return &cache;
+    }
+
+    // A list holds at most 2 * BATCH slots plus the one being released, so
+    // the hot path never reallocates
+    SecureArena::ThreadCache::ThreadCache()
+    {
+        for (auto &list : lists)
+            list.reserve(2 * BATCH + 1);
+    }
+
+    SecureArena::ThreadCache::~ThreadCache()
+    {
+        cache_retired = true;
+        for (size_t cls = 0; cls < CLASSES; cls++)
+            instance().spill(lists[cls], cls, lists[cls].size());
+    }
+
+    void *SecureArena::acquire(size_t bytes)
+    {
+        const size_t cls = class_of(bytes);
+        ThreadCache *cache = thread_cache();
+        if (!cache)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (free_[cls].empty())
+                carve_locked(cls);
+            void *slot = free_[cls].back();
+            free_[cls].pop_back();
+            return slot;
+        }
+
+        std::vector<void *> &local = cache->lists[cls];
+        if (local.empty())
+            refill(local, cls);
+        void *slot = local.back();
+        local.pop_back();
+        return slot;
+    }
+
+    void SecureArena::release(void *slot, size_t bytes) noexcept
+    {
+        const size_t cls = class_of(bytes);
+        sodium_memzero(slot, slot_bytes(cls));
+        ThreadCache *cache = thread_cache();
+        if (!cache)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            try
+            {
+                free_[cls].push_back(slot);
+            }
+            catch (const std::bad_alloc &)
+            {
+            }
+            return;
+        }
+
+        std::vector<void *> &local = cache->lists[cls];
+        if (local.size() >= 2 * BATCH)
+            spill(local, cls, BATCH);
+        local.push_back(slot);
+    }
+
+    // Splits a new slab into slots of the class. Slab memory starts zeroed,
+    // and released slots are wiped, so every slot handed out is zero.
+    void SecureArena::carve_locked(size_t cls)
+    {
+        unsigned char *slab = static_cast<unsigned char *>(sodium_malloc(SLAB_BYTES));
+        if (!slab)
+            throw std::bad_alloc();
+        sodium_memzero(slab, SLAB_BYTES);
+        slabs_.push_back(slab);
+        for (size_t offset = SLAB_BYTES; offset > 0; offset -= slot_bytes(cls))
+            free_[cls].push_back(slab + offset - slot_bytes(cls));
+    }
+
+    void SecureArena::refill(std::vector<void *> &local, size_t cls)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<void *> &shared = free_[cls];
+        if (shared.empty())
+            carve_locked(cls);
+        const size_t count = std::min(BATCH, shared.size());
+        local.insert(local.end(), shared.end() - count, shared.end());
+        shared.resize(shared.size() - count);
+    }
+
+    void SecureArena::spill(std::vector<void *> &local, size_t cls, size_t count) noexcept
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        try
+        {
+            free_[cls].insert(free_[cls].end(), local.end() - count, local.end());
+        }
+        catch (const std::bad_alloc &)
+        {
+            // Slots that cannot be handed back stay wiped in their slab
+        }
+        local.resize(local.size() - count);
+    }
+
+    SecureArena::Stats SecureArena::stats() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return Stats{slabs_.size(), slabs_.size() * SLAB_BYTES};
+    }
+}
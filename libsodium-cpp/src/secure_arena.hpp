@@ -0,0 +1,160 @@
+#ifndef SECURE_ARENA_HPP
+#define SECURE_ARENA_HPP
+
+#include <sodium.h>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace protoss
+{
+    // Pooled secure memory for short-lived secrets (scalars, shared points,
+    // session keys, transcript digests). Slots of 32 or 64 bytes are carved
+    // from 64 KiB slabs allocated with sodium_malloc, so every slab is
+    // mlock'ed (where the limits allow it) and sits between guard pages.
+    // Slots are wiped on release. Each thread keeps its own free lists and
+    // only takes the arena lock to move a batch of slots in or out, so the
+    // hot path is a wipe and a vector push/pop.
+    //
+    // Slabs are never returned to the system: the arena is sized by the peak
+    // number of secrets alive at once. The instance is never destroyed, so
+    // threads exiting during static destruction can still hand back their
+    // slots.
+    class SecureArena
+    {
+    public:
+        static constexpr size_t SLAB_BYTES = 64 * 1024;
+        static constexpr size_t MAX_SLOT = 64;
+
+        struct Stats
+        {
+            size_t slabs = 0;
+            size_t locked_bytes = 0; // Slab bytes, mlock'ed unless RLIMIT_MEMLOCK prevented it
+        };
+
+        static SecureArena &instance();
+
+        // A slot of at least `bytes` <= MAX_SLOT bytes, zeroed; throws
+        // std::bad_alloc if no slab can be allocated
+        void *acquire(size_t bytes);
+
+        // Wipes the slot and returns it to the calling thread's free list
+        void release(void *slot, size_t bytes) noexcept;
+
+        Stats stats() const;
+
+        SecureArena(const SecureArena &) = delete;
+        SecureArena &operator=(const SecureArena &) = delete;
+
+    private:
+        static constexpr size_t CLASSES = 2; // 32 and 64 bytes
+        static constexpr size_t BATCH = 64;  // Slots moved between a thread and the arena at once
+
+        struct ThreadCache
+        {
+            std::vector<void *> lists[CLASSES];
+            ThreadCache();
+            ~ThreadCache();
+        };
+
+        SecureArena() = default;
+
+        static size_t class_of(size_t bytes) { return bytes <= 32 ? 0 : 1; }
+        static size_t slot_bytes(size_t cls) { return size_t(32) << cls; }
+        static ThreadCache *thread_cache();
+
+        void carve_locked(size_t cls);
+        void refill(std::vector<void *> &local, size_t cls);
+        void spill(std::vector<void *> &local, size_t cls, size_t count) noexcept;
+
+        mutable std::mutex mutex_;
+        std::vector<void *> free_[CLASSES];
+        std::vector<void *> slabs_;
+    };
+
+    // Owns one T in an arena slot: value-initialized on construction, wiped
+    // and returned on destruction. Move-only. For fixed-size secrets such as
+    // Scalar, Point and SessionKey.
+    template <typename T>
+    class Secure
+    {
+        static_assert(std::is_trivially_copyable_v<T> && sizeof(T) <= SecureArena::MAX_SLOT,
+                      "Secure<T> holds small trivially copyable values");
+
+    public:
+        Secure() : ptr_(new (SecureArena::instance().acquire(sizeof(T))) T{}) {}
+        explicit Secure(const T &value) : Secure() { *ptr_ = value; }
+        Secure(Secure &&other) noexcept : ptr_(std::exchange(other.ptr_, nullptr)) {}
+        Secure &operator=(Secure &&other) noexcept
+        {
+            if (this != &other)
+            {
+                reset();
+                ptr_ = std::exchange(other.ptr_, nullptr);
+            }
+            return *this;
+        }
+        Secure(const Secure &) = delete;
+        Secure &operator=(const Secure &) = delete;
+        ~Secure() { reset(); }
+
+        T &operator*() const { return *ptr_; }
+        T *operator->() const { return ptr_; }
+        T *get() const { return ptr_; }
+
+    private:
+        void reset() noexcept
+        {
+            if (ptr_)
+                SecureArena::instance().release(ptr_, sizeof(T));
+            ptr_ = nullptr;
+        }
+
+        T *ptr_;
+    };
+
+    // Standard allocator over secure memory, for containers of secrets:
+    // allocations of up to SecureArena::MAX_SLOT bytes come from the arena,
+    // larger ones from sodium_malloc. Memory is wiped on deallocation either
+    // way (sodium_free wipes before unmapping).
+    template <typename T>
+    struct SecureAllocator
+    {
+        using value_type = T;
+
+        SecureAllocator() noexcept = default;
+        template <typename U>
+        SecureAllocator(const SecureAllocator<U> &) noexcept {}
+
+        T *allocate(size_t n)
+        {
+            const size_t bytes = n * sizeof(T);
+            if (bytes <= SecureArena::MAX_SLOT && alignof(T) <= 32)
+                return static_cast<T *>(SecureArena::instance().acquire(bytes));
+            void *p = sodium_malloc(bytes);
+            if (!p)
+                throw std::bad_alloc();
+            return static_cast<T *>(p);
+        }
+
+        void deallocate(T *p, size_t n) noexcept
+        {
+            const size_t bytes = n * sizeof(T);
+            if (bytes <= SecureArena::MAX_SLOT && alignof(T) <= 32)
+                SecureArena::instance().release(p, bytes);
+            else
+                sodium_free(p);
+        }
+
+        template <typename U>
+        bool operator==(const SecureAllocator<U> &) const noexcept { return true; }
+    };
+
+    using SecureBytes = std::vector<unsigned char, SecureAllocator<unsigned char>>;
+}
+
+#endif // SECURE_ARENA_HPP
@@ -0,0 +1,345 @@
+#include "session_table.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace protoss
+{
+    namespace
+    {
+        // splitmix64 finalizer: session IDs need not be random for the table
+        // to spread them
+        uint64_t mix(uint64_t x)
+        {
+            x ^= x >> 30;
+            x *= 0xbf58476d1ce4e5b9ULL;
+            x ^= x >> 27;
+            x *= 0x94d049bb133111ebULL;
+            x ^= x >> 31;
+            return x;
+        }
+
+        // Fewer records per shard make the spread of IDs over shards
+        // relatively wider; small tables get fewer shards instead
+        constexpr size_t MIN_SHARD_RECORDS = 64;
+
+        size_t round_up_pow2(size_t n)
+        {
+            size_t p = 1;
+            while (p < n)
+                p <<= 1;
+            return p;
+        }
+    }
+
+    SessionTable::SessionTable(size_t capacity, Clock::duration timeout, Clock::duration tick, size_t shards)
+        : epoch_(Clock::now()), tick_(tick)
+    {
+        if (capacity == 0 || shards == 0)
+            throw std::invalid_argument("SessionTable capacity and shard count must be positive");
+        if (tick <= Clock::duration::zero())
+            throw std::invalid_argument("SessionTable tick must be positive");
+
+        // At least one tick, so a record never expires in the tick it was inserted
+        timeout_ticks_ = std::max<uint64_t>(1, (timeout + tick - Clock::duration(1)) / tick);
+
+        shards = round_up_pow2(shards);
+        while (shards > 1 && capacity / shards < MIN_SHARD_RECORDS)
+            shards >>= 1;
+        shard_mask_ = shards - 1;
+        capacity_ = capacity;
+
+        // A shard receives a binomial share of the records, mean per_shard.
+        // It accepts up to 7/8 load, and is sized so that covers the mean plus
+        // 8 standard deviations (capped at the whole capacity): at
+        // MIN_SHARD_RECORDS or more per shard, a shard overflows below
+        // capacity with probability under 2^-40. Large shards stay at 3/4 load
+        // at capacity, which the headroom needs less than.
+        const size_t per_shard = (capacity + shards - 1) / shards;
+        const size_t peak = std::min(capacity, per_shard + 8 * (size_t)std::ceil(std::sqrt((double)per_shard)) + 8);
+        shard_slots_ = std::max<size_t>({8, (per_shard * 4 + 2) / 3, (peak * 8 + 6) / 7});
+
+        shards_ = std::make_unique<Shard[]>(shards);
+        for (size_t i = 0; i < shards; i++)
+        {
+            shards_[i].slots = std::make_unique<Slot[]>(shard_slots_);
+            shards_[i].slot_count = shard_slots_;
+        }
+    }
+
+    SessionTable::~SessionTable()
+    {
+        clear();
+    }
+
+    SessionTable::Shard &SessionTable::shard_for(SessionId id, uint64_t &hash) const
+    {
+        hash = mix(id);
+        return shards_[(hash >> 32) & shard_mask_];
+    }
+
+    uint64_t SessionTable::tick_of(Clock::time_point now) const
+    {
+        if (now <= epoch_)
+            return 0;
+        return uint64_t((now - epoch_) / tick_);
+    }
+
+    bool SessionTable::insert(SessionId id, const Record &record, Clock::time_point now)
+    {
+        uint64_t hash;
+        Shard &shard = shard_for(id, hash);
+        const uint64_t deadline = tick_of(now) + timeout_ticks_;
+
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (id == 0 || find_locked(shard, id, hash) || (shard.size + 1) * 8 > shard.slot_count * 7)
+        {
+            shard.stats.rejected++;
+            return false;
+        }
+
+        size_t i = home_slot(shard, hash);
+        while (shard.slots[i].id != 0)
+            i = i + 1 == shard.slot_count ? 0 : i + 1;
+        shard.slots[i].id = id;
+        shard.slots[i].deadline = deadline;
+        shard.slots[i].record = record;
+        shard.size++;
+        schedule_locked(shard, WheelEntry{id, deadline});
+        shard.stats.inserts++;
+        return true;
+    }
+
+    bool SessionTable::lookup(Record &record, SessionId id, Clock::time_point now)
+    {
+        uint64_t hash;
+        Shard &shard = shard_for(id, hash);
+        const uint64_t tick = tick_of(now);
+
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        Slot *slot = find_locked(shard, id, hash);
+        if (slot && slot->deadline <= tick)
+        {
+            remove_locked(shard, slot);
+            shard.stats.expirations++;
+            slot = nullptr;
+        }
+        if (!slot)
+        {
+            shard.stats.misses++;
+            return false;
+        }
+        record = slot->record;
+        shard.stats.hits++;
+        return true;
+    }
+
+    bool SessionTable::take(Record &record, SessionId id, Clock::time_point now)
+    {
+        uint64_t hash;
+        Shard &shard = shard_for(id, hash);
+        const uint64_t tick = tick_of(now);
+
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        Slot *slot = find_locked(shard, id, hash);
+        if (slot && slot->deadline <= tick)
+        {
+            remove_locked(shard, slot);
+            shard.stats.expirations++;
+            slot = nullptr;
+        }
+        if (!slot)
+        {
+            shard.stats.misses++;
+            return false;
+        }
+        record = slot->record;
+        remove_locked(shard, slot);
+        shard.stats.hits++;
+        return true;
+    }
+
+    bool SessionTable::erase(SessionId id)
+    {
+        uint64_t hash;
+        Shard &shard = shard_for(id, hash);
+
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        Slot *slot = find_locked(shard, id, hash);
+        if (!slot)
+            return false;
+        remove_locked(shard, slot);
+        shard.stats.erases++;
+        return true;
+    }
+
+    size_t SessionTable::expire(Clock::time_point now)
+    {
+        const uint64_t tick = tick_of(now);
+        size_t expired = 0;
+        for (size_t i = 0; i <= shard_mask_; i++)
+        {
+            std::lock_guard<std::mutex> lock(shards_[i].mutex);
+            expired += advance_locked(shards_[i], tick);
+        }
+        return expired;
+    }
+
+    void SessionTable::clear()
+    {
+        for (size_t i = 0; i <= shard_mask_; i++)
+        {
+            Shard &shard = shards_[i];
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            sodium_memzero(shard.slots.get(), shard_slots_ * sizeof(Slot));
+            shard.size = 0;
+            for (auto &level : shard.wheel)
+                for (auto &bucket : level)
+                    bucket.clear();
+        }
+    }
+
+    size_t SessionTable::size() const
+    {
+        size_t total = 0;
+        for (size_t i = 0; i <= shard_mask_; i++)
+        {
+            std::lock_guard<std::mutex> lock(shards_[i].mutex);
+            total += shards_[i].size;
+        }
+        return total;
+    }
+
+    size_t SessionTable::capacity() const
+    {
+        return capacity_;
+    }
+
+    size_t SessionTable::table_bytes() const
+    {
+        return (shard_mask_ + 1) * shard_slots_ * sizeof(Slot);
+    }
+
+    SessionTable::Stats SessionTable::stats() const
+    {
+        Stats total;
+        for (size_t i = 0; i <= shard_mask_; i++)
+        {
+            std::lock_guard<std::mutex> lock(shards_[i].mutex);
+            const Stats &s = shards_[i].stats;
+            total.inserts += s.inserts;
+            total.rejected += s.rejected;
+            total.hits += s.hits;
+            total.misses += s.misses;
+            total.erases += s.erases;
+            total.expirations += s.expirations;
+        }
+        return total;
+    }
+
+    // The high half of the hash picks the shard, the low half the slot, scaled
+    // by multiplication since shard sizes are not powers of two
+    size_t SessionTable::home_slot(const Shard &shard, uint64_t hash)
+    {
+        return size_t((uint64_t(uint32_t(hash)) * shard.slot_count) >> 32);
+    }
+
+    SessionTable::Slot *SessionTable::find_locked(Shard &shard, SessionId id, uint64_t hash)
+    {
+        for (size_t i = home_slot(shard, hash);; i = i + 1 == shard.slot_count ? 0 : i + 1)
+        {
+            if (shard.slots[i].id == id)
+                return &shard.slots[i];
+            if (shard.slots[i].id == 0)
+                return nullptr;
+        }
+    }
+
+    // Backward-shift deletion: later entries of the probe run move up into the
+    // hole unless that would put them before their home slot, so lookups never
+    // need tombstones. The slot left empty at the end is wiped.
+    void SessionTable::remove_locked(Shard &shard, Slot *slot)
+    {
+        const size_t n = shard.slot_count;
+        auto distance = [n](size_t from, size_t to) { return to >= from ? to - from : to + n - from; };
+        size_t hole = size_t(slot - shard.slots.get());
+        for (size_t j = hole + 1 == n ? 0 : hole + 1; shard.slots[j].id != 0; j = j + 1 == n ? 0 : j + 1)
+        {
+            if (distance(home_slot(shard, mix(shard.slots[j].id)), j) >= distance(hole, j))
+            {
+                shard.slots[hole] = shard.slots[j];
+                hole = j;
+            }
+        }
+        sodium_memzero(&shard.slots[hole], sizeof(Slot));
+        shard.size--;
+    }
+
+    // Level l holds the entries due within 256^(l+1) ticks, in the bucket of
+    // their deadline's l-th base-256 digit
+    void SessionTable::schedule_locked(Shard &shard, const WheelEntry &entry)
+    {
+        const uint64_t deadline = std::max(entry.deadline, shard.now_tick);
+        const uint64_t delta = deadline - shard.now_tick;
+        int level = 0;
+        while (level < WHEEL_LEVELS - 1 && delta >= uint64_t(1) << (WHEEL_BITS * (level + 1)))
+            level++;
+        const size_t bucket = (deadline >> (WHEEL_BITS * level)) & (WHEEL_SIZE - 1);
+        shard.wheel[level][bucket].push_back(entry);
+    }
+
+    // Expires the records an entry of the bucket is due for. Entries of
+    // records erased or taken since, or re-inserted with a new deadline, no
+    // longer match and are dropped.
+    size_t SessionTable::fire_locked(Shard &shard, std::vector<WheelEntry> &bucket)
+    {
+        size_t expired = 0;
+        for (const WheelEntry &entry : bucket)
+        {
+            Slot *slot = find_locked(shard, entry.id, mix(entry.id));
+            if (slot && slot->deadline == entry.deadline)
+            {
+                remove_locked(shard, slot);
+                shard.stats.expirations++;
+                expired++;
+            }
+        }
+        bucket.clear();
+        return expired;
+    }
+
+    size_t SessionTable::advance_locked(Shard &shard, uint64_t target_tick)
+    {
+        // An empty shard only holds stale entries; skip straight to the target
+        if (shard.size == 0 && shard.now_tick < target_tick)
+        {
+            for (auto &level : shard.wheel)
+                for (auto &bucket : level)
+                    bucket.clear();
+            shard.now_tick = target_tick;
+            return 0;
+        }
+
+        size_t expired = 0;
+        std::vector<WheelEntry> cascading;
+        while (shard.now_tick < target_tick)
+        {
+            shard.now_tick++;
+
+            // When a level's lower digits wrap, its current bucket moves down,
+            // highest level first
+            for (int level = WHEEL_LEVELS - 1; level >= 1; level--)
+            {
+                if ((shard.now_tick & ((uint64_t(1) << (WHEEL_BITS * level)) - 1)) != 0)
+                    continue;
+                const size_t bucket = (shard.now_tick >> (WHEEL_BITS * level)) & (WHEEL_SIZE - 1);
+                cascading.swap(shard.wheel[level][bucket]);
+                for (const WheelEntry &entry : cascading)
+                    schedule_locked(shard, entry);
+                cascading.clear();
+            }
+            expired += fire_locked(shard, shard.wheel[0][shard.now_tick & (WHEEL_SIZE - 1)]);
+        }
+        return expired;
+    }
+}
@@ -0,0 +1,146 @@
+#ifndef SESSION_TABLE_HPP
+#define SESSION_TABLE_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "protoss_protocol.hpp"
+
+namespace protoss
+{
+    using SessionId = uint64_t;
+
+    // Thread-safe table of pending handshakes between Init and Der, keyed by
+    // session ID, for endpoints with millions of handshakes in flight.
+    //
+    // Records are fixed-size: x, I, V and two 32-bit handles the caller maps to
+    // its own identity storage, so a record owns no heap memory. The table is
+    // split into shards, each an open-addressing array with linear probing and
+    // backward-shift deletion behind its own mutex. Capacity is fixed at
+    // construction, so the table never reallocates; insert() fails once a
+    // shard is full, which below capacity() only happens with negligible
+    // probability.
+    //
+    // Abandoned handshakes expire `timeout` after insertion. Each shard keeps
+    // a hierarchical timing wheel (4 levels of 256 buckets of `tick`
+    // granularity), advanced by expire(). lookup() and take() never return an
+    // expired record, even before expire() has reaped it. Removed and expired
+    // records are wiped.
+    class SessionTable
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        struct Record
+        {
+            Scalar x;
+            Point I;
+            Point V;
+            uint32_t P_i; // Identity handles, resolved by the caller
+            uint32_t P_j;
+        };
+
+        struct Stats
+        {
+            uint64_t inserts = 0;
+            uint64_t rejected = 0; // insert() calls that found the ID present or the shard full
+            uint64_t hits = 0;
+            uint64_t misses = 0;
+            uint64_t erases = 0;
+            uint64_t expirations = 0;
+        };
+
+        // capacity is spread over the shards (rounded up to a power of two,
+        // and reduced so each shard expects at least 64 records). A shard
+        // accepts up to 7/8 load and is sized with headroom for the uneven
+        // spread of IDs over shards: up to capacity records, insert() fails
+        // for a full shard with probability below 2^-40.
+        SessionTable(size_t capacity, Clock::duration timeout,
+                     Clock::duration tick = std::chrono::milliseconds(100), size_t shards = 64);
+        ~SessionTable();
+        SessionTable(const SessionTable &) = delete;
+        SessionTable &operator=(const SessionTable &) = delete;
+
+        // Returns false if id is 0, already present, or its shard is full
+        bool insert(SessionId id, const Record &record, Clock::time_point now = Clock::now());
+
+        // Copies the record out; returns false if absent or expired
+        bool lookup(Record &record, SessionId id, Clock::time_point now = Clock::now());
+
+        // Moves the record out and removes it, as Der does with its state
+        bool take(Record &record, SessionId id, Clock::time_point now = Clock::now());
+
+        bool erase(SessionId id);
+
+        // Advances every shard's timing wheel to now; returns the number of
+        // records expired
+        size_t expire(Clock::time_point now = Clock::now());
+
+        void clear();
+
+        size_t size() const;
+        size_t capacity() const; // As constructed; see the constructor
+        Stats stats() const;
+
+        // Bytes of one slot, and of the slot arrays of all shards. The timing
+        // wheels add 16 bytes per scheduled expiry on top.
+        static constexpr size_t slot_bytes();
+        size_t table_bytes() const;
+
+    private:
+        struct alignas(64) Slot
+        {
+            SessionId id;      // 0 marks an empty slot
+            uint64_t deadline; // In ticks since construction
+            Record record;
+        };
+
+        struct WheelEntry
+        {
+            SessionId id;
+            uint64_t deadline;
+        };
+
+        static constexpr int WHEEL_LEVELS = 4;
+        static constexpr int WHEEL_BITS = 8;
+        static constexpr size_t WHEEL_SIZE = size_t(1) << WHEEL_BITS;
+
+        struct alignas(64) Shard
+        {
+            mutable std::mutex mutex;
+            std::unique_ptr<Slot[]> slots;
+            size_t slot_count = 0;
+            size_t size = 0;
+            uint64_t now_tick = 0; // Last tick the wheel has processed
+            std::vector<WheelEntry> wheel[WHEEL_LEVELS][WHEEL_SIZE];
+            Stats stats;
+        };
+
+        Shard &shard_for(SessionId id, uint64_t &hash) const;
+        uint64_t tick_of(Clock::time_point now) const;
+
+        static size_t home_slot(const Shard &shard, uint64_t hash);
+        static Slot *find_locked(Shard &shard, SessionId id, uint64_t hash);
+        static void remove_locked(Shard &shard, Slot *slot);
+        static void schedule_locked(Shard &shard, const WheelEntry &entry);
+        static size_t fire_locked(Shard &shard, std::vector<WheelEntry> &bucket);
+        static size_t advance_locked(Shard &shard, uint64_t target_tick);
+
+        Clock::time_point epoch_;
+        Clock::duration tick_;
+        uint64_t timeout_ticks_;
+        size_t capacity_;
+        size_t shard_mask_;
+        size_t shard_slots_;
+        std::unique_ptr<Shard[]> shards_;
+    };
+
+    constexpr size_t SessionTable::slot_bytes()
+    {
+        return sizeof(Slot);
+    }
+}
+
+#endif // SESSION_TABLE_HPP
@@ -0,0 +1,56 @@
+#include "sha512_lanes.hpp"
+
+#ifdef PROTOSS_X86_LANES
+
+#include <immintrin.h>
+
+// Everything below is compiled for AVX2 and only called after the dispatcher
+// in sha512_lanes.cpp has checked for it
+#pragma GCC push_options
+#pragma GCC target("avx2")
+
+#include "sha512_lanes_impl.hpp"
+
+namespace protoss::sha512
+{
+    namespace
+    {
+        // Four SHA-512 states, one 64-bit lane each. AVX2 has no 64-bit
+        // rotation, so rotr is two shifts and an or.
+        struct WordAvx2
+        {
+            static constexpr size_t LANES = 4;
+            // A padded register costs less than two one-at-a-time hashes
+            static constexpr size_t MIN_TAIL = 2;
+
+            using Word = __m256i;
+
+            static Word set1(uint64_t x) { return _mm256_set1_epi64x(int64_t(x)); }
+            static Word load(const uint64_t *p) { return _mm256_load_si256((const __m256i *)p); }
+            static void store(uint64_t *p, Word w) { _mm256_store_si256((__m256i *)p, w); }
+            static Word add(Word a, Word b) { return _mm256_add_epi64(a, b); }
+
+            template <int n>
+            static Word rotr(Word x) { return _mm256_or_si256(_mm256_srli_epi64(x, n), _mm256_slli_epi64(x, 64 - n)); }
+
+            template <int n>
+            static Word shr(Word x) { return _mm256_srli_epi64(x, n); }
+
+            static Word xor3(Word a, Word b, Word c) { return _mm256_xor_si256(_mm256_xor_si256(a, b), c); }
+            static Word ch(Word e, Word f, Word g) { return _mm256_xor_si256(g, _mm256_and_si256(e, _mm256_xor_si256(f, g))); }
+            static Word maj(Word a, Word b, Word c)
+            {
+                return _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b)));
+            }
+        };
+    }
+
+    void hash_lanes_avx2(unsigned char *out, const Fields *messages, size_t n)
+    {
+        LaneHasher<WordAvx2>::hash_blocks(out, messages, n);
+    }
+}
+
+#pragma GCC pop_options
+
+#endif // PROTOSS_X86_LANES
@@ -0,0 +1,56 @@
+#include "sha512_lanes.hpp"
+
+#ifdef PROTOSS_X86_LANES
+
+#include <immintrin.h>
+
+// Everything below is compiled for AVX-512F and only called after the
+// dispatcher in sha512_lanes.cpp has checked for it
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+
+#include "sha512_lanes_impl.hpp"
+
+namespace protoss::sha512
+{
+    namespace
+    {
+        // Eight SHA-512 states, one 64-bit lane each. vprorq rotates in one
+        // instruction and vpternlogq folds each three-input boolean function
+        // into one.
+        struct WordAvx512
+        {
+            static constexpr size_t LANES = 8;
+            // A padded register costs less than two one-at-a-time hashes
+            static constexpr size_t MIN_TAIL = 2;
+
+            using Word = __m512i;
+
+            static Word set1(uint64_t x) { return _mm512_set1_epi64(int64_t(x)); }
+            static Word load(const uint64_t *p) { return _mm512_load_si512(p); }
+            static void store(uint64_t *p, Word w) { _mm512_store_si512(p, w); }
+            static Word add(Word a, Word b) { return _mm512_add_epi64(a, b); }
+
+            // The zero-masking forms, as in ristretto255_avx512.cpp: GCC 12 warns
+            // that the plain intrinsics read an uninitialized pass-through operand
+            template <int n>
+            static Word rotr(Word x) { return _mm512_maskz_ror_epi64(0xff, x, n); }
+
+            template <int n>
+            static Word shr(Word x) { return _mm512_maskz_srli_epi64(0xff, x, n); }
+
+            static Word xor3(Word a, Word b, Word c) { return _mm512_ternarylogic_epi64(a, b, c, 0x96); }
+            static Word ch(Word e, Word f, Word g) { return _mm512_ternarylogic_epi64(e, f, g, 0xca); }
+            static Word maj(Word a, Word b, Word c) { return _mm512_ternarylogic_epi64(a, b, c, 0xe8); }
+        };
+    }
+
+    void hash_lanes_avx512(unsigned char *out, const Fields *messages, size_t n)
+    {
+        LaneHasher<WordAvx512>::hash_blocks(out, messages, n);
+    }
+}
+
+#pragma GCC pop_options
+
+#endif // PROTOSS_X86_LANES
@@ -0,0 +1,33 @@
+#include "sha512_lanes_impl.hpp"
+
+namespace protoss::sha512
+{
+#ifdef PROTOSS_X86_LANES
+    // Defined in sha512_avx2.cpp and sha512_avx512.cpp
+    void hash_lanes_avx2(unsigned char *out, const Fields *messages, size_t n);
+    void hash_lanes_avx512(unsigned char *out, const Fields *messages, size_t n);
+#endif
+
+    void hash_lanes(Backend backend, unsigned char *out, const Fields *messages, size_t n)
+    {
+        switch (backend)
+        {
+#ifdef PROTOSS_X86_LANES
+        case Backend::Avx2:
+            hash_lanes_avx2(out, messages, n);
+            return;
+        case Backend::Avx512Ifma:
+            hash_lanes_avx512(out, messages, n);
+            return;
+#endif
+        default:
+            for (size_t i = 0; i < n; i++)
+                hash_one(out + i * BYTES, messages[i]);
+        }
+    }
+
+    void hash_lanes(unsigned char *out, const Fields *messages, size_t n)
+    {
+        hash_lanes(ristretto255::active_backend(), out, messages, n);
+    }
+}
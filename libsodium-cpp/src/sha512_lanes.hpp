@@ -0,0 +1,36 @@
+#ifndef SHA512_LANES_HPP
+#define SHA512_LANES_HPP
+
+#include <sodium.h>
+#include <cstddef>
+#include <span>
+#include "ristretto255_lanes.hpp"
+
+// Multi-buffer SHA-512: independent messages hashed side by side, one per
+// 64-bit SIMD lane, 4 per AVX2 register or 8 per AVX-512 register. Meant for
+// the many short messages of a batch, such as the password prehashes of
+// hash_to_point_batch and the transcript hashes of RspDerBatch and DerBatch.
+// The digests are identical to crypto_hash_sha512, which is also the
+// fallback and takes tails too short to be worth a padded register.
+//
+// The backend is the one of ristretto255_lanes.hpp, so set_active_backend
+// moves the curve arithmetic and the hashing together; the Avx512Ifma
+// backend only needs AVX-512F for hashing.
+namespace protoss::sha512
+{
+    using ristretto255::Backend;
+
+    constexpr size_t BYTES = crypto_hash_sha512_BYTES;
+
+    // One message, hashed as the concatenation of its fields without building
+    // a concatenated copy
+    using Fields = std::span<const std::span<const unsigned char>>;
+
+    // Writes the BYTES-byte digest of messages[i] to out + i * BYTES for i < n.
+    // Messages of different lengths are fine; a lane that finishes early idles
+    // until the longest message of its register is done.
+    void hash_lanes(Backend backend, unsigned char *out, const Fields *messages, size_t n);
+    void hash_lanes(unsigned char *out, const Fields *messages, size_t n);
+}
+
+#endif // SHA512_LANES_HPP
@@ -0,0 +1,236 @@
+#ifndef SHA512_LANES_IMPL_HPP
+#define SHA512_LANES_IMPL_HPP
+
+// Lane-generic SHA-512 compression and message scheduling shared by the SIMD
+// backends. Each backend translation unit includes this header after its
+// `#pragma GCC target`, with a word type W providing:
+//
+//   W::LANES, W::Word            lane count and register of LANES 64-bit words
+//   W::MIN_TAIL                  smallest partial register worth padding
+//   set1(x)                      x broadcast to every lane
+//   load(p), store(p, w)         LANES consecutive uint64_t from and to memory
+//   add(a, b)                    lane-wise addition mod 2^64
+//   rotr<n>(x), shr<n>(x)        lane-wise rotation and shift right
+//   xor3(a, b, c)                a ^ b ^ c
+//   ch(e, f, g), maj(a, b, c)    the SHA-2 choice and majority functions
+//
+// Everything lives in an anonymous namespace so each backend gets its own
+// copy compiled for its own instruction set.
+
+#include "sha512_lanes.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace protoss::sha512
+{
+    namespace
+    {
+        constexpr uint64_t LANE_IV[8] = {
+            0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL, 0x3c6ef372fe94f82bULL, 0xa54ff53a5f1d36f1ULL,
+            0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL, 0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL};
+
+        constexpr uint64_t LANE_K[80] = {
+            0x428a2f98d728ae22ULL, 0x7137449123ef65cdULL, 0xb5c0fbcfec4d3b2fULL, 0xe9b5dba58189dbbcULL,
+            0x3956c25bf348b538ULL, 0x59f111f1b605d019ULL, 0x923f82a4af194f9bULL, 0xab1c5ed5da6d8118ULL,
+            0xd807aa98a3030242ULL, 0x12835b0145706fbeULL, 0x243185be4ee4b28cULL, 0x550c7dc3d5ffb4e2ULL,
+            0x72be5d74f27b896fULL, 0x80deb1fe3b1696b1ULL, 0x9bdc06a725c71235ULL, 0xc19bf174cf692694ULL,
+            0xe49b69c19ef14ad2ULL, 0xefbe4786384f25e3ULL, 0x0fc19dc68b8cd5b5ULL, 0x240ca1cc77ac9c65ULL,
+            0x2de92c6f592b0275ULL, 0x4a7484aa6ea6e483ULL, 0x5cb0a9dcbd41fbd4ULL, 0x76f988da831153b5ULL,
+            0x983e5152ee66dfabULL, 0xa831c66d2db43210ULL, 0xb00327c898fb213fULL, 0xbf597fc7beef0ee4ULL,
+            0xc6e00bf33da88fc2ULL, 0xd5a79147930aa725ULL, 0x06ca6351e003826fULL, 0x142929670a0e6e70ULL,
+            0x27b70a8546d22ffcULL, 0x2e1b21385c26c926ULL, 0x4d2c6dfc5ac42aedULL, 0x53380d139d95b3dfULL,
+            0x650a73548baf63deULL, 0x766a0abb3c77b2a8ULL, 0x81c2c92e47edaee6ULL, 0x92722c851482353bULL,
+            0xa2bfe8a14cf10364ULL, 0xa81a664bbc423001ULL, 0xc24b8b70d0f89791ULL, 0xc76c51a30654be30ULL,
+            0xd192e819d6ef5218ULL, 0xd69906245565a910ULL, 0xf40e35855771202aULL, 0x106aa07032bbd1b8ULL,
+            0x19a4c116b8d2d0c8ULL, 0x1e376c085141ab53ULL, 0x2748774cdf8eeb99ULL, 0x34b0bcb5e19b48a8ULL,
+            0x391c0cb3c5c95a63ULL, 0x4ed8aa4ae3418acbULL, 0x5b9cca4f7763e373ULL, 0x682e6ff3d6b2b8a3ULL,
+            0x748f82ee5defb2fcULL, 0x78a5636f43172f60ULL, 0x84c87814a1f0ab72ULL, 0x8cc702081a6439ecULL,
+            0x90befffa23631e28ULL, 0xa4506cebde82bde9ULL, 0xbef9a3f7b2c67915ULL, 0xc67178f2e372532bULL,
+            0xca273eceea26619cULL, 0xd186b8c721c0c207ULL, 0xeada7dd6cde0eb1eULL, 0xf57d4f7fee6ed178ULL,
+            0x06f067aa72176fbaULL, 0x0a637dc5a2c898a6ULL, 0x113f9804bef90daeULL, 0x1b710b35131c471bULL,
+            0x28db77f523047d84ULL, 0x32caab7b40c72493ULL, 0x3c9ebe0a15c9bebcULL, 0x431d67c49c100d4cULL,
+            0x4cc5d4becb3e42b6ULL, 0x597f299cfc657e2aULL, 0x5fcb6fab3ad6faecULL, 0x6c44198c4a475817ULL};
+
+        constexpr size_t BLOCK_LEN = 128;
+
+        inline uint64_t load_be64(const unsigned char *p)
+        {
+            uint64_t x;
+            std::memcpy(&x, p, 8);
+            return __builtin_bswap64(x);
+        }
+
+        inline void store_be64(unsigned char *p, uint64_t x)
+        {
+            x = __builtin_bswap64(x);
+            std::memcpy(p, &x, 8);
+        }
+
+        inline size_t message_len(const Fields &message)
+        {
+            size_t len = 0;
+            for (auto field : message)
+                len += field.size();
+            return len;
+        }
+
+        // Number of blocks after padding: the message, 0x80 and a 16-byte length
+        inline size_t padded_blocks(size_t len)
+        {
+            return (len + 1 + 16 + BLOCK_LEN - 1) / BLOCK_LEN;
+        }
+
+        // Writes block `index` of the padded message to block
+        inline void pad_block(unsigned char block[BLOCK_LEN], const Fields &message, size_t len, size_t index)
+        {
+            const size_t begin = index * BLOCK_LEN;
+            std::fill(block, block + BLOCK_LEN, 0);
+
+            size_t offset = 0;
+            for (auto field : message)
+            {
+                const size_t from = std::max(begin, offset), to = std::min(begin + BLOCK_LEN, offset + field.size());
+                if (from < to)
+                    std::copy(field.data() + (from - offset), field.data() + (to - offset), block + (from - begin));
+                offset += field.size();
+            }
+            if (len >= begin && len < begin + BLOCK_LEN)
+                block[len - begin] = 0x80;
+            if (index + 1 == padded_blocks(len))
+            {
+                store_be64(block + BLOCK_LEN - 16, uint64_t(len) >> 61);
+                store_be64(block + BLOCK_LEN - 8, uint64_t(len) << 3);
+            }
+        }
+
+        // The one-message fallback
+        inline void hash_one(unsigned char *out, const Fields &message)
+        {
+            crypto_hash_sha512_state state;
+            crypto_hash_sha512_init(&state);
+            for (auto field : message)
+                crypto_hash_sha512_update(&state, field.data(), field.size());
+            crypto_hash_sha512_final(&state, out);
+            sodium_memzero(&state, sizeof state);
+        }
+
+        template <typename W>
+        struct LaneHasher
+        {
+            using Word = typename W::Word;
+            static constexpr size_t L = W::LANES;
+
+            static Word sigma0(Word x) { return W::xor3(W::template rotr<1>(x), W::template rotr<8>(x), W::template shr<7>(x)); }
+            static Word sigma1(Word x) { return W::xor3(W::template rotr<19>(x), W::template rotr<61>(x), W::template shr<6>(x)); }
+            static Word Sigma0(Word x) { return W::xor3(W::template rotr<28>(x), W::template rotr<34>(x), W::template rotr<39>(x)); }
+            static Word Sigma1(Word x) { return W::xor3(W::template rotr<14>(x), W::template rotr<18>(x), W::template rotr<41>(x)); }
+
+            // One block for every lane; w holds word t of lane l at w[t * L + l]
+            static void compress(Word h[8], const uint64_t *w)
+            {
+                Word m[16];
+                for (int t = 0; t < 16; t++)
+                    m[t] = W::load(w + t * L);
+
+                Word s[8];
+                for (int i = 0; i < 8; i++)
+                    s[i] = h[i];
+
+#pragma GCC unroll 16
+                for (int t = 0; t < 80; t++)
+                {
+                    if (t >= 16)
+                        m[t & 15] = W::add(W::add(m[t & 15], sigma1(m[(t - 2) & 15])),
+                                           W::add(m[(t - 7) & 15], sigma0(m[(t - 15) & 15])));
+                    const Word t1 = W::add(W::add(W::add(s[7], Sigma1(s[4])), W::ch(s[4], s[5], s[6])),
+                                           W::add(W::set1(LANE_K[t]), m[t & 15]));
+                    const Word t2 = W::add(Sigma0(s[0]), W::maj(s[0], s[1], s[2]));
+                    s[7] = s[6];
+                    s[6] = s[5];
+                    s[5] = s[4];
+                    s[4] = W::add(s[3], t1);
+                    s[3] = s[2];
+                    s[2] = s[1];
+                    s[1] = s[0];
+                    s[0] = W::add(t1, t2);
+                }
+
+                for (int i = 0; i < 8; i++)
+                    h[i] = W::add(h[i], s[i]);
+            }
+
+            // Hashes count <= L messages in one register. Lanes past count, and
+            // lanes whose message has run out of blocks, compress zero blocks
+            // whose result is never read.
+            static void hash(unsigned char *out, const Fields *messages, size_t count)
+            {
+                size_t len[L] = {}, blocks[L] = {};
+                size_t max_blocks = 0;
+                for (size_t l = 0; l < count; l++)
+                {
+                    len[l] = message_len(messages[l]);
+                    blocks[l] = padded_blocks(len[l]);
+                    max_blocks = std::max(max_blocks, blocks[l]);
+                }
+
+                Word h[8];
+                for (int i = 0; i < 8; i++)
+                    h[i] = W::set1(LANE_IV[i]);
+
+                alignas(64) uint64_t w[16 * L];
+                alignas(64) uint64_t digest[8 * L];
+                unsigned char block[BLOCK_LEN];
+                for (size_t b = 0; b < max_blocks; b++)
+                {
+                    for (size_t l = 0; l < L; l++)
+                    {
+                        if (b < blocks[l])
+                            pad_block(block, messages[l], len[l], b);
+                        else
+                            std::fill(block, block + BLOCK_LEN, 0);
+                        for (int t = 0; t < 16; t++)
+                            w[t * L + l] = load_be64(block + 8 * t);
+                    }
+                    compress(h, w);
+
+                    bool finished = false;
+                    for (size_t l = 0; l < count; l++)
+                        finished |= blocks[l] == b + 1;
+                    if (!finished)
+                        continue;
+                    for (int i = 0; i < 8; i++)
+                        W::store(digest + i * L, h[i]);
+                    for (size_t l = 0; l < count; l++)
+                        if (blocks[l] == b + 1)
+                            for (int i = 0; i < 8; i++)
+                                store_be64(out + l * BYTES + 8 * i, digest[i * L + l]);
+                }
+
+                sodium_memzero(w, sizeof w);
+                sodium_memzero(digest, sizeof digest);
+                sodium_memzero(block, sizeof block);
+                sodium_memzero(h, sizeof h);
+            }
+
+            // Runs n messages in registers of L. A partial last register of at
+            // least W::MIN_TAIL messages is padded with idle lanes; a shorter one
+            // goes one at a time, which is cheaper.
+            static void hash_blocks(unsigned char *out, const Fields *messages, size_t n)
+            {
+                size_t i = 0;
+                for (; i + L <= n; i += L)
+                    hash(out + i * BYTES, messages + i, L);
+                if (n - i < W::MIN_TAIL)
+                {
+                    for (; i < n; i++)
+                        hash_one(out + i * BYTES, messages[i]);
+                    return;
+                }
+                hash(out + i * BYTES, messages + i, n - i);
+            }
+        };
+    }
+}
+
+#endif // SHA512_LANES_IMPL_HPP
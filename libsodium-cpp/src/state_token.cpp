@@ -0,0 +1,247 @@
+#include "state_token.hpp"
+#include <algorithm>
+#include <mutex>
+
+namespace protoss
+{
+    static void store_le16(unsigned char *out, uint16_t v)
+    {
+        out[0] = (unsigned char)v;
+        out[1] = (unsigned char)(v >> 8);
+    }
+
+    static uint16_t load_le16(const unsigned char *in)
+    {
+        return (uint16_t)(in[0] | (in[1] << 8));
+    }
+
+    static void store_le32(unsigned char *out, uint32_t v)
+    {
+        for (int i = 0; i < 4; i++)
+            out[i] = (unsigned char)(v >> (8 * i));
+    }
+
+    static uint32_t load_le32(const unsigned char *in)
+    {
+        uint32_t v = 0;
+        for (int i = 0; i < 4; i++)
+            v |= (uint32_t)in[i] << (8 * i);
+        return v;
+    }
+
+    static void store_le64(unsigned char *out, uint64_t v)
+    {
+        for (int i = 0; i < 8; i++)
+            out[i] = (unsigned char)(v >> (8 * i));
+    }
+
+    static uint64_t load_le64(const unsigned char *in)
+    {
+        uint64_t v = 0;
+        for (int i = 0; i < 8; i++)
+            v |= (uint64_t)in[i] << (8 * i);
+        return v;
+    }
+
+    static constexpr size_t NONCE_OFFSET = 13;
+    static constexpr size_t MAX_IDENTITY_LEN = 0xffff;
+    static constexpr size_t INLINE_IDENTITY_BYTES = 512; // Larger identities are opened in sodium_malloc memory
+
+    StateSealer::StateSealer(Clock::duration lifetime, Clock::duration rotation)
+        : epoch_(Clock::now()), lifetime_(lifetime), rotation_(rotation)
+    {
+        if (lifetime <= Clock::duration::zero())
+            throw std::invalid_argument("StateSealer lifetime must be positive");
+        if (rotation < lifetime)
+            throw std::invalid_argument("StateSealer rotation must be at least the token lifetime");
+        rotate_locked(epoch_);
+    }
+
+    StateSealer::~StateSealer()
+    {
+        sodium_memzero(current_.key.data(), current_.key.size());
+        sodium_memzero(previous_.key.data(), previous_.key.size());
+    }
+
+    size_t StateSealer::identity_bytes(Bytes token)
+    {
+        return token.size() < STATE_TOKEN_OVERHEAD ? 0 : token.size() - STATE_TOKEN_OVERHEAD;
+    }
+
+    uint64_t StateSealer::millis_of(Clock::time_point now) const
+    {
+        if (now <= epoch_)
+            return 0;
+        return (uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(now - epoch_).count();
+    }
+
+    void StateSealer::rotate_locked(Clock::time_point now)
+    {
+        previous_ = current_;
+        current_.id = next_id_++;
+        crypto_aead_xchacha20poly1305_ietf_keygen(current_.key.data());
+        current_.created = now;
+    }
+
+    void StateSealer::rotate(Clock::time_point now)
+    {
+        std::unique_lock lock(mutex_);
+        rotate_locked(now);
+    }
+
+    void StateSealer::seal(std::span<unsigned char> token, const State &state, Clock::time_point now)
+    {
+        if (state.P_i.size() > MAX_IDENTITY_LEN || state.P_j.size() > MAX_IDENTITY_LEN)
+            throw std::invalid_argument("identity too long for a state token");
+        const size_t identities = state.P_i.size() + state.P_j.size();
+        if (token.size() != token_bytes(identities))
+            throw std::invalid_argument("state token buffer has the wrong size");
+
+        // The plaintext is assembled in place and encrypted over itself
+        unsigned char *header = token.data();
+        unsigned char *plain = header + STATE_TOKEN_HEADER_LEN;
+        std::copy(state.x.begin(), state.x.end(), plain);
+        std::copy(state.I.begin(), state.I.end(), plain + SCALAR_LEN);
+        std::copy(state.V.begin(), state.V.end(), plain + SCALAR_LEN + POINT_LEN);
+        store_le16(plain + SCALAR_LEN + 2 * POINT_LEN, (uint16_t)state.P_i.size());
+        store_le16(plain + SCALAR_LEN + 2 * POINT_LEN + 2, (uint16_t)state.P_j.size());
+        std::copy(state.P_i.begin(), state.P_i.end(), plain + STATE_TOKEN_FIXED_LEN);
+        std::copy(state.P_j.begin(), state.P_j.end(), plain + STATE_TOKEN_FIXED_LEN + state.P_i.size());
+        const size_t plain_len = STATE_TOKEN_FIXED_LEN + identities;
+
+        header[0] = STATE_TOKEN_FORMAT;
+        store_le64(header + 5, millis_of(now + lifetime_));
+        randombytes_buf(header + NONCE_OFFSET, crypto_aead_xchacha20poly1305_ietf_NPUBBYTES);
+
+        std::shared_lock lock(mutex_);
+        if (now - current_.created >= rotation_)
+        {
+            lock.unlock();
+            {
+                std::unique_lock exclusive(mutex_);
+                if (now - current_.created >= rotation_)
+                    rotate_locked(now);
+            }
+            lock.lock();
+        }
+        store_le32(header + 1, current_.id);
+        crypto_aead_xchacha20poly1305_ietf_encrypt_detached(plain, plain + plain_len, nullptr, plain, plain_len,
+                                                           header, STATE_TOKEN_HEADER_LEN, nullptr,
+                                                           header + NONCE_OFFSET, current_.key.data());
+    }
+
+    std::vector<unsigned char> StateSealer::seal(const State &state, Clock::time_point now)
+    {
+        std::vector<unsigned char> token(token_bytes(state.P_i.size() + state.P_j.size()));
+        seal(token, state, now);
+        return token;
+    }
+
+    // Decrypts the token into plain, which holds STATE_TOKEN_FIXED_LEN +
+    // identity_bytes(token) bytes; false if it does not authenticate under key
+    static bool decrypt_token(unsigned char *plain, Bytes token, const unsigned char key[crypto_aead_xchacha20poly1305_ietf_KEYBYTES])
+    {
+        const size_t plain_len = token.size() - STATE_TOKEN_HEADER_LEN - crypto_aead_xchacha20poly1305_ietf_ABYTES;
+        const unsigned char *cipher = token.data() + STATE_TOKEN_HEADER_LEN;
+        return crypto_aead_xchacha20poly1305_ietf_decrypt_detached(plain, nullptr, cipher, plain_len, cipher + plain_len,
+                                                                  token.data(), STATE_TOKEN_HEADER_LEN,
+                                                                  token.data() + NONCE_OFFSET, key) == 0;
+    }
+
+    Status StateSealer::open(State &state, std::span<unsigned char> identities, Bytes token, Clock::time_point now) noexcept
+    {
+        if (token.size() < STATE_TOKEN_OVERHEAD || token[0] != STATE_TOKEN_FORMAT)
+            return Status::InvalidToken;
+        const size_t identity_len = identity_bytes(token);
+        if (identities.size() < identity_len || load_le64(token.data() + 5) < millis_of(now))
+            return Status::InvalidToken;
+
+        // Tokens with short identities decrypt on the stack; longer ones in
+        // guarded memory that sodium_free wipes
+        const size_t plain_len = STATE_TOKEN_FIXED_LEN + identity_len;
+        unsigned char inline_plain[STATE_TOKEN_FIXED_LEN + INLINE_IDENTITY_BYTES];
+        unsigned char *plain = inline_plain;
+        if (identity_len > INLINE_IDENTITY_BYTES && !(plain = (unsigned char *)sodium_malloc(plain_len)))
+            return Status::Failure;
+
+        bool authentic = false;
+        {
+            std::shared_lock lock(mutex_);
+            const uint32_t key_id = load_le32(token.data() + 1);
+            if (key_id != 0 && (key_id == current_.id || key_id == previous_.id))
+                authentic = decrypt_token(plain, token, (key_id == current_.id ? current_ : previous_).key.data());
+        }
+
+        const unsigned char *lengths = plain + SCALAR_LEN + 2 * POINT_LEN;
+        const size_t P_i_len = authentic ? load_le16(lengths) : 0, P_j_len = authentic ? load_le16(lengths + 2) : 0;
+        Status status = Status::InvalidToken;
+        if (authentic && P_i_len + P_j_len == identity_len)
+        {
+            std::copy(plain, plain + SCALAR_LEN, state.x.begin());
+            std::copy(plain + SCALAR_LEN, plain + SCALAR_LEN + POINT_LEN, state.I.begin());
+            std::copy(plain + SCALAR_LEN + POINT_LEN, plain + SCALAR_LEN + 2 * POINT_LEN, state.V.begin());
+            std::copy(plain + STATE_TOKEN_FIXED_LEN, plain + plain_len, identities.begin());
+            state.P_i = Bytes(identities.data(), P_i_len);
+            state.P_j = Bytes(identities.data() + P_i_len, P_j_len);
+            status = Status::Ok;
+        }
+
+        if (plain == inline_plain)
+            sodium_memzero(inline_plain, plain_len);
+        else
+            sodium_free(plain);
+        return status;
+    }
+
+    Status StateSealer::Der(SessionKey &K, Bytes token, const Point &R, Clock::time_point now) noexcept
+    {
+        const size_t identity_len = identity_bytes(token);
+        unsigned char inline_identities[INLINE_IDENTITY_BYTES];
+        unsigned char *identities = inline_identities;
+        if (identity_len > INLINE_IDENTITY_BYTES && !(identities = (unsigned char *)sodium_malloc(identity_len)))
+        {
+            sodium_memzero(K.data(), K.size());
+            return Status::Failure;
+        }
+
+        State state;
+        Status status = open(state, std::span<unsigned char>(identities, identity_len), token, now);
+        if (status == Status::Ok)
+            status = TryDer(K, state, R);
+        else
+            sodium_memzero(K.data(), K.size());
+
+        if (identities != inline_identities)
+            sodium_free(identities);
+        return status;
+    }
+
+    std::vector<unsigned char> StateSealer::seal(const ProtossState &state, Clock::time_point now)
+    {
+        if (state.x.size() != SCALAR_LEN || state.I.size() != POINT_LEN || state.V.size() != POINT_LEN)
+            throw std::invalid_argument("malformed ProtossState");
+        State fixed;
+        std::copy(state.x.begin(), state.x.end(), fixed.x.begin());
+        std::copy(state.I.begin(), state.I.end(), fixed.I.begin());
+        std::copy(state.V.begin(), state.V.end(), fixed.V.begin());
+        fixed.P_i = state.P_i;
+        fixed.P_j = state.P_j;
+        return seal(fixed, now);
+    }
+
+    ProtossState StateSealer::open(const std::vector<unsigned char> &token, Clock::time_point now)
+    {
+        std::vector<unsigned char> identities(identity_bytes(token));
+        State state;
+        if (open(state, identities, token, now) != Status::Ok)
+            throw std::runtime_error("invalid state token");
+        std::vector<unsigned char> x(state.x.begin(), state.x.end());
+        ProtossState result(x,
+                            std::vector<unsigned char>(state.I.begin(), state.I.end()),
+                            std::vector<unsigned char>(state.P_i.begin(), state.P_i.end()),
+                            std::vector<unsigned char>(state.P_j.begin(), state.P_j.end()),
+                            std::vector<unsigned char>(state.V.begin(), state.V.end()));
+        sodium_memzero(x.data(), x.size());
+        return result;
+    }
+}
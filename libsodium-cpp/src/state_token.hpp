@@ -0,0 +1,99 @@
+#ifndef STATE_TOKEN_HPP
+#define STATE_TOKEN_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <shared_mutex>
+#include <span>
+#include <vector>
+#include "protoss_protocol.hpp"
+
+namespace protoss
+{
+    constexpr uint8_t STATE_TOKEN_FORMAT = 1;
+    constexpr size_t STATE_TOKEN_HEADER_LEN = 37; // format, key ID, expiry, nonce
+    constexpr size_t STATE_TOKEN_FIXED_LEN = SCALAR_LEN + 2 * POINT_LEN + 4;
+    constexpr size_t STATE_TOKEN_OVERHEAD = STATE_TOKEN_HEADER_LEN + STATE_TOKEN_FIXED_LEN + crypto_aead_xchacha20poly1305_ietf_ABYTES;
+
+    // Stateless initiator mode: the state kept between Init and Der is sealed
+    // into an XChaCha20-Poly1305 token instead of being stored. The peer or the
+    // transport echoes the token back with R, and Der resumes from it, so a
+    // gateway holds no memory per pending handshake.
+    //
+    // Tokens expire `lifetime` after sealing and are bound to this sealer:
+    // its keys are random, held only in memory and rotated every `rotation`.
+    // A token opens under the current key or the one before it, so rotation
+    // must be at least the lifetime. Tokens are not single-use: a replayed
+    // token derives the same key from the same R, as the stored state would.
+    //
+    // Token layout (little-endian, token_bytes(|P_i| + |P_j|) bytes):
+    //   [0]       format
+    //   [1..4]    key ID
+    //   [5..12]   expiry, in milliseconds since the sealer was constructed
+    //   [13..36]  nonce
+    //   [37..]    encrypted x | I | V | |P_i| (2 bytes) | |P_j| (2 bytes) | P_i | P_j
+    //   last 16   Poly1305 tag
+    // The header is authenticated as associated data.
+    class StateSealer
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        StateSealer(Clock::duration lifetime, Clock::duration rotation);
+        ~StateSealer();
+        StateSealer(const StateSealer &) = delete;
+        StateSealer &operator=(const StateSealer &) = delete;
+
+        static constexpr size_t token_bytes(size_t identity_bytes) { return STATE_TOKEN_OVERHEAD + identity_bytes; }
+
+        // |P_i| + |P_j| of a token, from its length; 0 if it is too short
+        static size_t identity_bytes(Bytes token);
+
+        // Seals state into token, which must be token_bytes(|P_i| + |P_j|)
+        // bytes. Rotates the key first when it is due. Throws if an identity is
+        // longer than 65535 bytes.
+        void seal(std::span<unsigned char> token, const State &state, Clock::time_point now = Clock::now());
+        std::vector<unsigned char> seal(const State &state, Clock::time_point now = Clock::now());
+
+        // Opens token into state, whose P_i and P_j then view into identities,
+        // a buffer of at least identity_bytes(token) bytes. Returns
+        // InvalidToken if the token is malformed, forged, sealed under a
+        // retired key or expired; state is left untouched then.
+        Status open(State &state, std::span<unsigned char> identities, Bytes token,
+                    Clock::time_point now = Clock::now()) noexcept;
+
+        // TryDer from a token; K is zeroed on failure
+        Status Der(SessionKey &K, Bytes token, const Point &R, Clock::time_point now = Clock::now()) noexcept;
+
+        // Vector API counterparts; open throws std::runtime_error on an invalid token
+        std::vector<unsigned char> seal(const ProtossState &state, Clock::time_point now = Clock::now());
+        ProtossState open(const std::vector<unsigned char> &token, Clock::time_point now = Clock::now());
+
+        // Starts sealing under a fresh key; tokens of the previous key still
+        // open, older ones no longer do
+        void rotate(Clock::time_point now = Clock::now());
+
+    private:
+        using Key = std::array<unsigned char, crypto_aead_xchacha20poly1305_ietf_KEYBYTES>;
+
+        struct KeySlot
+        {
+            uint32_t id = 0; // 0 marks an unused slot
+            Key key{};
+            Clock::time_point created;
+        };
+
+        void rotate_locked(Clock::time_point now);
+        uint64_t millis_of(Clock::time_point now) const;
+
+        Clock::time_point epoch_;
+        Clock::duration lifetime_;
+        Clock::duration rotation_;
+        mutable std::shared_mutex mutex_;
+        KeySlot current_;
+        KeySlot previous_;
+        uint32_t next_id_ = 1;
+    };
+}
+
+#endif // STATE_TOKEN_HPP
@@ -0,0 +1,56 @@
+#include "transcript_hasher.hpp"
+#include "sha512_lanes.hpp"
+#include <algorithm>
+
+namespace protoss
+{
+    TranscriptHasher::TranscriptHasher()
+    {
+        crypto_hash_sha512_init(&state_);
+    }
+
+    TranscriptHasher::~TranscriptHasher()
+    {
+        sodium_memzero(&state_, sizeof state_);
+    }
+
+    TranscriptHasher &TranscriptHasher::absorb(Bytes field)
+    {
+        crypto_hash_sha512_update(&state_, field.data(), field.size());
+        return *this;
+    }
+
+    void TranscriptHasher::finalize(SessionKey &K)
+    {
+        unsigned char h[crypto_hash_sha512_BYTES];
+        crypto_hash_sha512_final(&state_, h);
+        std::copy(h, h + SESSION_KEY_LEN, K.begin());
+        sodium_memzero(h, sizeof h);
+    }
+
+    void derive_session_key(SessionKey &K,
+                            const Point &Z, const Point &I, const Point &R,
+                            Bytes P_i, Bytes P_j, const Point &V)
+    {
+        TranscriptHasher hasher;
+        hasher.absorb(Z).absorb(I).absorb(R).absorb(P_i).absorb(P_j).absorb(V);
+        hasher.finalize(K);
+    }
+
+    void derive_session_keys(SessionKey *K, const Transcript *transcripts, size_t n)
+    {
+        constexpr size_t CHUNK = 64;
+        sha512::Fields messages[CHUNK];
+        unsigned char digests[CHUNK * sha512::BYTES];
+        for (size_t i = 0; i < n; i += CHUNK)
+        {
+            const size_t count = std::min(CHUNK, n - i);
+            for (size_t j = 0; j < count; j++)
+                messages[j] = transcripts[i + j];
+            sha512::hash_lanes(digests, messages, count);
+            for (size_t j = 0; j < count; j++)
+                std::copy(&digests[j * sha512::BYTES], &digests[j * sha512::BYTES] + SESSION_KEY_LEN, K[i + j].begin());
+        }
+        sodium_memzero(digests, sizeof digests);
+    }
+}
@@ -0,0 +1,40 @@
+#ifndef TRANSCRIPT_HASHER_HPP
+#define TRANSCRIPT_HASHER_HPP
+
+#include "protoss_protocol.hpp"
+
+namespace protoss
+{
+    // Feeds transcript fields to SHA-512 one at a time, so no concatenated
+    // copy of the transcript is ever built. The state is wiped on destruction.
+    class TranscriptHasher
+    {
+    public:
+        TranscriptHasher();
+        ~TranscriptHasher();
+        TranscriptHasher(const TranscriptHasher &) = delete;
+        TranscriptHasher &operator=(const TranscriptHasher &) = delete;
+
+        TranscriptHasher &absorb(Bytes field);
+
+        // Writes the first SESSION_KEY_LEN bytes of the digest to K
+        void finalize(SessionKey &K);
+
+    private:
+        crypto_hash_sha512_state state_;
+    };
+
+    // Derive session key K = H'(Z, I, R, P_i, P_j, V)
+    void derive_session_key(SessionKey &K,
+                            const Point &Z, const Point &I, const Point &R,
+                            Bytes P_i, Bytes P_j, const Point &V);
+
+    // The fields Z, I, R, P_i, P_j, V of one transcript, in hashing order
+    using Transcript = std::array<Bytes, 6>;
+
+    // K[i] = H'(transcripts[i]) for i < n, several transcripts per SIMD
+    // register through sha512::hash_lanes
+    void derive_session_keys(SessionKey *K, const Transcript *transcripts, size_t n);
+}
+
+#endif // TRANSCRIPT_HASHER_HPP
@@ -0,0 +1,128 @@
+#include "verifier_cache.hpp"
+
+namespace protoss
+{
+    VerifierCache::VerifierCache(size_t capacity, Clock::duration ttl)
+        : capacity_(capacity), ttl_(ttl)
+    {
+        if (capacity_ == 0)
+            throw std::invalid_argument("VerifierCache capacity must be positive");
+        index_.reserve(capacity_);
+    }
+
+    VerifierCache::~VerifierCache()
+    {
+        clear();
+    }
+
+    void VerifierCache::get(Point &V, std::string_view credential_id, std::string_view password)
+    {
+        uint64_t generation;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (lookup_locked(V, credential_id, Clock::now()))
+                return;
+            generation = generation_;
+        }
+
+        // Hash outside the lock so concurrent misses on other credentials don't serialize
+        hash_to_point(V, password);
+
+        // An insert() or erase() while the lock was released may be a password
+        // rotation, so V may be stale: return it but don't cache it. Never
+        // replace an entry another miss cached in the meantime either.
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (generation == generation_ && index_.find(credential_id) == index_.end())
+            insert_locked(credential_id, V, Clock::now());
+    }
+
+    bool VerifierCache::lookup(Point &V, std::string_view credential_id)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return lookup_locked(V, credential_id, Clock::now());
+    }
+
+    void VerifierCache::insert(std::string_view credential_id, const Point &V)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        generation_++;
+        insert_locked(credential_id, V, Clock::now());
+    }
+
+    void VerifierCache::erase(std::string_view credential_id)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        generation_++;
+        auto found = index_.find(credential_id);
+        if (found != index_.end())
+            remove_locked(found->second);
+    }
+
+    void VerifierCache::clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        generation_++;
+        while (!entries_.empty())
+            remove_locked(entries_.begin());
+    }
+
+    size_t VerifierCache::size() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return entries_.size();
+    }
+
+    VerifierCache::Stats VerifierCache::stats() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stats_;
+    }
+
+    bool VerifierCache::lookup_locked(Point &V, std::string_view credential_id, Clock::time_point now)
+    {
+        auto found = index_.find(credential_id);
+        if (found == index_.end())
+        {
+            stats_.misses++;
+            return false;
+        }
+
+        auto it = found->second;
+        if (ttl_ != Clock::duration::zero() && now >= it->expires)
+        {
+            remove_locked(it);
+            stats_.expirations++;
+            stats_.misses++;
+            return false;
+        }
+
+        // Move to the front of the LRU order
+        entries_.splice(entries_.begin(), entries_, it);
+        V = it->V;
+        stats_.hits++;
+        return true;
+    }
+
+    void VerifierCache::insert_locked(std::string_view credential_id, const Point &V, Clock::time_point now)
+    {
+        auto found = index_.find(credential_id);
+        if (found != index_.end())
+            remove_locked(found->second);
+
+        while (entries_.size() >= capacity_)
+        {
+            remove_locked(std::prev(entries_.end()));
+            stats_.evictions++;
+        }
+
+        entries_.push_front(Entry{std::string(credential_id), V, now + ttl_});
+        index_.emplace(entries_.front().credential_id, entries_.begin());
+    }
+
+    void VerifierCache::remove_locked(EntryList::iterator it)
+    {
+        index_.erase(it->credential_id);
+        sodium_memzero(it->V.data(), it->V.size());
+        entries_.erase(it);
+    }
+}
@@ -0,0 +1,76 @@
+#ifndef VERIFIER_CACHE_HPP
+#define VERIFIER_CACHE_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include "protoss_protocol.hpp"
+
+namespace protoss
+{
+    // Bounded, thread-safe cache of password verifiers V = Hash(pwd), keyed by
+    // credential ID. Entries are evicted least-recently-used first once the
+    // capacity is reached, and expire after the TTL (zero disables expiry).
+    // Evicted entries are wiped. Callers must erase() a credential when its
+    // password changes.
+    class VerifierCache
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        struct Stats
+        {
+            uint64_t hits = 0;
+            uint64_t misses = 0;
+            uint64_t evictions = 0;
+            uint64_t expirations = 0;
+        };
+
+        explicit VerifierCache(size_t capacity, Clock::duration ttl = Clock::duration::zero());
+        ~VerifierCache();
+        VerifierCache(const VerifierCache &) = delete;
+        VerifierCache &operator=(const VerifierCache &) = delete;
+
+        // Writes V for the credential, computing hash_to_point(password) on a
+        // miss. The computed V is not cached if the cache was modified by
+        // insert(), erase() or clear() while it was being hashed.
+        void get(Point &V, std::string_view credential_id, std::string_view password);
+
+        // Writes V and returns true if the credential is cached and not expired
+        bool lookup(Point &V, std::string_view credential_id);
+
+        void insert(std::string_view credential_id, const Point &V);
+        void erase(std::string_view credential_id);
+        void clear();
+
+        size_t size() const;
+        Stats stats() const;
+
+    private:
+        struct Entry
+        {
+            std::string credential_id;
+            Point V;
+            Clock::time_point expires;
+        };
+        using EntryList = std::list<Entry>;
+
+        bool lookup_locked(Point &V, std::string_view credential_id, Clock::time_point now);
+        void insert_locked(std::string_view credential_id, const Point &V, Clock::time_point now);
+        void remove_locked(EntryList::iterator it);
+
+        mutable std::mutex mutex_;
+        size_t capacity_;
+        Clock::duration ttl_;
+        EntryList entries_; // Most recently used first
+        std::unordered_map<std::string_view, EntryList::iterator> index_; // Keys view into entries_
+        Stats stats_;
+        uint64_t generation_ = 0; // Bumped by insert, erase and clear; see get()
+    };
+}
+
+#endif // VERIFIER_CACHE_HPP
@@ -0,0 +1,203 @@
+#include "verifier_record.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace protoss
+{
+    static void store_le32(unsigned char *out, uint32_t v)
+    {
+        for (int i = 0; i < 4; i++)
+            out[i] = (unsigned char)(v >> (8 * i));
+    }
+
+    static uint32_t load_le32(const unsigned char *in)
+    {
+        uint32_t v = 0;
+        for (int i = 0; i < 4; i++)
+            v |= (uint32_t)in[i] << (8 * i);
+        return v;
+    }
+
+    static void store_le64(unsigned char *out, uint64_t v)
+    {
+        for (int i = 0; i < 8; i++)
+            out[i] = (unsigned char)(v >> (8 * i));
+    }
+
+    static uint64_t load_le64(const unsigned char *in)
+    {
+        uint64_t v = 0;
+        for (int i = 0; i < 8; i++)
+            v |= (uint64_t)in[i] << (8 * i);
+        return v;
+    }
+
+    static constexpr unsigned char FILE_MAGIC[4] = {'P', 'V', 'R', '1'};
+    static constexpr size_t FILE_HEADER_LEN = 16; // magic, format version, record count
+
+    void derive_verifier(Point &V, std::string_view password, const VerifierParams &params)
+    {
+        switch (params.kdf)
+        {
+        case VerifierKdf::Sha512:
+            hash_to_point(V, password);
+            return;
+        case VerifierKdf::Argon2id:
+        {
+            unsigned char hash[INPUT_LEN_RISTRETTO_HASH_TO_POINT];
+            if (crypto_pwhash(hash, sizeof hash, password.data(), password.size(), params.salt.data(),
+                              params.opslimit, (size_t)params.memlimit_kib * 1024, crypto_pwhash_ALG_ARGON2ID13) != 0)
+                throw std::runtime_error("crypto_pwhash failed");
+            int rc = crypto_core_ristretto255_from_hash(V.data(), hash);
+            sodium_memzero(hash, sizeof hash);
+            if (rc != 0)
+                throw std::runtime_error("crypto_core_ristretto255_from_hash failed");
+            return;
+        }
+        }
+        throw std::runtime_error("unknown verifier kdf");
+    }
+
+    VerifierRecord make_verifier_record(std::string_view credential_id, uint32_t version,
+                                        std::string_view password, const VerifierParams &params)
+    {
+        if (credential_id.size() > CREDENTIAL_ID_LEN)
+            throw std::runtime_error("credential ID too long");
+
+        VerifierRecord record;
+        record.version = version;
+        record.credential_id_len = (uint8_t)credential_id.size();
+        std::copy(credential_id.begin(), credential_id.end(), record.credential_id.begin());
+        record.params = params;
+        derive_verifier(record.V, password, params);
+        return record;
+    }
+
+    void serialize_verifier_record(unsigned char out[VERIFIER_RECORD_LEN], const VerifierRecord &record)
+    {
+        std::memset(out, 0, VERIFIER_RECORD_LEN);
+        out[0] = record.credential_id_len;
+        out[1] = (unsigned char)record.params.kdf;
+        store_le32(out + 4, record.version);
+        std::memcpy(out + 8, record.credential_id.data(), CREDENTIAL_ID_LEN);
+        std::memcpy(out + 40, record.params.salt.data(), VERIFIER_SALT_LEN);
+        store_le32(out + 56, record.params.opslimit);
+        store_le32(out + 60, record.params.memlimit_kib);
+        std::memcpy(out + 64, record.V.data(), POINT_LEN);
+    }
+
+    bool parse_verifier_record(VerifierRecord &record, const unsigned char in[VERIFIER_RECORD_LEN], bool validate)
+    {
+        if (in[0] > CREDENTIAL_ID_LEN || in[1] > (unsigned char)VerifierKdf::Argon2id || in[2] != 0 || in[3] != 0)
+            return false;
+        if (validate && !crypto_core_ristretto255_is_valid_point(in + 64))
+            return false;
+
+        record.credential_id_len = in[0];
+        record.params.kdf = (VerifierKdf)in[1];
+        record.version = load_le32(in + 4);
+        std::memcpy(record.credential_id.data(), in + 8, CREDENTIAL_ID_LEN);
+        std::memcpy(record.params.salt.data(), in + 40, VERIFIER_SALT_LEN);
+        record.params.opslimit = load_le32(in + 56);
+        record.params.memlimit_kib = load_le32(in + 60);
+        std::memcpy(record.V.data(), in + 64, POINT_LEN);
+        return true;
+    }
+
+    void write_verifier_file(const std::string &path, const std::vector<VerifierRecord> &records)
+    {
+        std::vector<unsigned char> buf(FILE_HEADER_LEN + records.size() * VERIFIER_RECORD_LEN);
+        std::memcpy(buf.data(), FILE_MAGIC, sizeof FILE_MAGIC);
+        store_le32(buf.data() + 4, VERIFIER_FILE_FORMAT);
+        store_le64(buf.data() + 8, records.size());
+        for (size_t i = 0; i < records.size(); i++)
+            serialize_verifier_record(buf.data() + FILE_HEADER_LEN + i * VERIFIER_RECORD_LEN, records[i]);
+
+        std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!file.is_open() || !file.write((const char *)buf.data(), buf.size()))
+            throw std::runtime_error("failed to write verifier file " + path);
+        sodium_memzero(buf.data(), buf.size());
+    }
+
+    VerifierStore::~VerifierStore()
+    {
+        // The whole capacity: load() leaves copies of erased records past size()
+        if (records_.capacity() != 0)
+            sodium_memzero(records_.data(), records_.capacity() * sizeof(VerifierRecord));
+    }
+
+    VerifierStore VerifierStore::load(const std::string &path, bool validate)
+    {
+        std::ifstream file(path, std::ios::in | std::ios::binary | std::ios::ate);
+        if (!file.is_open())
+            throw std::runtime_error("failed to open verifier file " + path);
+        std::streamoff size = file.tellg();
+        if (size < 0)
+            throw std::runtime_error("failed to read verifier file " + path);
+        std::vector<unsigned char> buf((size_t)size);
+        // buf holds every V in the file; wipe it on the error paths too
+        struct WipeOnExit
+        {
+            std::vector<unsigned char> &buf;
+            ~WipeOnExit() { sodium_memzero(buf.data(), buf.size()); }
+        } wipe_buf{buf};
+        file.seekg(0);
+        if (!file.read((char *)buf.data(), buf.size()))
+            throw std::runtime_error("failed to read verifier file " + path);
+
+        if (buf.size() < FILE_HEADER_LEN || std::memcmp(buf.data(), FILE_MAGIC, sizeof FILE_MAGIC) != 0)
+            throw std::runtime_error("not a verifier file: " + path);
+        if (load_le32(buf.data() + 4) != VERIFIER_FILE_FORMAT)
+            throw std::runtime_error("unsupported verifier file format: " + path);
+        uint64_t count = load_le64(buf.data() + 8);
+        if (count != (buf.size() - FILE_HEADER_LEN) / VERIFIER_RECORD_LEN ||
+            (buf.size() - FILE_HEADER_LEN) % VERIFIER_RECORD_LEN != 0)
+            throw std::runtime_error("truncated verifier file: " + path);
+
+        // Parsed into a store of its own, so its destructor wipes every
+        // record, superseded versions included, on all paths
+        VerifierStore parsed;
+        auto &records = parsed.records_;
+        records.resize(count);
+        for (size_t i = 0; i < count; i++)
+        {
+            if (!parse_verifier_record(records[i], buf.data() + FILE_HEADER_LEN + i * VERIFIER_RECORD_LEN, validate))
+                throw std::runtime_error("invalid verifier record " + std::to_string(i) + " in " + path);
+        }
+
+        // Sort indices by ID then version, rather than the records themselves,
+        // so no swap leaves a verifier copy behind on the stack. The newest
+        // version of each credential is the last index of its run.
+        std::vector<size_t> order(count);
+        for (size_t i = 0; i < count; i++)
+            order[i] = i;
+        std::sort(order.begin(), order.end(), [&records](size_t a, size_t b)
+                  { return records[a].id() != records[b].id() ? records[a].id() < records[b].id()
+                                                              : records[a].version < records[b].version; });
+        auto is_newest = [&](size_t k)
+        { return k + 1 == order.size() || records[order[k]].id() != records[order[k + 1]].id(); };
+
+        // Reserved exactly, so no reallocation leaves an unwiped buffer behind
+        VerifierStore store;
+        size_t newest = 0;
+        for (size_t k = 0; k < order.size(); k++)
+            newest += is_newest(k);
+        store.records_.reserve(newest);
+        for (size_t k = 0; k < order.size(); k++)
+        {
+            if (is_newest(k))
+                store.records_.push_back(records[order[k]]);
+        }
+        return store;
+    }
+
+    const VerifierRecord *VerifierStore::find(std::string_view credential_id) const
+    {
+        auto it = std::lower_bound(records_.begin(), records_.end(), credential_id, [](const VerifierRecord &record, std::string_view id)
+                                   { return record.id() < id; });
+        if (it == records_.end() || it->id() != credential_id)
+            return nullptr;
+        return &*it;
+    }
+}
@@ -0,0 +1,95 @@
+#ifndef VERIFIER_RECORD_HPP
+#define VERIFIER_RECORD_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "protoss_protocol.hpp"
+
+namespace protoss
+{
+    constexpr size_t CREDENTIAL_ID_LEN = 32;                      // Maximum credential ID length
+    constexpr size_t VERIFIER_SALT_LEN = crypto_pwhash_SALTBYTES; // Salt for the optional password stretch
+    constexpr size_t VERIFIER_RECORD_LEN = 96;                    // Serialized record size
+    constexpr uint32_t VERIFIER_FILE_FORMAT = 1;
+
+    // How V is derived from the password
+    enum class VerifierKdf : uint8_t
+    {
+        Sha512 = 0,  // V = from_hash(SHA-512(pwd)), same as hash_to_point
+        Argon2id = 1 // V = from_hash(Argon2id(pwd, salt)), a 64-byte crypto_pwhash output
+    };
+
+    struct VerifierParams
+    {
+        VerifierKdf kdf = VerifierKdf::Sha512;
+        std::array<unsigned char, VERIFIER_SALT_LEN> salt{};
+        uint32_t opslimit = 0;
+        uint32_t memlimit_kib = 0;
+    };
+
+    // Server-side verifier record: everything RspDer needs, without the password.
+    //
+    // Serialized layout (little-endian, VERIFIER_RECORD_LEN bytes):
+    //   [0]      credential_id_len
+    //   [1]      kdf
+    //   [2..3]   reserved, zero (records with other values are rejected)
+    //   [4..7]   version
+    //   [8..39]  credential_id, zero padded
+    //   [40..55] salt
+    //   [56..59] opslimit
+    //   [60..63] memlimit_kib
+    //   [64..95] V
+    struct VerifierRecord
+    {
+        uint32_t version = 0; // Bumped on password rotation; the highest version wins
+        uint8_t credential_id_len = 0;
+        std::array<unsigned char, CREDENTIAL_ID_LEN> credential_id{};
+        VerifierParams params;
+        Point V{};
+
+        std::string_view id() const { return {(const char *)credential_id.data(), credential_id_len}; }
+    };
+
+    // Derives V from the password. Initiators and the offline record generator must use the same params.
+    void derive_verifier(Point &V, std::string_view password, const VerifierParams &params);
+
+    VerifierRecord make_verifier_record(std::string_view credential_id, uint32_t version,
+                                        std::string_view password, const VerifierParams &params);
+
+    void serialize_verifier_record(unsigned char out[VERIFIER_RECORD_LEN], const VerifierRecord &record);
+
+    // Parses one record, returns false if it is malformed or V is not a valid point (when validate is set)
+    bool parse_verifier_record(VerifierRecord &record, const unsigned char in[VERIFIER_RECORD_LEN], bool validate);
+
+    // Writes a verifier file: "PVR1" magic, format version, record count, then the records
+    void write_verifier_file(const std::string &path, const std::vector<VerifierRecord> &records);
+
+    // In-memory verifier table for a responder, sorted by credential ID. Wiped on destruction.
+    class VerifierStore
+    {
+    public:
+        VerifierStore() = default;
+        VerifierStore(VerifierStore &&) = default;
+        // Swaps, so the replaced records are wiped when `other` is destroyed
+        VerifierStore &operator=(VerifierStore &&other) noexcept
+        {
+            records_.swap(other.records_);
+            return *this;
+        }
+        ~VerifierStore();
+
+        // Bulk-loads a verifier file with a single read. When the same credential ID
+        // appears more than once, the record with the highest version is kept.
+        static VerifierStore load(const std::string &path, bool validate = true);
+
+        const VerifierRecord *find(std::string_view credential_id) const;
+        size_t size() const { return records_.size(); }
+
+    private:
+        std::vector<VerifierRecord> records_;
+    };
+}
+
+#endif // VERIFIER_RECORD_HPP
@@ -1,6 +1,8 @@
 import time
 import datetime
+import mmap
 import os
+import struct
 import sys
 import math
 from typing import List, Tuple, Optional
@@ -12,11 +14,45 @@ from protoss_protocol import (
     SESSION_KEY_LEN
 )
 
-def run_benchmark(iterations: int, run_id: int = 1, is_warmup: bool = False) -> Optional[Tuple[float, float, float]]:
+class InputCorpus:
+    """Memory-mapped handshake inputs (password, P_i, P_j), in the corpus format of
+    cpace-protoss-comparison/libsodium-cpp/benchmark/input_corpus.hpp, so this
+    benchmark can run on the same inputs as the C++ and C ones. Little-endian
+    header: magic "PAKECRP1", uint32 password length, uint32 identity length,
+    uint64 record count; then the records, each password, P_i, P_j."""
+
+    HEADER = struct.Struct("<8sIIQ")
+    PASSWORD_LEN = 16
+    IDENTITY_LEN = 32
+
+    def __init__(self, path: str):
+        with open(path, "rb") as f:
+            self._map = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+        if len(self._map) < self.HEADER.size:
+            raise ValueError(f"corpus {path} is truncated")
+        magic, self.password_len, self.identity_len, self.count = self.HEADER.unpack_from(self._map, 0)
+        if (magic != b"PAKECRP1" or self.password_len != self.PASSWORD_LEN
+                or self.identity_len != self.IDENTITY_LEN):
+            raise ValueError(f"corpus {path} has an unsupported header")
+        self.record_len = self.password_len + 2 * self.identity_len
+        if self.count == 0 or self.count > (len(self._map) - self.HEADER.size) // self.record_len:
+            raise ValueError(f"corpus {path} is truncated")
+
+    def record(self, i: int) -> Tuple[str, bytes, bytes]:
+        """Record i, wrapping around when a run needs more handshakes than the corpus holds"""
+        offset = self.HEADER.size + (i % self.count) * self.record_len
+        identities = offset + self.password_len
+        return (self._map[offset:identities].decode("ascii"),
+                self._map[identities:identities + self.identity_len],
+                self._map[identities + self.identity_len:offset + self.record_len])
+
+
+def run_benchmark(iterations: int, run_id: int = 1, is_warmup: bool = False,
+                  corpus: Optional[InputCorpus] = None) -> Optional[Tuple[float, float, float]]:
     prefix = "Warmup" if is_warmup else f"Run {run_id}"
     print(f"{prefix}: Running Protoss protocol benchmark with {iterations} iterations...")
 
-    # Configure test params
+    # Configure test params; a corpus replaces them with one record per iteration
     password = "SharedPassword"
     P_i = b'\x00'
     P_j = b'\x01'
@@ -29,6 +65,9 @@ def run_benchmark(iterations: int, run_id: int = 1, is_warmup: bool = False) ->
     # Run the test multiple times
     for i in range(iterations):
         try:
+            if corpus is not None:
+                password, P_i, P_j = corpus.record(i)
+
             # Time Init step
             start = time.perf_counter()
             res_init = Init(password, P_i, P_j)
@@ -78,18 +117,29 @@ def main():
     iterations = 10000
     num_runs = 10
 
-    # Parse optional CLI arguments: [iterations] [num_runs]
-    if len(sys.argv) >= 2:
-        iterations = int(sys.argv[1])
-    if len(sys.argv) >= 3:
-        num_runs = int(sys.argv[2])
+    # Parse optional CLI arguments: [iterations] [num_runs] [--corpus FILE]
+    args = sys.argv[1:]
+    corpus = None
+    if "--corpus" in args:
+        at = args.index("--corpus")
+        if at + 1 >= len(args):
+            print("ERROR: --corpus needs a file")
+            return
+        corpus = InputCorpus(args[at + 1])
+        del args[at:at + 2]
+    if len(args) >= 1:
+        iterations = int(args[0])
+    if len(args) >= 2:
+        num_runs = int(args[1])
 
     print("Protoss Protocol Timing Benchmark")
     print("=================================")
 
     # First run a warmup to avoid cold-start effects
+    if corpus is not None:
+        print(f"Input corpus: {corpus.count} records")
     print("Performing warmup runs...")
-    run_benchmark(100, is_warmup=True)
+    run_benchmark(100, is_warmup=True, corpus=corpus)
 
     # Run the benchmark multiple times to average out external variability
     print(f"\nRunning main benchmark ({num_runs} runs x {iterations} iterations)...")
@@ -99,7 +149,7 @@ def main():
     run_total = []
 
     for r in range(1, num_runs + 1):
-        result = run_benchmark(iterations, run_id=r, is_warmup=False)
+        result = run_benchmark(iterations, run_id=r, is_warmup=False, corpus=corpus)
         if result is None:
             print(f"ERROR: Run {r} failed, aborting.")
             return
@@ -124,6 +174,8 @@ def main():
     results = []
     results.append(f"Benchmark Results with {iterations} iterations x {num_runs} runs")
     results.append(f"Hash Lengths: {INPUT_LEN_HASH_TO_POINT} bytes input for hash-to-point fn, {SESSION_KEY_LEN} bytes of session key")
+    if corpus is not None:
+        results.append(f"Input corpus: {corpus.count} records")
     results.append("-------------------------")
     results.append(f"Avg. Init phase:     {mean_init:.3f} +/- {std_init:.3f} ms")
     results.append(f"Avg. RspDer phase:   {mean_rspder:.3f} +/- {std_rspder:.3f} ms")